@@ -344,6 +344,44 @@ AS_02::Result_t AS_02::ACES::GetNextAttribute(const byte_t **buf, Attribute &att
   return RESULT_OK;
 }
 
+AS_02::Result_t AS_02::ACES::GetHeaderLength(const byte_t *buf, ui32_t buf_len, ui32_t &header_len)
+{
+
+  assert(buf != NULL);
+  const byte_t *p = buf;
+  const byte_t *end_p = buf + buf_len;
+
+  if(buf_len < 8) return RESULT_SMALLBUF;
+  Result_t result = CheckMagicNumber(&p);
+  if(ASDCP_SUCCESS(result)) result = CheckVersionField(&p);
+  if(ASDCP_FAILURE(result)) return result;
+
+  while(p < end_p)
+  {
+    if(*p == 0x00)
+    { // An empty attribute name ends the header.
+      header_len = (ui32_t)(p + 1 - buf);
+      return RESULT_OK;
+    }
+    // Skip the attribute name and the attribute type name.
+    for(int i = 0; i < 2 && p != NULL; i++)
+    {
+      p = (const byte_t*)memchr(p, 0x00, end_p - p);
+      if(p != NULL) p++;
+    }
+    if(p == NULL || end_p - p < 4) return RESULT_SMALLBUF;
+    i32_t size = KM_i32_LE(*(i32_t*)(p));
+    if(size < 0)
+    {
+      Kumu::DefaultLogSink().Error("Attribute size is negative\n");
+      return RESULT_FAIL;
+    }
+    if(end_p - p - 4 < size) return RESULT_SMALLBUF;
+    p += 4 + size;
+  }
+  return RESULT_SMALLBUF;
+}
+
 AS_02::Result_t AS_02::ACES::CheckMagicNumber(const byte_t **buf)
 {
 
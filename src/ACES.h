@@ -104,6 +104,10 @@ private:
 };
 
 Result_t GetNextAttribute(const byte_t **buf, Attribute &attr);
+// Sets header_len to the length of the header (magic number, version and
+// attributes, including the terminating null byte) at the start of buf.
+// Returns RESULT_SMALLBUF if buf ends before the header does.
+Result_t GetHeaderLength(const byte_t *buf, ui32_t buf_len, ui32_t &header_len);
 Result_t CheckMagicNumber(const byte_t **buf);
 Result_t CheckVersionField(const byte_t **buf);
 
@@ -106,6 +106,9 @@ AS_02::Result_t AS_02::ACES::ParseMetadataIntoDesc(const FrameBuffer &FB, Pictur
   return result;
 }
 
+// Enough for the attribute header of most files; longer headers are read again.
+static const ui32_t HeaderReadSize = 64 * Kumu::Kilobyte;
+
 class AS_02::ACES::CodestreamParser::h__CodestreamParser
 {
 
@@ -153,6 +156,47 @@ public:
     }
     return result;
   }
+
+  Result_t OpenReadHeader(const std::string& filename)
+  {
+    m_File.Close();
+    Result_t result = m_File.OpenRead(filename);
+    Kumu::fsize_t file_size = m_File.Size();
+    ui32_t read_size = HeaderReadSize;
+    ui32_t header_len = 0;
+    FrameBuffer HeaderBuf;
+
+    // read the first part of the file, and more only if the header is longer
+    while(ASDCP_SUCCESS(result))
+    {
+      ui32_t read_count = 0;
+      read_size = (ui32_t)Kumu::xmin((Kumu::fsize_t)read_size, file_size);
+      result = HeaderBuf.Capacity(read_size);
+
+      if(ASDCP_SUCCESS(result)) result = m_File.Seek(0);
+      if(ASDCP_SUCCESS(result)) result = m_File.Read(HeaderBuf.Data(), read_size, &read_count);
+      if(ASDCP_SUCCESS(result)) result = GetHeaderLength(HeaderBuf.RoData(), read_count, header_len);
+
+      if(result != RESULT_SMALLBUF) break;
+
+      if(read_count == file_size)
+      {
+        DefaultLogSink().Error("ACES header is incomplete: %s\n", filename.c_str());
+        result = ASDCP::RESULT_RAW_FORMAT;
+        break;
+      }
+
+      read_size *= 4;
+      result = RESULT_OK;
+    }
+
+    if(ASDCP_SUCCESS(result))
+    {
+      HeaderBuf.Size(header_len);
+      result = ParseMetadataIntoDesc(HeaderBuf, m_PDesc);
+    }
+    return result;
+  }
 };
 
 AS_02::ACES::CodestreamParser::CodestreamParser()
@@ -172,6 +216,13 @@ AS_02::Result_t AS_02::ACES::CodestreamParser::OpenReadFrame(const std::string &
   return m_Parser->OpenReadFrame(filename, FB);
 }
 
+AS_02::Result_t AS_02::ACES::CodestreamParser::OpenReadHeader(const std::string &filename) const
+{
+
+  const_cast<AS_02::ACES::CodestreamParser*>(this)->m_Parser = new h__CodestreamParser;
+  return m_Parser->OpenReadHeader(filename);
+}
+
 AS_02::Result_t AS_02::ACES::CodestreamParser::FillPictureDescriptor(PictureDescriptor &PDesc) const
 {
 
@@ -28,6 +28,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "AS_02_ACES.h"
+#include "ACES.h"
 #include <KM_fileio.h>
 #include <assert.h>
 #include <KM_log.h>
@@ -35,6 +36,8 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 using Kumu::DefaultLogSink;
 
 namespace {
+    const ui32_t NoFrame = 0xffffffff;
+
     class FileList : public std::list<std::string>
     {
       std::string m_DirName;
@@ -82,6 +85,28 @@ namespace {
         return result;
       }
     };
+
+    //
+    AS_02::Result_t ReadFileIntoFrameBuffer(const std::string& filename, AS_02::ACES::FrameBuffer& FB)
+    {
+      Kumu::FileReader Reader;
+      ui32_t read_count = 0;
+      AS_02::Result_t result = Reader.OpenRead(filename);
+
+      if(ASDCP_SUCCESS(result))
+      {
+        assert(Reader.Size() <= 0xFFFFFFFFL);
+        result = FB.Capacity((ui32_t)Reader.Size());
+      }
+
+      if(ASDCP_SUCCESS(result))
+        result = Reader.Read(FB.Data(), (ui32_t)Reader.Size(), &read_count);
+
+      if(ASDCP_SUCCESS(result))
+        FB.Size(read_count);
+
+      return result;
+    }
 }
 
 
@@ -93,8 +118,16 @@ class AS_02::ACES::SequenceParser::h__SequenceParser
   FileList::iterator m_CurrentFile;
   CodestreamParser   m_Parser;
   bool               m_Pedantic;
+  ui32_t             m_ReadAhead;      // frames to read ahead, 0 to read on demand
+  Kumu::FileReadAhead m_ReadAheadFiles;
+  ui32_t             m_HeldFrame;      // the frame whose read-ahead buffer is still referenced
+  FrameBuffer        m_ReadAheadView;  // refers to the held read-ahead buffer
+  FrameBuffer        m_ViewBuffer;     // holds the frame for ReadFrameView() without read-ahead
 
   Result_t OpenRead();
+  Result_t AcquireFrame(FrameBuffer*& FB);
+  Result_t CheckFrame(const FrameBuffer& FB);
+  void     ReleaseFrame();
 
   ASDCP_NO_COPY_CONSTRUCT(h__SequenceParser);
 
@@ -102,7 +135,7 @@ public:
   PictureDescriptor  m_PDesc;
   ResourceList_t   m_ResourceList_t;
 
-  h__SequenceParser() : m_FramesRead(0), m_Pedantic(false)
+  h__SequenceParser() : m_FramesRead(0), m_Pedantic(false), m_ReadAhead(0), m_HeldFrame(NoFrame)
   {
     memset(&m_PDesc, 0, sizeof(m_PDesc));
     m_PDesc.EditRate = ASDCP::Rational(24, 1);
@@ -119,16 +152,24 @@ public:
   // PNG or TIFF files which will be added as Ancillary Data.
   Result_t OpenTargetFrameSequenceRead(const std::list<std::string> &target_frame_file_list);
 
-  void     Close() {}
+  void     Close()
+  {
+    ReleaseFrame();
+    m_ReadAheadFiles.Stop();
+  }
 
   Result_t Reset()
   {
+    Close();
     m_FramesRead = 0;
     m_CurrentFile = m_FileList.begin();
     return RESULT_OK;
   }
 
+  Result_t SetReadAhead(ui32_t frame_count);
   Result_t ReadFrame(FrameBuffer&);
+  Result_t ReadFrameView(FrameBuffer&);
+  Result_t ReadFrameFilename(std::string&);
 };
 
 AS_02::Result_t AS_02::ACES::SequenceParser::h__SequenceParser::OpenRead()
@@ -139,7 +180,6 @@ AS_02::Result_t AS_02::ACES::SequenceParser::h__SequenceParser::OpenRead()
 
   m_CurrentFile = m_FileList.begin();
   CodestreamParser Parser;
-  FrameBuffer TmpBuffer;
 
   Kumu::fsize_t file_size = Kumu::FileSize((*m_CurrentFile).c_str());
 
@@ -147,9 +187,7 @@ AS_02::Result_t AS_02::ACES::SequenceParser::h__SequenceParser::OpenRead()
     return RESULT_NOT_FOUND;
 
   assert(file_size <= 0xFFFFFFFFL);
-  Result_t result = TmpBuffer.Capacity((ui32_t)file_size);
-  if(ASDCP_SUCCESS(result))
-    result = Parser.OpenReadFrame((*m_CurrentFile).c_str(), TmpBuffer);
+  Result_t result = Parser.OpenReadHeader((*m_CurrentFile).c_str());
 
   if(ASDCP_SUCCESS(result))
     result = Parser.FillPictureDescriptor(m_PDesc);
@@ -223,19 +261,188 @@ AS_02::Result_t AS_02::ACES::SequenceParser::h__SequenceParser::OpenTargetFrameS
 }
 
 
+AS_02::Result_t AS_02::ACES::SequenceParser::h__SequenceParser::SetReadAhead(ui32_t frame_count)
+{
+
+#ifdef KM_WIN32
+  return frame_count == 0 ? RESULT_OK : RESULT_NOTIMPL;
+#else
+  Close();
+  m_ReadAhead = frame_count;
+  return RESULT_OK;
+#endif
+}
+
+// Makes FB refer to the current frame's data, read ahead or read now.
+AS_02::Result_t AS_02::ACES::SequenceParser::h__SequenceParser::AcquireFrame(FrameBuffer*& FB)
+{
+
+  ReleaseFrame();
+
+#ifndef KM_WIN32
+  if(m_ReadAhead > 0)
+  {
+    if(!m_ReadAheadFiles.Running())
+    {
+      Result_t result = m_ReadAheadFiles.Start(m_FileList, m_FramesRead, m_ReadAhead);
+
+      if(ASDCP_FAILURE(result))
+        return result;
+    }
+
+    Kumu::ByteString* ReadBuf = 0;
+    m_HeldFrame = m_FramesRead;
+    Result_t result = m_ReadAheadFiles.Acquire(m_FramesRead, ReadBuf);
+
+    if(ASDCP_SUCCESS(result))
+    {
+      m_ReadAheadView.SetData(ReadBuf->Data(), ReadBuf->Length());
+      m_ReadAheadView.Size(ReadBuf->Length());
+      FB = &m_ReadAheadView;
+    }
+
+    return result;
+  }
+#endif
+
+  FB = &m_ViewBuffer;
+  return ReadFileIntoFrameBuffer(*m_CurrentFile, m_ViewBuffer);
+}
+
+//
+void AS_02::ACES::SequenceParser::h__SequenceParser::ReleaseFrame()
+{
+
+#ifndef KM_WIN32
+  if(m_HeldFrame != NoFrame)
+    m_ReadAheadFiles.Release(m_HeldFrame);
+#endif
+
+  m_HeldFrame = NoFrame;
+}
+
+// Parses the frame's header, as CodestreamParser::OpenReadFrame() does, and
+// compares it with the first frame's when pedantic.
+AS_02::Result_t AS_02::ACES::SequenceParser::h__SequenceParser::CheckFrame(const FrameBuffer& FB)
+{
+
+  PictureDescriptor PDesc = PictureDescriptor(); // zeroed; memset would clobber the vector members
+  PDesc.EditRate = ASDCP::Rational(24, 1);
+  PDesc.SampleRate = PDesc.EditRate;
+  Result_t result = ParseMetadataIntoDesc(FB, PDesc);
+
+  if(ASDCP_SUCCESS(result) && m_Pedantic && !(m_PDesc == PDesc))
+  {
+    Kumu::DefaultLogSink().Error("ACES codestream parameters do not match at frame %d\n", m_FramesRead + 1);
+    result = ASDCP::RESULT_RAW_FORMAT;
+  }
+
+  return result;
+}
+
 AS_02::Result_t AS_02::ACES::SequenceParser::h__SequenceParser::ReadFrame(FrameBuffer& FB)
 {
 
   if(m_CurrentFile == m_FileList.end())
     return RESULT_ENDOFFILE;
 
-  // open the file
-  Result_t result = m_Parser.OpenReadFrame((*m_CurrentFile).c_str(), FB);
+  Result_t result = RESULT_OK;
+
+  if(m_ReadAhead > 0)
+  {
+    FrameBuffer* ReadBuf = 0;
+    result = AcquireFrame(ReadBuf);
+
+    if(ASDCP_SUCCESS(result) && FB.Capacity() < ReadBuf->Size())
+    {
+      DefaultLogSink().Error("FrameBuf.Capacity: %u frame length: %u\n", FB.Capacity(), ReadBuf->Size());
+      result = RESULT_SMALLBUF;
+    }
+
+    if(ASDCP_SUCCESS(result))
+    {
+      memcpy(FB.Data(), ReadBuf->RoData(), ReadBuf->Size());
+      FB.Size(ReadBuf->Size());
+      FB.PlaintextOffset(0);
+      ReleaseFrame();
+      result = CheckFrame(FB);
+    }
+
+    if(ASDCP_FAILURE(result))
+      Close(); // the frame is read again if ReadFrame() is retried
+  }
+  else
+  {
+    // open the file
+    result = m_Parser.OpenReadFrame((*m_CurrentFile).c_str(), FB);
+
+    if(ASDCP_SUCCESS(result) && m_Pedantic)
+    {
+      PictureDescriptor PDesc;
+      result = m_Parser.FillPictureDescriptor(PDesc);
+
+      if(ASDCP_SUCCESS(result) && !(m_PDesc == PDesc))
+      {
+        Kumu::DefaultLogSink().Error("ACES codestream parameters do not match at frame %d\n", m_FramesRead + 1);
+        result = ASDCP::RESULT_RAW_FORMAT;
+      }
+    }
+  }
+
+  if(ASDCP_SUCCESS(result))
+  {
+    FB.FrameNumber(m_FramesRead++);
+    m_CurrentFile++;
+  }
+
+  return result;
+}
+
+AS_02::Result_t AS_02::ACES::SequenceParser::h__SequenceParser::ReadFrameView(FrameBuffer& FB)
+{
+
+  if(m_CurrentFile == m_FileList.end())
+    return RESULT_ENDOFFILE;
+
+  FrameBuffer* ReadBuf = 0;
+  Result_t result = AcquireFrame(ReadBuf);
 
-  if(ASDCP_SUCCESS(result) && m_Pedantic)
+  if(ASDCP_SUCCESS(result))
+    result = CheckFrame(*ReadBuf);
+
+  if(ASDCP_SUCCESS(result))
+  {
+    FB.SetData(ReadBuf->Data(), ReadBuf->Size());
+    FB.Size(ReadBuf->Size());
+    FB.PlaintextOffset(0);
+    FB.FrameNumber(m_FramesRead++);
+    m_CurrentFile++;
+  }
+  else
+  {
+    Close();
+  }
+
+  return result;
+}
+
+AS_02::Result_t AS_02::ACES::SequenceParser::h__SequenceParser::ReadFrameFilename(std::string& filename)
+{
+
+  if(m_CurrentFile == m_FileList.end())
+    return RESULT_ENDOFFILE;
+
+  ReleaseFrame();
+  m_ReadAheadFiles.Stop(); // the frames are no longer read in order
+  Result_t result = RESULT_OK;
+
+  if(m_Pedantic)
   {
     PictureDescriptor PDesc;
-    result = m_Parser.FillPictureDescriptor(PDesc);
+    result = m_Parser.OpenReadHeader((*m_CurrentFile).c_str());
+
+    if(ASDCP_SUCCESS(result))
+      result = m_Parser.FillPictureDescriptor(PDesc);
 
     if(ASDCP_SUCCESS(result) && !(m_PDesc == PDesc))
     {
@@ -246,7 +453,8 @@ AS_02::Result_t AS_02::ACES::SequenceParser::h__SequenceParser::ReadFrame(FrameB
 
   if(ASDCP_SUCCESS(result))
   {
-    FB.FrameNumber(m_FramesRead++);
+    filename = *m_CurrentFile;
+    m_FramesRead++;
     m_CurrentFile++;
   }
 
@@ -332,6 +540,33 @@ AS_02::Result_t AS_02::ACES::SequenceParser::ReadFrame(FrameBuffer &FB) const
   return m_Parser->ReadFrame(FB);
 }
 
+AS_02::Result_t AS_02::ACES::SequenceParser::SetReadAhead(ui32_t frame_count) const
+{
+
+  if(m_Parser.empty())
+    return RESULT_INIT;
+
+  return m_Parser->SetReadAhead(frame_count);
+}
+
+AS_02::Result_t AS_02::ACES::SequenceParser::ReadFrameView(FrameBuffer &FB) const
+{
+
+  if(m_Parser.empty())
+    return RESULT_INIT;
+
+  return m_Parser->ReadFrameView(FB);
+}
+
+AS_02::Result_t AS_02::ACES::SequenceParser::ReadFrameFilename(std::string &filename) const
+{
+
+  if(m_Parser.empty())
+    return RESULT_INIT;
+
+  return m_Parser->ReadFrameFilename(filename);
+}
+
 AS_02::Result_t AS_02::ACES::SequenceParser::ReadAncillaryResource(const std::string &filename, FrameBuffer &FB) const
 {
   if ( m_Parser.empty() )
@@ -178,6 +178,9 @@ namespace AS_02
 			 const ASDCP::Rational& edit_rate, const ui32_t& header_size = 16384,
 			 const IndexStrategy_t& strategy = IS_FOLLOW, const ui32_t& partition_space = 10);
 
+      // write body partitions on writer_count background threads (see h__AS02WriterFrame)
+      Result_t SetPartitionWriters(ui32_t writer_count);
+
       // Writes a frame of essence to the MXF file. If the optional AESEncContext
       // argument is present, the essence is encrypted prior to writing.
       // Fails if the file is not open, is finalized, or an operating system
@@ -209,6 +212,9 @@ namespace AS_02
       // operation cannot be completed.
       Result_t OpenRead(const std::string& filename) const;
 
+      // Open the file examined by the given probe (see EssenceProbe).
+      Result_t OpenRead(ASDCP::EssenceProbe& probe) const;
+
       // Returns RESULT_INIT if the file is not open.
       Result_t Close() const;
 
@@ -276,6 +282,11 @@ namespace AS_02
       // Fails if the file is not open, is finalized, or an operating system
       // error occurs.
       Result_t WriteFrame(const ASDCP::FrameBuffer&, ASDCP::AESEncContext* = 0, ASDCP::HMACContext* = 0);
+
+      // Sets the size of the buffer that collects the clip before it is written
+      // to the file (default 4 MB, at most 1024 MB). Zero writes each frame as it
+      // is given. Call after OpenWrite().
+      Result_t SetClipBufferSize(ui32_t megabytes);
       
       // Closes the MXF file, writing the index and revised header.
       Result_t Finalize();
@@ -302,6 +313,9 @@ namespace AS_02
       // operation cannot be completed.
       Result_t OpenRead(const std::string& filename, const ASDCP::Rational& EditRate) const;
 
+      // Open the file examined by the given probe (see EssenceProbe).
+      Result_t OpenRead(ASDCP::EssenceProbe& probe, const ASDCP::Rational& EditRate) const;
+
       // Returns RESULT_INIT if the file is not open.
       Result_t Close() const;
 
@@ -317,6 +331,32 @@ namespace AS_02
       // Returns RESULT_INIT if the file is not open, failure if the frame number is
       // out of range, or if optional decrypt or HAMC operations fail.
       Result_t ReadFrame(ui32_t frame_number, ASDCP::PCM::FrameBuffer&, ASDCP::AESDecContext* = 0, ASDCP::HMACContext* = 0) const;
+
+      // Opens the file as OpenRead() does, and also maps it into memory. The
+      // read methods then copy from the mapping, and ReadSamplesView() may be
+      // used to avoid the copy.
+      Result_t OpenReadMapped(const std::string& filename, const ASDCP::Rational& EditRate) const;
+
+      // Returns true if the file was opened with OpenReadMapped().
+      bool IsMapped() const;
+
+      // Reads frame_count frames beginning with start_frame using a single read.
+      // The span is clipped at the end of the clip and FrameBuffer::Size() gives
+      // the number of bytes read; unlike ReadFrame(), a short span is not padded.
+      // Returns RESULT_RANGE if start_frame is past the end of the clip, or
+      // RESULT_SMALLBUF if the buffer cannot hold the span.
+      Result_t ReadFrames(ui32_t start_frame, ui32_t frame_count, ASDCP::PCM::FrameBuffer&) const;
+
+      // Like ReadFrames(), but the span is given in samples of BlockAlign bytes,
+      // independent of the edit rate given to OpenRead().
+      Result_t ReadSamples(ui64_t sample_offset, ui32_t sample_count, ASDCP::PCM::FrameBuffer&) const;
+
+      // Like ReadSamples(), but uses FrameBuffer::SetData() to point the frame
+      // buffer at the samples in the mapping. The data must be treated as read-only
+      // and is valid until Close() or until the reader is destroyed. Call
+      // FB.SetData(0, 0) to return the buffer to internal allocation. Returns
+      // RESULT_STATE if the file was not opened with OpenReadMapped().
+      Result_t ReadSamplesView(ui64_t sample_offset, ui32_t sample_count, ASDCP::PCM::FrameBuffer&) const;
       
       // Print debugging information to stream
       void     DumpHeaderMetadata(FILE* = 0) const;
@@ -339,12 +379,31 @@ namespace AS_02
 	    
 	  ResourceMap m_ResourceMap;
 	  std::string m_Dirname;
+	  ui32_t      m_ProbeThreads;
 	  KM_NO_COPY_CONSTRUCT(Type5UUIDFilenameResolver);
 
+	  Result_t ReadCache(const std::string& cache_filename, const std::string& abs_dirname, ui64_t dir_stamp);
+	  Result_t WriteCache(const std::string& cache_filename, const std::string& abs_dirname, ui64_t dir_stamp) const;
+
 	public:
 	  Type5UUIDFilenameResolver();
 	  virtual ~Type5UUIDFilenameResolver();
+
+	  // Sets the number of threads used by OpenRead() to sniff the files in the
+	  // directory (default 8). Zero or one probes the files on the calling thread.
+	  void     SetProbeThreads(ui32_t thread_count);
+
+	  // Indexes the PNG and font files in the directory by their type-5 UUID.
 	  Result_t OpenRead(const std::string& dirname);
+
+	  // As above, but the index is read from cache_filename when that file was
+	  // written for the same directory and the directory's modification time
+	  // has not changed since (a file rewritten in place does not change it).
+	  // Otherwise the directory is probed and the cache
+	  // file is rewritten. The cache should live outside the directory, as
+	  // writing it there changes the directory's modification time. A cache
+	  // that cannot be written is not an error.
+	  Result_t OpenRead(const std::string& dirname, const std::string& cache_filename);
 	  Result_t ResolveRID(const byte_t* uuid, ASDCP::TimedText::FrameBuffer& FrameBuf) const;
 	};
       
@@ -432,6 +491,12 @@ namespace AS_02
 	  // WriteTimedTextResource()
 	  Result_t WriteAncillaryResource(const ASDCP::TimedText::FrameBuffer&, ASDCP::AESEncContext* = 0, ASDCP::HMACContext* = 0);
 
+	  // Writes the contents of the named file as the next Ancillary Resource. The
+	  // resource is copied in bounded pieces and is never held in memory in full,
+	  // unless the essence is encrypted, in which case the file is read and
+	  // passed to WriteAncillaryResource(). Fails under the same conditions.
+	  Result_t WriteAncillaryResourceFromFile(const std::string& filename, ASDCP::AESEncContext* = 0, ASDCP::HMACContext* = 0);
+
 	  // Closes the MXF file, writing the index and revised header.
 	  Result_t Finalize();
 	};
@@ -457,6 +522,9 @@ namespace AS_02
 	  // operation cannot be completed.
 	  Result_t OpenRead(const std::string& filename) const;
 
+	  // Open the file examined by the given probe (see EssenceProbe).
+	  Result_t OpenRead(ASDCP::EssenceProbe& probe) const;
+
 	  // Returns RESULT_INIT if the file is not open.
 	  Result_t Close() const;
 
@@ -491,6 +559,13 @@ namespace AS_02
 	  // out of range, or if optional decrypt or HAMC operations fail.
 	  Result_t ReadAncillaryResource(const Kumu::UUID&, ASDCP::TimedText::FrameBuffer&, ASDCP::AESDecContext* = 0, ASDCP::HMACContext* = 0) const;
 
+	  // Reads the timed-text resource having the given UUID and writes it to the
+	  // named file, which is created or truncated. Plaintext resources are copied
+	  // between the files without being read into memory; encrypted resources are
+	  // read with ReadAncillaryResource() and the optional contexts apply as there.
+	  Result_t ReadAncillaryResourceToFile(const Kumu::UUID&, const std::string& filename,
+					       ASDCP::AESDecContext* = 0, ASDCP::HMACContext* = 0) const;
+
 	  // Print debugging information to stream
 	  void     DumpHeaderMetadata(FILE* = 0) const;
 	  void     DumpIndex(FILE* = 0) const;
@@ -523,6 +598,9 @@ namespace AS_02
 			 const ASDCP::Rational& edit_rate, const ui32_t& header_size = 16384,
 			 const IndexStrategy_t& strategy = IS_FOLLOW, const ui32_t& partition_space = 10);
 
+      // write body partitions on writer_count background threads (see h__AS02WriterFrame)
+      Result_t SetPartitionWriters(ui32_t writer_count);
+
       // Writes a frame of essence to the MXF file. If the optional AESEncContext
       // argument is present, the essence is encrypted prior to writing.
       // Fails if the file is not open, is finalized, or an operating system
@@ -560,6 +638,9 @@ namespace AS_02
       // operation cannot be completed.
       Result_t OpenRead(const std::string& filename) const;
 
+      // Open the file examined by the given probe (see EssenceProbe).
+      Result_t OpenRead(ASDCP::EssenceProbe& probe) const;
+
       // Returns RESULT_INIT if the file is not open.
       Result_t Close() const;
 
@@ -301,6 +301,7 @@ public:
   Result_t    FillAncillaryResourceDescriptor(AS_02::ACES::ResourceList_t &ancillary_resources);
   Result_t    ReadFrame(ui32_t, AS_02::ACES::FrameBuffer&, AESDecContext*, HMACContext*);
   Result_t    ReadAncillaryResource(const Kumu::UUID&, AS_02::ACES::FrameBuffer& FrameBuf, AESDecContext* Ctx, HMACContext* HMAC);
+  Result_t    ReadAncillaryResourceToFile(const Kumu::UUID&, const std::string& filename, AESDecContext* Ctx, HMACContext* HMAC);
 };
 
 
@@ -422,6 +423,51 @@ AS_02::Result_t AS_02::ACES::MXFReader::h__Reader::ReadAncillaryResource(const K
   return result;
 }
 
+AS_02::Result_t AS_02::ACES::MXFReader::h__Reader::ReadAncillaryResourceToFile(const Kumu::UUID &uuid, const std::string &filename, AESDecContext* Ctx, HMACContext* HMAC)
+{
+
+  ResourceMap_t::const_iterator ri = m_ResourceMap.find(uuid);
+  if(ri == m_ResourceMap.end())
+  {
+    char buf[64];
+    DefaultLogSink().Error("No such resource: %s\n", uuid.EncodeHex(buf, 64));
+    return RESULT_RANGE;
+  }
+
+  // get the subdescriptor
+  InterchangeObject* tmp_iobj = 0;
+  Result_t result = m_HeaderPart.GetMDObjectByID((*ri).second, &tmp_iobj);
+
+  if(KM_SUCCESS(result) && !tmp_iobj->IsA(m_Dict->ul(MDD_TargetFrameSubDescriptor)))
+    result = RESULT_FORMAT;
+
+  Kumu::FileWriter Writer;
+
+  if(KM_SUCCESS(result))
+    result = Writer.OpenWrite(filename);
+
+  if(KM_SUCCESS(result))
+  {
+    ui32_t sid = static_cast<TargetFrameSubDescriptor*>(tmp_iobj)->TargetFrameEssenceStreamID;
+
+    if(m_Info.EncryptedEssence)
+    {
+      // the cipher works on the whole payload, so take the buffered path
+      AS_02::ACES::FrameBuffer FrameBuf;
+      result = ReadGenericStreamPartitionPayload(sid, FrameBuf, Ctx, HMAC);
+
+      if(KM_SUCCESS(result))
+        result = Writer.Write(FrameBuf.RoData(), FrameBuf.Size());
+    }
+    else
+    {
+      result = CopyGenericStreamPartitionPayload(sid, Writer);
+    }
+  }
+
+  return result;
+}
+
 AS_02::Result_t AS_02::ACES::MXFReader::h__Reader::FillAncillaryResourceDescriptor(AS_02::ACES::ResourceList_t &ancillary_resources)
 {
 
@@ -515,7 +561,10 @@ public:
                      const ui32_t &PartitionSpace_sec, const ui32_t &HeaderSize);
   Result_t SetSourceStream(const std::string &label, const ASDCP::Rational &edit_rate);
   Result_t WriteFrame(const AS_02::ACES::FrameBuffer &FrameBuf, ASDCP::AESEncContext *Ctx, ASDCP::HMACContext *HMAC);
+  Result_t WriteFrameFromFile(const std::string &filename, ASDCP::AESEncContext *Ctx, ASDCP::HMACContext *HMAC);
   Result_t WriteAncillaryResource(const AS_02::ACES::FrameBuffer&, AESEncContext* = 0, HMACContext* = 0);
+  Result_t WriteAncillaryResourceFromFile(const std::string &filename, AESEncContext* = 0, HMACContext* = 0);
+  Result_t WriteGenericStreamPartition();
   Result_t Finalize();
 };
 
@@ -643,27 +692,53 @@ AS_02::Result_t AS_02::ACES::MXFWriter::h__Writer::WriteFrame(const AS_02::ACES:
   return result;
 }
 
-// Closes the MXF file, writing the index and other closing information.
-AS_02::Result_t AS_02::ACES::MXFWriter::h__Writer::Finalize()
+AS_02::Result_t AS_02::ACES::MXFWriter::h__Writer::WriteFrameFromFile(const std::string &filename, ASDCP::AESEncContext *Ctx, ASDCP::HMACContext *HMAC)
 {
 
-  if(!m_State.Test_RUNNING())
+  Kumu::FileReader Reader;
+  Result_t result = Reader.OpenRead(filename);
+
+  if(KM_SUCCESS(result) && m_Info.EncryptedEssence)
   {
-    KM_RESULT_STATE_HERE();
-    return RESULT_STATE;
+    // the cipher works on the whole frame, so take the buffered path
+    AS_02::ACES::FrameBuffer FrameBuf;
+    ui32_t read_count = 0;
+    result = FrameBuf.Capacity(Reader.Size());
+
+    if(KM_SUCCESS(result))
+      result = Reader.Read(FrameBuf.Data(), FrameBuf.Capacity(), &read_count);
+
+    if(KM_SUCCESS(result))
+    {
+      FrameBuf.Size(read_count);
+      result = WriteFrame(FrameBuf, Ctx, HMAC);
+    }
+
+    return result;
   }
 
-  Result_t result = m_State.Goto_FINAL();
+  if(KM_SUCCESS(result) && Reader.Size() == 0)
+  {
+    DefaultLogSink().Error("The frame file is empty: %s\n", filename.c_str());
+    return RESULT_PARAM;
+  }
+
+  if(KM_SUCCESS(result) && m_State.Test_READY())
+  {
+    result = m_State.Goto_RUNNING(); // first time through
+  }
 
   if(KM_SUCCESS(result))
   {
-    result = WriteAS02Footer();
+    result = WriteKLVPacketFromFile(Reader, Reader.Size(), m_EssenceUL, MXF_BER_LENGTH);
+    m_FramesWritten++;
   }
 
   return result;
 }
 
-AS_02::Result_t AS_02::ACES::MXFWriter::h__Writer::WriteAncillaryResource(const AS_02::ACES::FrameBuffer &FrameBuf, AESEncContext *Ctx , HMACContext *HMAC )
+// Closes the MXF file, writing the index and other closing information.
+AS_02::Result_t AS_02::ACES::MXFWriter::h__Writer::Finalize()
 {
 
   if(!m_State.Test_RUNNING())
@@ -672,11 +747,24 @@ AS_02::Result_t AS_02::ACES::MXFWriter::h__Writer::WriteAncillaryResource(const
     return RESULT_STATE;
   }
 
+  Result_t result = m_State.Goto_FINAL();
+
+  if(KM_SUCCESS(result))
+  {
+    result = WriteAS02Footer();
+  }
+
+  return result;
+}
+
+// Writes the Generic Stream Partition pack that precedes each ancillary resource
+// and records the partition in the RIP.
+AS_02::Result_t AS_02::ACES::MXFWriter::h__Writer::WriteGenericStreamPartition()
+{
   Kumu::fpos_t here = m_File.TellPosition();
   assert(m_Dict);
 
   // create generic stream partition header
-  static UL GenericStream_DataElement(m_Dict->ul(MDD_GenericStream_DataElement));
   ASDCP::MXF::Partition GSPart(m_Dict);
 
   GSPart.MajorVersion = m_HeaderPart.MajorVersion;
@@ -690,7 +778,20 @@ AS_02::Result_t AS_02::ACES::MXFWriter::h__Writer::WriteAncillaryResource(const
   GSPart.EssenceContainers = m_HeaderPart.EssenceContainers;
   //GSPart.EssenceContainers.push_back(UL(m_Dict->ul(MDD_ACESFrameWrappedEssence))); //MDD_ACESEssence
   UL TmpUL(m_Dict->ul(MDD_GenericStreamPartition));
-  Result_t result = GSPart.WriteToFile(m_File, TmpUL);
+  return GSPart.WriteToFile(m_File, TmpUL);
+}
+
+AS_02::Result_t AS_02::ACES::MXFWriter::h__Writer::WriteAncillaryResource(const AS_02::ACES::FrameBuffer &FrameBuf, AESEncContext *Ctx , HMACContext *HMAC )
+{
+
+  if(!m_State.Test_RUNNING())
+  {
+    KM_RESULT_STATE_HERE();
+    return RESULT_STATE;
+  }
+
+  static UL GenericStream_DataElement(m_Dict->ul(MDD_GenericStream_DataElement));
+  Result_t result = WriteGenericStreamPartition();
 
   if(KM_SUCCESS(result))
   {
@@ -703,6 +804,49 @@ AS_02::Result_t AS_02::ACES::MXFWriter::h__Writer::WriteAncillaryResource(const
   return result;
 }
 
+AS_02::Result_t AS_02::ACES::MXFWriter::h__Writer::WriteAncillaryResourceFromFile(const std::string &filename, AESEncContext *Ctx, HMACContext *HMAC)
+{
+
+  if(!m_State.Test_RUNNING())
+  {
+    KM_RESULT_STATE_HERE();
+    return RESULT_STATE;
+  }
+
+  Kumu::FileReader Reader;
+  Result_t result = Reader.OpenRead(filename);
+
+  if(KM_SUCCESS(result) && m_Info.EncryptedEssence)
+  {
+    // the cipher works on the whole payload, so take the buffered path
+    AS_02::ACES::FrameBuffer FrameBuf;
+    ui32_t read_count = 0;
+    result = FrameBuf.Capacity(Reader.Size());
+
+    if(KM_SUCCESS(result))
+      result = Reader.Read(FrameBuf.Data(), FrameBuf.Capacity(), &read_count);
+
+    if(KM_SUCCESS(result))
+    {
+      FrameBuf.Size(read_count);
+      result = WriteAncillaryResource(FrameBuf, Ctx, HMAC);
+    }
+
+    return result;
+  }
+
+  static UL GenericStream_DataElement(m_Dict->ul(MDD_GenericStream_DataElement));
+
+  if(KM_SUCCESS(result))
+    result = WriteGenericStreamPartition();
+
+  if(KM_SUCCESS(result))
+    result = Write_KLV_PacketFromFile(m_File, m_StreamOffset, Reader, Reader.Size(),
+				      GenericStream_DataElement.Value(), MXF_BER_LENGTH);
+
+  return result;
+}
+
 AS_02::ACES::MXFWriter::MXFWriter()
 {
 
@@ -757,6 +901,13 @@ AS_02::Result_t AS_02::ACES::MXFWriter::OpenWrite(const std::string &filename, c
   return result;
 }
 
+AS_02::Result_t AS_02::ACES::MXFWriter::SetPartitionWriters(ui32_t writer_count)
+{
+
+  if(m_Writer.empty()) return RESULT_INIT;
+  return m_Writer->SetPartitionWriters(writer_count);
+}
+
 AS_02::Result_t AS_02::ACES::MXFWriter::WriteFrame(const FrameBuffer &FrameBuf, ASDCP::AESEncContext *Ctx /*= NULL*/, ASDCP::HMACContext *HMAC /*= NULL*/)
 {
 
@@ -772,6 +923,15 @@ AS_02::Result_t AS_02::ACES::MXFWriter::Finalize()
 }
 
 
+AS_02::Result_t AS_02::ACES::MXFWriter::WriteFrameFromFile(const std::string &filename, ASDCP::AESEncContext *Ctx, ASDCP::HMACContext *HMAC)
+{
+
+  if(m_Writer.empty())
+    return RESULT_INIT;
+
+  return m_Writer->WriteFrameFromFile(filename, Ctx, HMAC);
+}
+
 AS_02::Result_t AS_02::ACES::MXFWriter::WriteAncillaryResource(const AS_02::ACES::FrameBuffer &rBuf, ASDCP::AESEncContext *Ctx , ASDCP::HMACContext *HMAC )
 {
 
@@ -781,6 +941,15 @@ AS_02::Result_t AS_02::ACES::MXFWriter::WriteAncillaryResource(const AS_02::ACES
   return m_Writer->WriteAncillaryResource(rBuf, Ctx, HMAC);
 }
 
+AS_02::Result_t AS_02::ACES::MXFWriter::WriteAncillaryResourceFromFile(const std::string &filename, ASDCP::AESEncContext *Ctx, ASDCP::HMACContext *HMAC)
+{
+
+  if(m_Writer.empty())
+    return RESULT_INIT;
+
+  return m_Writer->WriteAncillaryResourceFromFile(filename, Ctx, HMAC);
+}
+
 
 AS_02::ACES::MXFReader::MXFReader(const Kumu::IFileReaderFactory& fileReaderFactory)
 {
@@ -837,6 +1006,13 @@ AS_02::Result_t AS_02::ACES::MXFReader::OpenRead(const std::string& filename) co
   return m_Reader->OpenRead(filename);
 }
 
+//
+AS_02::Result_t AS_02::ACES::MXFReader::OpenRead(ASDCP::EssenceProbe& probe) const
+{
+  m_Reader->AdoptFileReader(probe);
+  return OpenRead(probe.Filename());
+}
+
 AS_02::Result_t AS_02::ACES::MXFReader::Close() const
 {
 
@@ -877,6 +1053,15 @@ AS_02::Result_t AS_02::ACES::MXFReader::ReadAncillaryResource(const Kumu::UUID &
   return RESULT_INIT;
 }
 
+AS_02::Result_t AS_02::ACES::MXFReader::ReadAncillaryResourceToFile(const Kumu::UUID &uuid, const std::string &filename, ASDCP::AESDecContext *Ctx, ASDCP::HMACContext *HMAC) const
+{
+
+  if(m_Reader && m_Reader->m_File->IsOpen())
+    return m_Reader->ReadAncillaryResourceToFile(uuid, filename, Ctx, HMAC);
+
+  return RESULT_INIT;
+}
+
 AS_02::Result_t AS_02::ACES::MXFReader::FillAncillaryResourceList(AS_02::ACES::ResourceList_t &ancillary_resources) const
 {
 
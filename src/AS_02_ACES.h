@@ -332,6 +332,10 @@ public:
   // encrypted headers.
   Result_t OpenReadFrame(const std::string &filename, FrameBuffer &FB) const;
 
+  // Opens a file for reading and parses only its attribute header, leaving
+  // the image data unread. FillPictureDescriptor() may then be called.
+  Result_t OpenReadHeader(const std::string &filename) const;
+
   // Fill a PictureDescriptor struct with the values from the file's codestream.
   // Returns RESULT_INIT if the file is not open.
   Result_t FillPictureDescriptor(PictureDescriptor &PDesc) const;
@@ -386,6 +390,23 @@ public:
   // encrypted headers.
   Result_t ReadFrame(FrameBuffer &FB) const;
 
+  // Reads up to frame_count frames ahead of ReadFrame() and ReadFrameView() on
+  // background threads, one thread per frame, so that those calls do not wait
+  // on the filesystem. Zero (the default) disables read-ahead. Returns
+  // RESULT_NOTIMPL on platforms without thread support.
+  Result_t SetReadAhead(ui32_t frame_count) const;
+
+  // As ReadFrame(), but the frame buffer is set with SetData() to refer to memory
+  // held by the parser, so no copy is made and the buffer's capacity does not
+  // matter. The data remain valid until the next call to a Read or Reset method.
+  Result_t ReadFrameView(FrameBuffer &FB) const;
+
+  // Advances to the next sequential frame without reading its image data and
+  // returns the name of its file, for use with MXFWriter::WriteFrameFromFile().
+  // If the parser is pedantic, only the file's attribute header is read to
+  // check the metadata.
+  Result_t ReadFrameFilename(std::string &filename) const;
+
   Result_t ReadAncillaryResource(const std::string &filename, FrameBuffer &FB) const;
 };
 
@@ -417,12 +438,21 @@ public:
                                  const AS_02::IndexStrategy_t &strategy = AS_02::IS_FOLLOW,
                                  const ui32_t &partition_space = 10);
 
+  // write body partitions on writer_count background threads (see h__AS02WriterFrame)
+  Result_t SetPartitionWriters(ui32_t writer_count);
+
   // Writes a frame of essence to the MXF file. If the optional AESEncContext
   // argument is present, the essence is encrypted prior to writing.
   // Fails if the file is not open, is finalized, or an operating system
   // error occurs.
   Result_t WriteFrame(const FrameBuffer &FrameBuf, ASDCP::AESEncContext *Ctx = NULL, ASDCP::HMACContext *HMAC = NULL);
 
+  // Writes the contents of the named file as the next frame, as WriteFrame()
+  // would write the same bytes read by SequenceParser::ReadFrame(). The file is
+  // copied directly into the MXF file without passing through a frame buffer,
+  // unless the essence is encrypted.
+  Result_t WriteFrameFromFile(const std::string &filename, ASDCP::AESEncContext *Ctx = NULL, ASDCP::HMACContext *HMAC = NULL);
+
   // Writes an Ancillary Resource to the MXF file. If the optional AESEncContext
   // argument is present, the essence is encrypted prior to writing.
   // Fails if the file is not open, is finalized, or an operating system
@@ -430,6 +460,11 @@ public:
   // WriteFrame()
   Result_t WriteAncillaryResource(const AS_02::ACES::FrameBuffer &rBuf, ASDCP::AESEncContext* = 0, ASDCP::HMACContext* = 0);
 
+  // Writes the contents of the named file as the next Ancillary Resource,
+  // copying it in bounded pieces. Encrypted essence is read into memory and
+  // passed to WriteAncillaryResource(). Fails under the same conditions.
+  Result_t WriteAncillaryResourceFromFile(const std::string &filename, ASDCP::AESEncContext* = 0, ASDCP::HMACContext* = 0);
+
   // Closes the MXF file, writing the index and revised header.
   Result_t Finalize();
 };
@@ -455,6 +490,9 @@ public:
   // operation cannot be completed.
   Result_t OpenRead(const std::string &filename) const;
 
+  // Open the file examined by the given probe (see EssenceProbe).
+  Result_t OpenRead(ASDCP::EssenceProbe& probe) const;
+
   // Fill a ResourceList_t struct with the ancillary resources that are present in the file.
   // Returns RESULT_INIT if the file is not open.
   Result_t FillAncillaryResourceList(AS_02::ACES::ResourceList_t &ancillary_resources) const;
@@ -484,6 +522,12 @@ public:
   // out of range, or if optional decrypt or HAMC operations fail.
   Result_t ReadAncillaryResource(const Kumu::UUID&, AS_02::ACES::FrameBuffer&, ASDCP::AESDecContext* = 0, ASDCP::HMACContext* = 0) const;
 
+  // Reads the resource having the given UUID and writes it to the named file.
+  // Plaintext resources are copied without being read into memory; encrypted
+  // resources go through ReadAncillaryResource(). Returns RESULT_INIT if the
+  // file is not open.
+  Result_t ReadAncillaryResourceToFile(const Kumu::UUID&, const std::string &filename, ASDCP::AESDecContext* = 0, ASDCP::HMACContext* = 0) const;
+
   // Print debugging information to stream
          void     DumpHeaderMetadata(FILE* = 0) const;
          void     DumpIndex(FILE* = 0) const;
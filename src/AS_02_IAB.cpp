@@ -53,8 +53,11 @@ class AS_02::IAB::MXFWriter::h__Writer : public h__AS02Writer<AS_02::MXF::AS02In
   h__Writer();
 public:
     WriterState_t m_State;
+    ClipStagingBuffer m_ClipBuffer;
 
-  h__Writer(const Dictionary *d) : h__AS02Writer(d), m_State(ST_BEGIN) {}
+  h__Writer(const Dictionary *d) : h__AS02Writer(d), m_State(ST_BEGIN) {
+    m_ClipBuffer.Size(m_File, DefaultClipBufferSize * Kumu::Megabyte);
+  }
   virtual ~h__Writer(){}
 };
 
@@ -65,10 +68,15 @@ class AS_02::IAB::MXFReader::h__Reader : public h__AS02Reader
   h__Reader();
 public:
   ReaderState_t m_State;
+  Kumu::fpos_t m_NextPosition;     // file position following the last frame read, 0 if unknown
+  Kumu::fpos_t m_EssenceEnd;       // bounds the last frame of the clip
+  ASDCP::FrameBuffer m_ReadBuffer; // holds frames that do not fit a caller's buffer unparsed
 
   h__Reader(const Dictionary *d, const Kumu::IFileReaderFactory& fileReaderFactory) :
-    h__AS02Reader(d, fileReaderFactory), m_State(ST_READER_BEGIN) {}
+    h__AS02Reader(d, fileReaderFactory), m_State(ST_READER_BEGIN), m_NextPosition(0), m_EssenceEnd(0) {}
   virtual ~h__Reader(){}
+
+  Result_t ReadFrame(ui32_t frame_number, ASDCP::FrameBuffer& frame, bool reallocate_if_needed);
 };
 
 //------------------------------------------------------------------------------------------
@@ -262,7 +270,7 @@ AS_02::IAB::MXFWriter::WriteFrame(const ui8_t* frame, ui32_t sz) {
 
   /* write the frame */
 
-  result = this->m_Writer->m_File.Write(frame, sz);
+  result = this->m_Writer->m_ClipBuffer.Write(this->m_Writer->m_File, frame, sz);
 
   if (result.Failure()) {
     this->Reset();
@@ -288,6 +296,21 @@ Result_t AS_02::IAB::MXFWriter::WriteFrame(const ASDCP::FrameBuffer& frame) {
   return WriteFrame(frame.RoData(), frame.Size());
 }
 
+Result_t
+AS_02::IAB::MXFWriter::SetClipBufferSize(ui32_t megabytes) {
+
+  if (!this->m_Writer || this->m_Writer->m_State == ST_BEGIN) {
+    return Kumu::RESULT_INIT;
+  }
+
+  if (megabytes > MaxClipBufferSize) {
+    DefaultLogSink().Error("Clip buffer size %u MB exceeds the %u MB limit.\n", megabytes, MaxClipBufferSize);
+    return Kumu::RESULT_PARAM;
+  }
+
+  return this->m_Writer->m_ClipBuffer.Size(this->m_Writer->m_File, megabytes * Kumu::Megabyte);
+}
+
 Result_t
 AS_02::IAB::MXFWriter::AddDmsGenericPartUtf8Text(const ASDCP::FrameBuffer& FrameBuf, ASDCP::AESEncContext* Ctx,
                           ASDCP::HMACContext* HMAC, const std::string& trackDescription, const std::string& dataDescription)
@@ -295,6 +318,11 @@ AS_02::IAB::MXFWriter::AddDmsGenericPartUtf8Text(const ASDCP::FrameBuffer& Frame
   if ( m_Writer.empty() )
     return RESULT_INIT;
 
+  Result_t result = m_Writer->m_ClipBuffer.Flush(m_Writer->m_File);
+
+  if ( KM_FAILURE(result) )
+    return result;
+
   m_Writer->FlushIndexPartition();
   return m_Writer->AddDmsGenericPartUtf8Text(FrameBuf, Ctx, HMAC, trackDescription, dataDescription);
 }
@@ -317,7 +345,13 @@ AS_02::IAB::MXFWriter::Finalize() {
 
   try {
 
-    /* write clip length */
+    /* write any buffered frames, then the clip length */
+
+    result = this->m_Writer->m_ClipBuffer.Flush(this->m_Writer->m_File);
+
+    if (result.Failure()) {
+      throw Kumu::RuntimeError(result);
+    }
 
     ui64_t current_position = this->m_Writer->m_File.TellPosition();
 
@@ -416,9 +450,11 @@ AS_02::IAB::MXFReader::OpenRead(const std::string& filename) {
 
   Result_t result = Kumu::RESULT_OK;
 
-  /* initialize the writer */
+  /* initialize the reader, unless OpenRead(EssenceProbe&) has already done so */
 
-  this->m_Reader = new h__Reader(&DefaultCompositeDict(), m_FileReaderFactory);
+  if ( this->m_Reader.empty() ) {
+    this->m_Reader = new h__Reader(&DefaultCompositeDict(), m_FileReaderFactory);
+  }
 
   try {
 
@@ -459,8 +495,29 @@ AS_02::IAB::MXFReader::OpenRead(const std::string& filename) {
       throw Kumu::RuntimeError(Kumu::RESULT_FAIL);
     }
 
+    /* the last frame ends at the first partition following the essence, or at the end of the file */
+
+    IndexTableSegment::IndexEntry first_entry;
+    this->m_Reader->m_EssenceEnd = this->m_Reader->m_File->Size();
+
+    if (this->m_Reader->m_EssenceEnd < 0) {
+      throw Kumu::RuntimeError(Kumu::RESULT_READFAIL);
+    }
+
+    if (this->m_Reader->m_IndexAccess.Lookup(0, first_entry).Success()) {
+      RIP::const_pair_iterator pi;
+
+      for (pi = this->m_Reader->m_RIP.PairArray.begin(); pi != this->m_Reader->m_RIP.PairArray.end(); ++pi) {
+        if ((*pi).ByteOffset > first_entry.StreamOffset && (*pi).ByteOffset < (ui64_t)this->m_Reader->m_EssenceEnd) {
+          this->m_Reader->m_EssenceEnd = (Kumu::fpos_t)(*pi).ByteOffset;
+        }
+      }
+    }
+
     /* invalidate current frame */
 
+    this->m_Reader->m_NextPosition = 0;
+
     /* we are ready */
 
     this->m_Reader->m_State = ST_READER_READY;
@@ -475,6 +532,27 @@ AS_02::IAB::MXFReader::OpenRead(const std::string& filename) {
   return RESULT_OK;
 }
 
+Result_t
+AS_02::IAB::MXFReader::OpenRead(ASDCP::EssenceProbe& probe) {
+
+  /* are we already running */
+
+  if ( this->m_Reader && this->m_Reader->m_State != ST_READER_BEGIN ) {
+    KM_RESULT_STATE_HERE();
+    return Kumu::RESULT_STATE;
+  }
+
+  /* initialize the reader with the probe's open file */
+
+  if ( this->m_Reader.empty() ) {
+    this->m_Reader = new h__Reader(&DefaultCompositeDict(), m_FileReaderFactory);
+  }
+
+  this->m_Reader->AdoptFileReader(probe);
+
+  return this->OpenRead(probe.Filename());
+}
+
 
 Result_t
 AS_02::IAB::MXFReader::Close() {
@@ -517,127 +595,137 @@ namespace {
     }
     return true;
   }
+} // namespace
 
-  Result_t
-  ReadFrameImpl(ui32_t frame_number, ASDCP::FrameBuffer& frame, ReaderState_t& reader_state, AS_02::h__AS02Reader *reader, bool reallocate_if_needed) {
-    assert(reader);
-    /* are we already running */
-
-    if (reader_state == ST_READER_BEGIN) {
-      return Kumu::RESULT_INIT;
-    }
-
-    Result_t result = RESULT_OK;
+/* The index locates each IA Frame and the next index entry bounds it, so the
+ * preamble, the frame and their TLs are read with a single Read() and parsed
+ * in memory. Sequential reads skip the Seek(). */
+Result_t
+AS_02::IAB::MXFReader::h__Reader::ReadFrame(ui32_t frame_number, ASDCP::FrameBuffer& frame, bool reallocate_if_needed) {
 
-    // look up frame index node
-    IndexTableSegment::IndexEntry index_entry;
+  /* are we already running */
 
-    result = reader->m_IndexAccess.Lookup(frame_number, index_entry);
+  if (this->m_State == ST_READER_BEGIN) {
+    return Kumu::RESULT_INIT;
+  }
 
-    if (result.Failure()) {
-      DefaultLogSink().Error("Frame value out of range: %u\n", frame_number);
-      return result;
-    }
+  Result_t result = RESULT_OK;
+  char identbuf[IdentBufferLen];
 
-    result = reader->m_File->Seek(index_entry.StreamOffset);
+  // look up frame index node
+  IndexTableSegment::IndexEntry index_entry;
 
-    if (result.Failure()) {
-      DefaultLogSink().Error("Cannot seek to stream offset: %u\n", index_entry.StreamOffset);
-      return result;
-    }
+  result = this->m_IndexAccess.Lookup(frame_number, index_entry);
 
-    /* read the preamble info */
+  if (result.Failure()) {
+    DefaultLogSink().Error("Frame value out of range: %u\n", frame_number);
+    return result;
+  }
 
-    const int preambleTLLen = 5;
-    const int frameTLLen = 5;
+  /* the following frame, or the end of the essence, bounds this one */
 
-    ui32_t buffer_offset = 0;
+  IndexTableSegment::IndexEntry next_entry;
+  Kumu::fpos_t frame_end = this->m_EssenceEnd;
 
-    if (!checkFrameCapacity(frame, preambleTLLen, reallocate_if_needed)) {
-        return RESULT_SMALLBUF;
-    }
+  if (frame_number + 1 < this->m_IndexAccess.GetDuration()
+      && this->m_IndexAccess.Lookup(frame_number + 1, next_entry).Success()) {
+    frame_end = next_entry.StreamOffset;
+  }
 
-    result = reader->m_File->Read(&frame.Data()[buffer_offset], preambleTLLen);
+  const int preambleTLLen = 5;
+  const int frameTLLen = 5;
 
-    if (result.Failure()) {
-      DefaultLogSink().Error("Error reading IA Frame preamble\n", index_entry.StreamOffset);
-      return result;
-    }
+  if (frame_end < (Kumu::fpos_t)index_entry.StreamOffset + preambleTLLen + frameTLLen
+      || frame_end - index_entry.StreamOffset > 0xffffffffLL) {
+    DefaultLogSink().Error("Invalid IA Frame extent at stream offset: %s\n", ui64sz(index_entry.StreamOffset, identbuf));
+    return RESULT_FORMAT;
+  }
 
-    ui32_t preambleLen = ((ui32_t)frame.Data()[1 + buffer_offset] << 24) +
-      ((ui32_t)frame.Data()[2 + buffer_offset] << 16) +
-      ((ui32_t)frame.Data()[3 + buffer_offset] << 8) +
-      (ui32_t)frame.Data()[4 + buffer_offset];
+  ui32_t read_size = (ui32_t)(frame_end - index_entry.StreamOffset);
 
-    buffer_offset += preambleTLLen;
+  /* read straight into the frame when it can hold the whole extent */
 
-    /* read the preamble*/
+  ASDCP::FrameBuffer* read_buffer = &frame;
 
-    if (preambleLen > 0) {
+  if (!checkFrameCapacity(frame, read_size, reallocate_if_needed)) {
+    read_buffer = &this->m_ReadBuffer;
 
-      if (!checkFrameCapacity(frame, preambleTLLen + preambleLen, reallocate_if_needed)) {
-        return RESULT_SMALLBUF;
-      }
+    if (!checkFrameCapacity(this->m_ReadBuffer, read_size, true)) {
+      return RESULT_ALLOC;
+    }
+  }
 
-      result = reader->m_File->Read(&frame.Data()[buffer_offset], preambleLen);
+  if ((Kumu::fpos_t)index_entry.StreamOffset != this->m_NextPosition) {
+    result = this->m_File->Seek(index_entry.StreamOffset);
 
-      if (result.Failure()) {
-        DefaultLogSink().Error("Error reading IA Frame preamble\n", index_entry.StreamOffset);
-        return result;
-      }
+    if (result.Failure()) {
+      DefaultLogSink().Error("Cannot seek to stream offset: %s\n", ui64sz(index_entry.StreamOffset, identbuf));
+      this->m_NextPosition = 0;
+      return result;
+    }
+  }
 
-      buffer_offset += preambleLen;
+  ui32_t read_count = 0;
+  result = this->m_File->Read(read_buffer->Data(), read_size, &read_count);
 
-    }
+  if (result.Success() && read_count != read_size) {
+    result = RESULT_READFAIL;
+  }
 
-    /* read the IA Frame info */
+  if (result.Failure()) {
+    DefaultLogSink().Error("Error reading IA Frame at stream offset: %s\n", ui64sz(index_entry.StreamOffset, identbuf));
+    this->m_NextPosition = 0;
+    return result;
+  }
 
-    if (!checkFrameCapacity(frame,  preambleTLLen + preambleLen + frameTLLen, reallocate_if_needed)) {
-      return RESULT_SMALLBUF;
-    }
+  this->m_NextPosition = frame_end;
 
-    result = reader->m_File->Read(&frame.Data()[buffer_offset], frameTLLen);
+  /* parse the preamble and IA Frame TLs */
 
-    if (result.Failure()) {
-      DefaultLogSink().Error("Error reading IA Frame data\n", index_entry.StreamOffset);
-      return result;
-    }
+  const byte_t* p = read_buffer->RoData();
 
-    ui32_t frameLen = ((ui32_t)frame.Data()[buffer_offset + 1] << 24) +
-      ((ui32_t)frame.Data()[buffer_offset + 2] << 16) +
-      ((ui32_t)frame.Data()[buffer_offset + 3] << 8) +
-      (ui32_t)frame.Data()[buffer_offset + 4];
+  ui64_t preambleLen = ((ui32_t)p[1] << 24) +
+    ((ui32_t)p[2] << 16) +
+    ((ui32_t)p[3] << 8) +
+    (ui32_t)p[4];
 
-    buffer_offset += frameTLLen;
+  if (preambleTLLen + preambleLen + frameTLLen > read_size) {
+    DefaultLogSink().Error("IA Frame preamble exceeds the frame at stream offset: %s\n", ui64sz(index_entry.StreamOffset, identbuf));
+    return RESULT_FORMAT;
+  }
 
-    /* read the IA Frame */
+  p += preambleTLLen + preambleLen;
 
-    if (frameLen > 0) {
+  ui64_t frameLen = ((ui32_t)p[1] << 24) +
+    ((ui32_t)p[2] << 16) +
+    ((ui32_t)p[3] << 8) +
+    (ui32_t)p[4];
 
-      if (!checkFrameCapacity(frame, preambleTLLen + preambleLen + frameTLLen + frameLen, reallocate_if_needed)) {
-        return RESULT_SMALLBUF;
-      }
-      frame.Size(preambleTLLen + preambleLen + frameTLLen + frameLen);
+  ui64_t frame_size = preambleTLLen + preambleLen + frameTLLen + frameLen;
 
-      result = reader->m_File->Read(&frame.Data()[buffer_offset], frameLen);
+  if (frame_size > read_size) {
+    DefaultLogSink().Error("IA Frame data exceeds the frame at stream offset: %s\n", ui64sz(index_entry.StreamOffset, identbuf));
+    return RESULT_FORMAT;
+  }
 
-      if (result.Failure()) {
-        DefaultLogSink().Error("Error reading IA Frame data\n", index_entry.StreamOffset);
-        return result;
-      }
+  if (read_buffer != &frame) {
+    if (!checkFrameCapacity(frame, frame_size, reallocate_if_needed)) {
+      return RESULT_SMALLBUF;
     }
 
-    reader_state = ST_READER_RUNNING;
-
-    return result;
+    memcpy(frame.Data(), read_buffer->RoData(), frame_size);
   }
-} // namespace
+
+  frame.Size((ui32_t)frame_size);
+  this->m_State = ST_READER_RUNNING;
+
+  return result;
+}
 
 Result_t AS_02::IAB::MXFReader::ReadFrame(ui32_t frame_number,
                                           AS_02::IAB::MXFReader::Frame &frame) {
   assert(!this->m_Reader.empty());
-  Result_t result = ReadFrameImpl(frame_number, this->m_FrameBuffer,
-                                  this->m_Reader->m_State, this->m_Reader, true);
+  Result_t result = this->m_Reader->ReadFrame(frame_number, this->m_FrameBuffer, true);
 
   frame = std::pair<size_t, const ui8_t *>(this->m_FrameBuffer.Size(),
                                            this->m_FrameBuffer.Data());
@@ -646,8 +734,8 @@ Result_t AS_02::IAB::MXFReader::ReadFrame(ui32_t frame_number,
 
 Result_t AS_02::IAB::MXFReader::ReadFrame(ui32_t frame_number,
                                           ASDCP::FrameBuffer &frame) {
-  return ReadFrameImpl(frame_number, frame, this->m_Reader->m_State, this->m_Reader,
-                       false);
+  assert(!this->m_Reader.empty());
+  return this->m_Reader->ReadFrame(frame_number, frame, false);
 }
 
 Result_t
@@ -655,6 +743,7 @@ AS_02::IAB::MXFReader::ReadGenericStreamPartitionPayload(const ui32_t SID, ASDCP
 {
   if ( m_Reader && m_Reader->m_File->IsOpen() )
     {
+      m_Reader->m_NextPosition = 0; // the next frame read must seek
       return m_Reader->ReadGenericStreamPartitionPayload(SID, frame_buf, 0, 0 /*no encryption*/);
     }
 
@@ -133,6 +133,17 @@ namespace AS_02 {
        */
       Result_t WriteFrame(const ASDCP::FrameBuffer& frame);
 
+      /**
+       * Sets the size of the buffer that collects IA Frames before they are written
+       * to the file. The default is 4 MB; zero writes each frame as it is given.
+       *
+       * Must be preceded by a succesful OpenWrite() call
+       *
+       * @param megabytes Size of the buffer in megabytes
+       * @return RESULT_INIT if the file is not open, RESULT_PARAM if megabytes exceeds 1024
+       */
+      Result_t SetClipBufferSize(ui32_t megabytes);
+
       /**
        * Writes an XML text document to the MXF file as per RP 2057. If the
        * optional AESEncContext argument is present, the document is encrypted
@@ -219,6 +230,17 @@ namespace AS_02 {
        */
       Result_t OpenRead(const std::string& filename);
 
+      /**
+       * Creates and prepares an IAB Track File for reading, reusing the
+       * open file and the header and RIP bytes read by the given probe.
+       *
+       * @param probe A probe that has examined the Track File
+       *
+       * @return RESULT_OK indicates that frames are ready to be read,
+       * otherwise the reader is reset
+       */
+      Result_t OpenRead(ASDCP::EssenceProbe& probe);
+
       /**
        * Closes the IAB Track File.
        *
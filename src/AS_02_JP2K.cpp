@@ -185,6 +185,14 @@ AS_02::JP2K::MXFReader::OpenRead(const std::string& filename) const
   return m_Reader->OpenRead(filename);
 }
 
+//
+Result_t
+AS_02::JP2K::MXFReader::OpenRead(ASDCP::EssenceProbe& probe) const
+{
+  m_Reader->AdoptFileReader(probe);
+  return OpenRead(probe.Filename());
+}
+
 //
 Result_t
 AS_02::JP2K::MXFReader::Close() const
@@ -500,6 +508,16 @@ AS_02::JP2K::MXFWriter::OpenWrite(const std::string& filename, const ASDCP::Writ
   return result;
 }
 
+//
+Result_t
+AS_02::JP2K::MXFWriter::SetPartitionWriters(ui32_t writer_count)
+{
+  if ( m_Writer.empty() )
+    return RESULT_INIT;
+
+  return m_Writer->SetPartitionWriters(writer_count);
+}
+
 // Writes a frame of essence to the MXF file. If the optional AESEncContext
 // argument is present, the essence is encrypted prior to writing.
 // Fails if the file is not open, is finalized, or an operating system
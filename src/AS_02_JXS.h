@@ -82,6 +82,9 @@ namespace AS_02
 			  const ASDCP::Rational& edit_rate, const ui32_t& header_size = 16384,
 			  const IndexStrategy_t& strategy = IS_FOLLOW, const ui32_t& partition_space = 10);
 
+		  // write body partitions on writer_count background threads (see h__AS02WriterFrame)
+		  Result_t SetPartitionWriters(ui32_t writer_count);
+
 		  // Writes a frame of essence to the MXF file. If the optional AESEncContext
 		  // argument is present, the essence is encrypted prior to writing.
 		  // Fails if the file is not open, is finalized, or an operating system
@@ -113,6 +116,9 @@ namespace AS_02
 		  // operation cannot be completed.
 		  Result_t OpenRead(const std::string& filename) const;
 
+		  // Open the file examined by the given probe (see EssenceProbe).
+		  Result_t OpenRead(ASDCP::EssenceProbe& probe) const;
+
 		  // Returns RESULT_INIT if the file is not open.
 		  Result_t Close() const;
 
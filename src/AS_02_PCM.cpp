@@ -50,25 +50,32 @@ static std::string SOUND_DEF_LABEL = "Sound Track";
 class AS_02::PCM::MXFReader::h__Reader : public AS_02::h__AS02Reader
 {
   ui64_t m_ClipEssenceBegin, m_ClipSize;
-  ui32_t m_ClipDurationFrames, m_BytesPerFrame;
+  ui32_t m_ClipDurationFrames, m_BytesPerFrame, m_BlockAlign;
+  Kumu::fpos_t m_NextPosition; // file position following the last read, 0 if unknown
 
   ASDCP_NO_COPY_CONSTRUCT(h__Reader);
   h__Reader();
 
 public:
+  Kumu::FileMap m_FileMap;
+  bool          m_Mapped;
+
   h__Reader(const Dictionary* d, const Kumu::IFileReaderFactory& fileReaderFactory) : AS_02::h__AS02Reader(d, fileReaderFactory), m_ClipEssenceBegin(0), m_ClipSize(0),
-				   m_ClipDurationFrames(0) {}
+				   m_ClipDurationFrames(0), m_BytesPerFrame(0), m_BlockAlign(0), m_NextPosition(0), m_Mapped(false) {}
   virtual ~h__Reader() {}
 
-  ASDCP::Result_t    OpenRead(const std::string&, const ASDCP::Rational& edit_rate);
+  ASDCP::Result_t    OpenRead(const std::string&, const ASDCP::Rational& edit_rate, bool mapped);
   ASDCP::Result_t    ReadFrame(ui32_t, ASDCP::PCM::FrameBuffer&, ASDCP::AESDecContext*, ASDCP::HMACContext*);
+  ASDCP::Result_t    ReadFrames(ui32_t, ui32_t, ASDCP::PCM::FrameBuffer&);
+  ASDCP::Result_t    ReadSamples(ui64_t, ui32_t, ASDCP::PCM::FrameBuffer&, bool view);
+  ASDCP::Result_t    ReadSpan(ui64_t offset, ui64_t length, ASDCP::PCM::FrameBuffer&, bool view);
 };
 
 // TODO: This will ignore any body partitions past the first
 //
 //
 ASDCP::Result_t
-AS_02::PCM::MXFReader::h__Reader::OpenRead(const std::string& filename, const ASDCP::Rational& edit_rate)
+AS_02::PCM::MXFReader::h__Reader::OpenRead(const std::string& filename, const ASDCP::Rational& edit_rate, bool mapped)
 {
   ASDCP::MXF::WaveAudioDescriptor* wave_descriptor = 0;
   IndexTableSegment::IndexEntry tmp_entry;
@@ -134,7 +141,9 @@ AS_02::PCM::MXFReader::h__Reader::OpenRead(const std::string& filename, const AS
 	    }
 
 	  m_ClipEssenceBegin = m_File->TellPosition();
+	  m_NextPosition = m_ClipEssenceBegin;
 	  m_ClipSize = reader.Length();
+	  m_BlockAlign = wave_descriptor->BlockAlign;
 	  m_BytesPerFrame = AS_02::MXF::CalcFrameBufferSize(*wave_descriptor, edit_rate);
 	  m_ClipDurationFrames = m_ClipSize / m_BytesPerFrame;
 
@@ -145,54 +154,159 @@ AS_02::PCM::MXFReader::h__Reader::OpenRead(const std::string& filename, const AS
 	}
     }
 
+  m_FileMap.Close();
+  m_Mapped = false;
+
+  if ( KM_SUCCESS(result) && mapped )
+    {
+      result = m_FileMap.OpenRead(filename);
+
+      if ( KM_SUCCESS(result) && m_FileMap.MapSize() < m_ClipEssenceBegin + m_ClipSize )
+	{
+	  DefaultLogSink().Error("Essence clip extends past the end of the file.\n");
+	  m_FileMap.Close();
+	  result = RESULT_AS02_FORMAT;
+	}
+
+      m_Mapped = KM_SUCCESS(result);
+    }
+
   return result;
 }
 
-//
+// Copies, or in view mode references, a span of the clip with a single read.
+// The span is clipped at the end of the clip.
 ASDCP::Result_t
-AS_02::PCM::MXFReader::h__Reader::ReadFrame(ui32_t FrameNum, ASDCP::PCM::FrameBuffer& FrameBuf,
-					    ASDCP::AESDecContext*, ASDCP::HMACContext*)
+AS_02::PCM::MXFReader::h__Reader::ReadSpan(ui64_t offset, ui64_t length, ASDCP::PCM::FrameBuffer& FrameBuf, bool view)
 {
   if ( ! m_File->IsOpen() )
     {
       return RESULT_INIT;
     }
 
-  if ( ! ( FrameNum < m_ClipDurationFrames ) )
+  if ( ! ( offset < m_ClipSize ) )
     {
       return RESULT_RANGE;
     }
 
   assert(m_ClipEssenceBegin);
-  ui64_t offset = static_cast<ui64_t>(FrameNum) * static_cast<ui64_t>(m_BytesPerFrame);
+  length = Kumu::xmin(length, m_ClipSize - offset);
+
+  if ( length > 0xffffffffULL )
+    {
+      return RESULT_PARAM;
+    }
+
+  ui32_t read_size = static_cast<ui32_t>(length);
   ui64_t position = m_ClipEssenceBegin + offset;
+
+  if ( view )
+    {
+      if ( ! m_Mapped )
+	{
+	  return RESULT_STATE;
+	}
+
+      FrameBuf.SetData(const_cast<byte_t*>(m_FileMap.MapData() + position), read_size);
+      FrameBuf.Size(read_size);
+      return RESULT_OK;
+    }
+
+  if ( FrameBuf.Capacity() < read_size )
+    {
+      return RESULT_SMALLBUF;
+    }
+
+  if ( m_Mapped )
+    {
+      memcpy(FrameBuf.Data(), m_FileMap.MapData() + position, read_size);
+      FrameBuf.Size(read_size);
+      return RESULT_OK;
+    }
+
   Result_t result = RESULT_OK;
 
-  if ( m_File->TellPosition() != static_cast<Kumu::fpos_t>(position) )
+  if ( m_NextPosition != static_cast<Kumu::fpos_t>(position) )
     {
       result = m_File->Seek(position);
     }
 
   if ( KM_SUCCESS(result) )
     {
-      ui64_t remainder = m_ClipSize - offset;
-      ui32_t read_size = ( remainder < m_BytesPerFrame ) ? remainder : m_BytesPerFrame;
       result = m_File->Read(FrameBuf.Data(), read_size);
+    }
 
-      if ( KM_SUCCESS(result) )
-	{
-	  FrameBuf.Size(read_size);
+  if ( KM_SUCCESS(result) )
+    {
+      FrameBuf.Size(read_size);
+      m_NextPosition = position + read_size;
+    }
+  else
+    {
+      m_NextPosition = 0;
+    }
 
-	  if ( read_size < FrameBuf.Capacity() )
-	    {
-	      memset(FrameBuf.Data() + FrameBuf.Size(), 0, FrameBuf.Capacity() - FrameBuf.Size());
-	    }
-	}
+  return result;
+}
+
+//
+ASDCP::Result_t
+AS_02::PCM::MXFReader::h__Reader::ReadFrame(ui32_t FrameNum, ASDCP::PCM::FrameBuffer& FrameBuf,
+					    ASDCP::AESDecContext*, ASDCP::HMACContext*)
+{
+  if ( ! m_File->IsOpen() )
+    {
+      return RESULT_INIT;
+    }
+
+  if ( ! ( FrameNum < m_ClipDurationFrames ) )
+    {
+      return RESULT_RANGE;
+    }
+
+  ui64_t offset = static_cast<ui64_t>(FrameNum) * static_cast<ui64_t>(m_BytesPerFrame);
+  Result_t result = ReadSpan(offset, m_BytesPerFrame, FrameBuf, false);
+
+  // a partial frame at the end of the clip is padded with silence
+  if ( KM_SUCCESS(result) && FrameBuf.Size() < m_BytesPerFrame )
+    {
+      ui32_t pad_end = Kumu::xmin(FrameBuf.Capacity(), m_BytesPerFrame);
+      memset(FrameBuf.Data() + FrameBuf.Size(), 0, pad_end - FrameBuf.Size());
     }
 
   return result;
 }
 
+//
+ASDCP::Result_t
+AS_02::PCM::MXFReader::h__Reader::ReadFrames(ui32_t start_frame, ui32_t frame_count, ASDCP::PCM::FrameBuffer& FrameBuf)
+{
+  if ( ! ( start_frame < m_ClipDurationFrames ) )
+    {
+      return RESULT_RANGE;
+    }
+
+  return ReadSpan(static_cast<ui64_t>(start_frame) * static_cast<ui64_t>(m_BytesPerFrame),
+		  static_cast<ui64_t>(frame_count) * static_cast<ui64_t>(m_BytesPerFrame), FrameBuf, false);
+}
+
+//
+ASDCP::Result_t
+AS_02::PCM::MXFReader::h__Reader::ReadSamples(ui64_t sample_offset, ui32_t sample_count, ASDCP::PCM::FrameBuffer& FrameBuf, bool view)
+{
+  if ( m_BlockAlign == 0 )
+    {
+      return RESULT_INIT;
+    }
+
+  if ( sample_offset > m_ClipSize / m_BlockAlign )
+    {
+      return RESULT_RANGE;
+    }
+
+  return ReadSpan(sample_offset * m_BlockAlign, static_cast<ui64_t>(sample_count) * m_BlockAlign, FrameBuf, view);
+}
+
 
 //------------------------------------------------------------------------------------------
 //
@@ -257,7 +371,29 @@ AS_02::PCM::MXFReader::RIP()
 ASDCP::Result_t
 AS_02::PCM::MXFReader::OpenRead(const std::string& filename, const ASDCP::Rational& edit_rate) const
 {
-  return m_Reader->OpenRead(filename, edit_rate);
+  return m_Reader->OpenRead(filename, edit_rate, false);
+}
+
+// Opens the file as OpenRead() does, and maps it into memory.
+ASDCP::Result_t
+AS_02::PCM::MXFReader::OpenReadMapped(const std::string& filename, const ASDCP::Rational& edit_rate) const
+{
+  return m_Reader->OpenRead(filename, edit_rate, true);
+}
+
+//
+bool
+AS_02::PCM::MXFReader::IsMapped() const
+{
+  return m_Reader && m_Reader->m_Mapped;
+}
+
+//
+Result_t
+AS_02::PCM::MXFReader::OpenRead(ASDCP::EssenceProbe& probe, const ASDCP::Rational& edit_rate) const
+{
+  m_Reader->AdoptFileReader(probe);
+  return OpenRead(probe.Filename(), edit_rate);
 }
 
 //
@@ -267,6 +403,8 @@ AS_02::PCM::MXFReader::Close() const
   if ( m_Reader && m_Reader->m_File->IsOpen() )
     {
       m_Reader->Close();
+      m_Reader->m_FileMap.Close();
+      m_Reader->m_Mapped = false;
       return RESULT_OK;
     }
 
@@ -287,6 +425,36 @@ AS_02::PCM::MXFReader::ReadFrame(ui32_t FrameNum, ASDCP::PCM::FrameBuffer& Frame
   return RESULT_INIT;
 }
 
+// Reads a run of frames with a single read.
+ASDCP::Result_t
+AS_02::PCM::MXFReader::ReadFrames(ui32_t start_frame, ui32_t frame_count, ASDCP::PCM::FrameBuffer& FrameBuf) const
+{
+  if ( m_Reader && m_Reader->m_File->IsOpen() )
+    return m_Reader->ReadFrames(start_frame, frame_count, FrameBuf);
+
+  return RESULT_INIT;
+}
+
+// Reads a run of samples with a single read.
+ASDCP::Result_t
+AS_02::PCM::MXFReader::ReadSamples(ui64_t sample_offset, ui32_t sample_count, ASDCP::PCM::FrameBuffer& FrameBuf) const
+{
+  if ( m_Reader && m_Reader->m_File->IsOpen() )
+    return m_Reader->ReadSamples(sample_offset, sample_count, FrameBuf, false);
+
+  return RESULT_INIT;
+}
+
+// Points the frame buffer at a run of samples in the mapped file.
+ASDCP::Result_t
+AS_02::PCM::MXFReader::ReadSamplesView(ui64_t sample_offset, ui32_t sample_count, ASDCP::PCM::FrameBuffer& FrameBuf) const
+{
+  if ( m_Reader && m_Reader->m_File->IsOpen() )
+    return m_Reader->ReadSamples(sample_offset, sample_count, FrameBuf, true);
+
+  return RESULT_INIT;
+}
+
 
 // Fill the struct with the values from the file's header.
 // Returns RESULT_INIT if the file is not open.
@@ -585,6 +753,22 @@ AS_02::PCM::MXFWriter::WriteFrame(const FrameBuffer& FrameBuf, AESEncContext* Ct
   return m_Writer->WriteFrame(FrameBuf, Ctx, HMAC);
 }
 
+//
+ASDCP::Result_t
+AS_02::PCM::MXFWriter::SetClipBufferSize(ui32_t megabytes)
+{
+  if ( m_Writer.empty() )
+    return RESULT_INIT;
+
+  if ( megabytes > MaxClipBufferSize )
+    {
+      DefaultLogSink().Error("Clip buffer size %u MB exceeds the %u MB limit.\n", megabytes, MaxClipBufferSize);
+      return RESULT_PARAM;
+    }
+
+  return m_Writer->m_ClipBuffer.Size(m_Writer->m_File, megabytes * Kumu::Megabyte);
+}
+
 // Closes the MXF file, writing the index and other closing information.
 ASDCP::Result_t
 AS_02::PCM::MXFWriter::Finalize()
@@ -296,6 +296,14 @@ AS_02::PHDR::MXFReader::OpenRead(const std::string& filename, std::string& PHDR_
   return m_Reader->OpenRead(filename, PHDR_master_metadata);
 }
 
+//
+Result_t
+AS_02::PHDR::MXFReader::OpenRead(ASDCP::EssenceProbe& probe, std::string& PHDR_master_metadata) const
+{
+  m_Reader->AdoptFileReader(probe);
+  return OpenRead(probe.Filename(), PHDR_master_metadata);
+}
+
 //
 Result_t
 AS_02::PHDR::MXFReader::Close() const
@@ -594,6 +602,10 @@ AS_02::PHDR::MXFWriter::h__Writer::WriteFrame(const AS_02::PHDR::FrameBuffer& Fr
       if ( m_FramesWritten > 1 && ( ( m_FramesWritten + 1 ) % m_PartitionSpace ) == 0 )
 	{
 	  assert(m_IndexWriter.GetDuration() > 0);
+
+	  if ( KM_SUCCESS(result) )
+	    result = m_File.EndRegion();
+
 	  FlushIndexPartition();
 
 	  UL body_ul(m_Dict->ul(MDD_ClosedCompleteBodyPartition));
@@ -750,6 +762,16 @@ AS_02::PHDR::MXFWriter::OpenWrite(const std::string& filename, const ASDCP::Writ
   return result;
 }
 
+//
+Result_t
+AS_02::PHDR::MXFWriter::SetPartitionWriters(ui32_t writer_count)
+{
+  if ( m_Writer.empty() )
+    return RESULT_INIT;
+
+  return m_Writer->SetPartitionWriters(writer_count);
+}
+
 // Writes a frame of essence to the MXF file. If the optional AESEncContext
 // argument is present, the essence is encrypted prior to writing.
 // Fails if the file is not open, is finalized, or an operating system
@@ -100,6 +100,11 @@ namespace AS_02
       // buffer's PlaintextOffset parameter will be set to the first byte of the data segment.
       // Set this value to zero if you want encrypted headers.
       Result_t ReadFrame(AS_02::PHDR::FrameBuffer&) const;
+
+      // Reads up to frame_count frames, with their metadata files, ahead of ReadFrame()
+      // on background threads, which are delivered in order. Zero (the default) disables
+      // read-ahead. Returns RESULT_NOTIMPL on platforms without thread support.
+      Result_t SetReadAhead(ui32_t frame_count) const;
     };
 
     //
@@ -127,6 +132,9 @@ namespace AS_02
 			 const ASDCP::Rational& edit_rate, const ui32_t& header_size = 16384,
 			 const IndexStrategy_t& strategy = IS_FOLLOW, const ui32_t& partition_space = 10);
 
+      // write body partitions on writer_count background threads (see h__AS02WriterFrame)
+      Result_t SetPartitionWriters(ui32_t writer_count);
+
       // Writes a frame of essence to the MXF file. If the optional AESEncContext
       // argument is present, the essence is encrypted prior to writing.
       // Fails if the file is not open, is finalized, or an operating system
@@ -159,6 +167,9 @@ namespace AS_02
       // be placed into the string object passed as the second argument.
       Result_t OpenRead(const std::string& filename, std::string& PHDR_master_metadata) const;
 
+      // Open the file examined by the given probe (see EssenceProbe).
+      Result_t OpenRead(ASDCP::EssenceProbe& probe, std::string& PHDR_master_metadata) const;
+
       // Returns RESULT_INIT if the file is not open.
       Result_t Close() const;
 
@@ -80,6 +80,8 @@ public:
   Result_t    MD_to_TimedText_TDesc(TimedTextDescriptor& TDesc);
   Result_t    ReadTimedTextResource(ASDCP::TimedText::FrameBuffer& FrameBuf, AESDecContext* Ctx, HMACContext* HMAC);
   Result_t    ReadAncillaryResource(const Kumu::UUID&, ASDCP::TimedText::FrameBuffer& FrameBuf, AESDecContext* Ctx, HMACContext* HMAC);
+  Result_t    ReadAncillaryResourceToFile(const Kumu::UUID&, const std::string& filename, AESDecContext* Ctx, HMACContext* HMAC);
+  Result_t    GetResourceSubDescriptor(const Kumu::UUID&, TimedTextResourceSubDescriptor** desc_object);
 };
 
 //
@@ -189,10 +191,10 @@ AS_02::TimedText::MXFReader::h__Reader::ReadTimedTextResource(ASDCP::TimedText::
 
 //
 ASDCP::Result_t
-AS_02::TimedText::MXFReader::h__Reader::ReadAncillaryResource(const Kumu::UUID& uuid,
-							      ASDCP::TimedText::FrameBuffer& frame_buf,
-							      AESDecContext* Ctx, HMACContext* HMAC)
+AS_02::TimedText::MXFReader::h__Reader::GetResourceSubDescriptor(const Kumu::UUID& uuid,
+								 TimedTextResourceSubDescriptor** desc_object)
 {
+  assert(desc_object);
   ResourceMap_t::const_iterator ri = m_ResourceMap.find(uuid);
   if ( ri == m_ResourceMap.end() )
     {
@@ -204,11 +206,27 @@ AS_02::TimedText::MXFReader::h__Reader::ReadAncillaryResource(const Kumu::UUID&
   // get the subdescriptor
   InterchangeObject* tmp_iobj = 0;
   Result_t result = m_HeaderPart.GetMDObjectByID((*ri).second, &tmp_iobj);
-  TimedTextResourceSubDescriptor* desc_object = dynamic_cast<TimedTextResourceSubDescriptor*>(tmp_iobj);
+  *desc_object = dynamic_cast<TimedTextResourceSubDescriptor*>(tmp_iobj);
+
+  if ( KM_SUCCESS(result) )
+    {
+      assert(*desc_object);
+    }
+
+  return result;
+}
+
+//
+ASDCP::Result_t
+AS_02::TimedText::MXFReader::h__Reader::ReadAncillaryResource(const Kumu::UUID& uuid,
+							      ASDCP::TimedText::FrameBuffer& frame_buf,
+							      AESDecContext* Ctx, HMACContext* HMAC)
+{
+  TimedTextResourceSubDescriptor* desc_object = 0;
+  Result_t result = GetResourceSubDescriptor(uuid, &desc_object);
 
   if ( KM_SUCCESS(result) )
     {
-      assert(desc_object);
       result = ReadGenericStreamPartitionPayload(desc_object->EssenceStreamID, frame_buf, Ctx, HMAC);
     }
 
@@ -221,6 +239,42 @@ AS_02::TimedText::MXFReader::h__Reader::ReadAncillaryResource(const Kumu::UUID&
   return result;
 }
 
+//
+ASDCP::Result_t
+AS_02::TimedText::MXFReader::h__Reader::ReadAncillaryResourceToFile(const Kumu::UUID& uuid, const std::string& filename,
+								    AESDecContext* Ctx, HMACContext* HMAC)
+{
+  TimedTextResourceSubDescriptor* desc_object = 0;
+  Result_t result = GetResourceSubDescriptor(uuid, &desc_object);
+  Kumu::FileWriter writer;
+
+  if ( KM_SUCCESS(result) )
+    {
+      result = writer.OpenWrite(filename);
+    }
+
+  if ( KM_SUCCESS(result) )
+    {
+      if ( m_Info.EncryptedEssence )
+	{
+	  // the cipher works on the whole payload, so take the buffered path
+	  ASDCP::TimedText::FrameBuffer frame_buf;
+	  result = ReadGenericStreamPartitionPayload(desc_object->EssenceStreamID, frame_buf, Ctx, HMAC);
+
+	  if ( KM_SUCCESS(result) )
+	    {
+	      result = writer.Write(frame_buf.RoData(), frame_buf.Size());
+	    }
+	}
+      else
+	{
+	  result = CopyGenericStreamPartitionPayload(desc_object->EssenceStreamID, writer);
+	}
+    }
+
+  return result;
+}
+
 
 //------------------------------------------------------------------------------------------
 
@@ -287,6 +341,14 @@ AS_02::TimedText::MXFReader::OpenRead(const std::string& filename) const
   return m_Reader->OpenRead(filename);
 }
 
+//
+ASDCP::Result_t
+AS_02::TimedText::MXFReader::OpenRead(ASDCP::EssenceProbe& probe) const
+{
+  m_Reader->AdoptFileReader(probe);
+  return OpenRead(probe.Filename());
+}
+
 // Fill the struct with the values from the file's header.
 // Returns RESULT_INIT if the file is not open.
 ASDCP::Result_t
@@ -351,6 +413,17 @@ AS_02::TimedText::MXFReader::ReadAncillaryResource(const Kumu::UUID& uuid, ASDCP
   return RESULT_INIT;
 }
 
+//
+ASDCP::Result_t
+AS_02::TimedText::MXFReader::ReadAncillaryResourceToFile(const Kumu::UUID& uuid, const std::string& filename,
+							 AESDecContext* Ctx, HMACContext* HMAC) const
+{
+  if ( m_Reader && m_Reader->m_File->IsOpen() )
+    return m_Reader->ReadAncillaryResourceToFile(uuid, filename, Ctx, HMAC);
+
+  return RESULT_INIT;
+}
+
 
 //
 void
@@ -409,6 +482,8 @@ public:
   Result_t SetSourceStream(const ASDCP::TimedText::TimedTextDescriptor&);
   Result_t WriteTimedTextResource(const std::string& XMLDoc, AESEncContext* = 0, HMACContext* = 0);
   Result_t WriteAncillaryResource(const ASDCP::TimedText::FrameBuffer&, AESEncContext* = 0, HMACContext* = 0);
+  Result_t WriteAncillaryResourceFromFile(const std::string& filename, AESEncContext* = 0, HMACContext* = 0);
+  Result_t WriteGenericStreamPartition();
   Result_t Finalize();
   Result_t TimedText_TDesc_to_MD(ASDCP::TimedText::TimedTextDescriptor& TDesc);
 };
@@ -591,22 +666,15 @@ AS_02::TimedText::MXFWriter::h__Writer::WriteTimedTextResource(const std::string
 }
 
 
-//
+// Writes the Generic Stream Partition pack that precedes each ancillary resource
+// and records the partition in the RIP.
 ASDCP::Result_t
-AS_02::TimedText::MXFWriter::h__Writer::WriteAncillaryResource(const ASDCP::TimedText::FrameBuffer& FrameBuf,
-							       ASDCP::AESEncContext* Ctx, ASDCP::HMACContext* HMAC)
+AS_02::TimedText::MXFWriter::h__Writer::WriteGenericStreamPartition()
 {
-  if ( ! m_State.Test_RUNNING() )
-    {
-      KM_RESULT_STATE_HERE();
-      return RESULT_STATE;
-    }
-
   Kumu::fpos_t here = m_File.TellPosition();
   assert(m_Dict);
 
   // create generic stream partition header
-  static UL GenericStream_DataElement(m_Dict->ul(MDD_GenericStream_DataElement));
   ASDCP::MXF::Partition GSPart(m_Dict);
 
   GSPart.MajorVersion = m_HeaderPart.MajorVersion;
@@ -619,7 +687,22 @@ AS_02::TimedText::MXFWriter::h__Writer::WriteAncillaryResource(const ASDCP::Time
   m_RIP.PairArray.push_back(RIP::PartitionPair(m_EssenceStreamID++, here));
   GSPart.EssenceContainers = m_HeaderPart.EssenceContainers;
   UL TmpUL(m_Dict->ul(MDD_GenericStreamPartition));
-  Result_t result = GSPart.WriteToFile(m_File, TmpUL);
+  return GSPart.WriteToFile(m_File, TmpUL);
+}
+
+//
+ASDCP::Result_t
+AS_02::TimedText::MXFWriter::h__Writer::WriteAncillaryResource(const ASDCP::TimedText::FrameBuffer& FrameBuf,
+							       ASDCP::AESEncContext* Ctx, ASDCP::HMACContext* HMAC)
+{
+  if ( ! m_State.Test_RUNNING() )
+    {
+      KM_RESULT_STATE_HERE();
+      return RESULT_STATE;
+    }
+
+  static UL GenericStream_DataElement(m_Dict->ul(MDD_GenericStream_DataElement));
+  Result_t result = WriteGenericStreamPartition();
 
   if ( KM_SUCCESS(result) )
     {
@@ -632,6 +715,57 @@ AS_02::TimedText::MXFWriter::h__Writer::WriteAncillaryResource(const ASDCP::Time
   return result;
 }
 
+//
+ASDCP::Result_t
+AS_02::TimedText::MXFWriter::h__Writer::WriteAncillaryResourceFromFile(const std::string& filename,
+								       ASDCP::AESEncContext* Ctx, ASDCP::HMACContext* HMAC)
+{
+  if ( ! m_State.Test_RUNNING() )
+    {
+      KM_RESULT_STATE_HERE();
+      return RESULT_STATE;
+    }
+
+  Kumu::FileReader reader;
+  Result_t result = reader.OpenRead(filename);
+
+  if ( KM_SUCCESS(result) && m_Info.EncryptedEssence )
+    {
+      // the cipher works on the whole payload, so take the buffered path
+      ASDCP::TimedText::FrameBuffer FrameBuf;
+      ui32_t read_count = 0;
+      result = FrameBuf.Capacity(reader.Size());
+
+      if ( KM_SUCCESS(result) )
+	result = reader.Read(FrameBuf.Data(), FrameBuf.Capacity(), &read_count);
+
+      if ( KM_SUCCESS(result) )
+	{
+	  FrameBuf.Size(read_count);
+	  result = WriteAncillaryResource(FrameBuf, Ctx, HMAC);
+	}
+
+      return result;
+    }
+
+  static UL GenericStream_DataElement(m_Dict->ul(MDD_GenericStream_DataElement));
+
+  if ( KM_SUCCESS(result) )
+    {
+      result = WriteGenericStreamPartition();
+
+      if ( KM_SUCCESS(result) )
+	{
+	  result = Write_KLV_PacketFromFile(m_File, m_StreamOffset, reader, reader.Size(),
+					    GenericStream_DataElement.Value(), MXF_BER_LENGTH);
+	}
+
+      m_FramesWritten++;
+    }
+
+  return result;
+}
+
 //
 ASDCP::Result_t
 AS_02::TimedText::MXFWriter::h__Writer::Finalize()
@@ -740,6 +874,16 @@ AS_02::TimedText::MXFWriter::WriteAncillaryResource(const ASDCP::TimedText::Fram
   return m_Writer->WriteAncillaryResource(FrameBuf, Ctx, HMAC);
 }
 
+//
+ASDCP::Result_t
+AS_02::TimedText::MXFWriter::WriteAncillaryResourceFromFile(const std::string& filename, AESEncContext* Ctx, HMACContext* HMAC)
+{
+  if ( m_Writer.empty() )
+    return RESULT_INIT;
+
+  return m_Writer->WriteAncillaryResourceFromFile(filename, Ctx, HMAC);
+}
+
 // Closes the MXF file, writing the index and other closing information.
 ASDCP::Result_t
 AS_02::TimedText::MXFWriter::Finalize()
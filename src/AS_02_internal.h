@@ -142,6 +142,31 @@ namespace AS_02
       };
   }
 
+  // default and largest size of the clip staging buffer, in megabytes
+  const ui32_t DefaultClipBufferSize = 4;
+  const ui32_t MaxClipBufferSize = 1024;
+
+  // Collects clip-wrapped essence so that it reaches the file in writes of the
+  // buffer size, each ending on a file offset that is a multiple of that size.
+  // Flush() before seeking or writing to the file directly.
+  class ClipStagingBuffer
+    {
+      Kumu::ByteString m_Buffer;
+      ui32_t m_Size;   // configured size, zero writes through
+      ui32_t m_Limit;  // length at which the buffer is written, zero if not yet known
+
+      KM_NO_COPY_CONSTRUCT(ClipStagingBuffer);
+
+    public:
+      ClipStagingBuffer() : m_Size(0), m_Limit(0) {}
+      ~ClipStagingBuffer() {}
+
+      inline ui32_t Size() const { return m_Size; }
+      Result_t Size(Kumu::FileWriter& Writer, ui32_t size); // flushes first
+      Result_t Write(Kumu::FileWriter& Writer, const byte_t* buf, ui32_t buf_len);
+      Result_t Flush(Kumu::FileWriter& Writer);
+    };
+
   //
   template <class IndexWriterType>
   class h__AS02Writer : public ASDCP::MXF::TrackFileWriter<ASDCP::MXF::OP1aHeader>
@@ -266,38 +291,36 @@ namespace AS_02
 	if ( KM_SUCCESS(result) )
 	  result = m_HeaderPart.WriteToFile(this->m_File, this->m_HeaderSize);
   
-	if ( KM_SUCCESS(result) )
+	// Every partition between the header and the footer was written by this
+	// writer and carries a body or index SID, so PreviousPartition and
+	// FooterPartition are patched in place without reading the packs back.
+	// The two fields are adjacent and at the same offset in every pack.
+	if ( KM_SUCCESS(result) && this->m_RIP.PairArray.size() > 2 )
 	  {
+	    const ui32_t previous_partition_offset = ASDCP::MXF::kl_length
+	      + sizeof(ui16_t) + sizeof(ui16_t) + sizeof(ui32_t) + sizeof(ui64_t);
+
 	    ASDCP::MXF::RIP::const_pair_iterator i = this->m_RIP.PairArray.begin();
-	    ui64_t previous_partition = 0;
+	    ASDCP::MXF::RIP::const_pair_iterator last = --this->m_RIP.PairArray.end();
+	    ui64_t previous_partition = i->ByteOffset;
 
-	    for ( i = this->m_RIP.PairArray.begin(); KM_SUCCESS(result) && i != this->m_RIP.PairArray.end(); ++i )
+	    for ( ++i; KM_SUCCESS(result) && i != last; ++i )
 	      {
-		ASDCP::MXF::Partition plain_part(this->m_Dict);
-		result = this->m_File.Seek(i->ByteOffset);
+		byte_t patch_buf[sizeof(ui64_t) * 2];
+		Kumu::MemIOWriter MemWRT(patch_buf, sizeof(patch_buf));
+		MemWRT.WriteUi64BE(previous_partition);
+		MemWRT.WriteUi64BE(footer_part.ThisPartition);
+		previous_partition = i->ByteOffset;
+
+		result = this->m_File.Seek(i->ByteOffset + previous_partition_offset);
 
 		if ( KM_SUCCESS(result) )
-		  result = plain_part.InitFromFile(this->m_File);
-		
-		if ( KM_SUCCESS(result)
-		     && ( plain_part.IndexSID > 0 || plain_part.BodySID > 0 ) )
-		  {
-		    plain_part.PreviousPartition = previous_partition;
-		    plain_part.FooterPartition = footer_part.ThisPartition;
-		    previous_partition = plain_part.ThisPartition;
-		    result = this->m_File.Seek(i->ByteOffset);
-
-		    if ( KM_SUCCESS(result) )
-		      {
-			UL tmp_ul = plain_part.GetUL();
-			result = plain_part.WriteToFile(this->m_File, tmp_ul);
-		      }
-		  }
+		  result = this->m_File.Write(patch_buf, sizeof(patch_buf));
 	      }
 	  }
 	
-	this->m_File.Close();
-	return result;
+	Result_t close_result = this->m_File.Close();
+	return KM_SUCCESS(result) ? close_result : result;
       }
     };
 
@@ -316,6 +339,20 @@ namespace AS_02
       Result_t WriteEKLVPacket(const ASDCP::FrameBuffer& FrameBuf,const byte_t* EssenceUL,
 			       const ui32_t& MinEssenceElementBerLength,
 			       AESEncContext* Ctx, HMACContext* HMAC);
+
+      // as above for a plaintext element whose value is copied from the reader
+      Result_t WriteKLVPacketFromFile(const Kumu::IFileReader& Reader, ui64_t length, const byte_t* EssenceUL,
+				      const ui32_t& MinEssenceElementBerLength);
+
+      // index the element written at stream_offset and start a new body partition when due
+      Result_t IndexFrame(ui64_t stream_offset, Result_t result);
+
+      // Writes each body partition through writer_count background threads (see
+      // Kumu::FileWriter::StartWriteBehind()) while the following frames are prepared.
+      // Call after OpenWrite() and before the first frame is written; zero restores
+      // sequential writing. Returns RESULT_NOTIMPL where write-behind is not available
+      // (Win32). Backs SetPartitionWriters() on each AS-02 MXFWriter.
+      Result_t SetPartitionWriters(ui32_t writer_count);
     };
 
   //
@@ -329,11 +366,14 @@ namespace AS_02
         ui64_t  m_ECStart; // offset of the first essence element
         ui64_t  m_ClipStart;  // state variable for clip-wrap-in-progress
         IndexStrategy_t m_IndexStrategy; // per SMPTE ST 2067-5
+        ClipStagingBuffer m_ClipBuffer;
 
         h__AS02WriterClip(const Dictionary* d) :
             h__AS02Writer<IndexWriterType>(d),
             m_ECStart(0), m_ClipStart(0), m_IndexStrategy(AS_02::IS_FOLLOW)
-        {}
+        {
+            m_ClipBuffer.Size(h__AS02Writer<IndexWriterType>::m_File, DefaultClipBufferSize * Kumu::Megabyte);
+        }
         virtual ~h__AS02WriterClip()
         {}
 
@@ -367,7 +407,7 @@ namespace AS_02
                 return RESULT_STATE;
             }
 
-            return h__AS02Writer<IndexWriterType>::m_File.Write(FrameBuf.RoData(), FrameBuf.Size());
+            return m_ClipBuffer.Write(h__AS02Writer<IndexWriterType>::m_File, FrameBuf.RoData(), FrameBuf.Size());
         }
         Result_t FinalizeClip(ui32_t bytes_per_frame)
         {
@@ -377,8 +417,15 @@ namespace AS_02
                 return RESULT_STATE;
             }
 
+            Result_t result = m_ClipBuffer.Flush(h__AS02Writer<IndexWriterType>::m_File);
+
+            if (KM_FAILURE(result))
+            {
+                return result;
+            }
+
             ui64_t current_position = h__AS02Writer<IndexWriterType>::m_File.TellPosition();
-            Result_t result = h__AS02Writer<IndexWriterType>::m_File.Seek(m_ClipStart + 16);
+            result = h__AS02Writer<IndexWriterType>::m_File.Seek(m_ClipStart + 16);
 
             if (KM_SUCCESS(result))
             {
@@ -405,8 +452,15 @@ namespace AS_02
                 return RESULT_STATE;
             }
 
+            Result_t result = m_ClipBuffer.Flush(h__AS02Writer<IndexWriterType>::m_File);
+
+            if (KM_FAILURE(result))
+            {
+                return result;
+            }
+
             ui64_t current_position = h__AS02Writer<IndexWriterType>::m_File.TellPosition();
-            Result_t result = h__AS02Writer<IndexWriterType>::m_File.Seek(m_ClipStart + 16);
+            result = h__AS02Writer<IndexWriterType>::m_File.Seek(m_ClipStart + 16);
 
             if (KM_SUCCESS(result))
             {
@@ -93,6 +93,7 @@ This project depends upon the following libraries:
 #include <string>
 #include <cstring>
 #include <list>
+#include <map>
 
 //--------------------------------------------------------------------------------
 // common integer types
@@ -343,6 +344,41 @@ namespace ASDCP {
       inline bool empty()      const { return m_p == 0; }
     };
 
+  // Holds an MXF file that has been opened and examined by EssenceType().
+  // The partition pack, header metadata and RIP read while probing are kept
+  // in memory. The OpenRead(EssenceProbe&) method of each typed reader takes
+  // over the open file and reads the RIP and header from those bytes, so the
+  // file is not opened and they are not read from storage a second time. The
+  // probe holds no file afterwards. If it has none to hand over, the reader
+  // opens Filename() itself, exactly as OpenRead(filename) does.
+  class EssenceProbe
+    {
+      class h__EssenceProbe;
+      mem_ptr<h__EssenceProbe> m_Probe;
+      ASDCP_NO_COPY_CONSTRUCT(EssenceProbe);
+
+    public:
+      EssenceProbe();
+      virtual ~EssenceProbe();
+
+      // Opens the file and determines its essence type. The file is left
+      // open until it is released or the probe is destroyed.
+      Result_t OpenRead(const std::string& filename, const Kumu::IFileReaderFactory& fileReaderFactory);
+
+      const std::string& Filename() const; // the name of the examined file
+      EssenceType_t Type() const;          // the type found by OpenRead(), ESS_UNKNOWN if none
+
+      // Transfers ownership of the open file to the caller. Returns NULL if
+      // no file is open or if it has already been released.
+      Kumu::IFileReader* ReleaseFileReader();
+      void Close();
+    };
+
+  // Determine the type of essence contained in the given MXF file, leaving the
+  // file open in the given probe for use by a subsequent OpenRead(EssenceProbe&).
+  Result_t EssenceType(const std::string& filename, EssenceType_t& type,
+		       const Kumu::IFileReaderFactory& fileReaderFactory, EssenceProbe& probe);
+
 
   //---------------------------------------------------------------------------------
   // WriterInfo class - encapsulates writer identification details used for
@@ -808,6 +844,9 @@ namespace ASDCP {
 	  // operation cannot be completed.
 	  Result_t OpenRead(const std::string& filename) const;
 
+	  // Open the file examined by the given probe (see EssenceProbe).
+	  Result_t OpenRead(EssenceProbe& probe) const;
+
 	  // Returns RESULT_INIT if the file is not open.
 	  Result_t Close() const;
 
@@ -931,6 +970,16 @@ namespace ASDCP {
 	  void Dump(FILE* = 0, ui32_t dump_bytes = 0) const;
 	};
 
+      // Sample conversion applied by WAVParser as frames are read. When conversion is
+      // selected, 16-bit and 32-bit integer and 32-bit IEEE float WAV or RF64 input is
+      // delivered as 24-bit integer PCM and the AudioDescriptor describes the 24-bit
+      // result. 24-bit input is always passed through unchanged.
+      enum SampleConversion_t {
+	SC_NONE,         // deliver samples as stored; floating point input is rejected
+	SC_24BIT,        // convert to 24-bit, rounding to nearest on word-length reduction
+	SC_24BIT_DITHER  // convert to 24-bit, adding TPDF dither on word-length reduction
+      };
+
       // An object which opens and reads a WAV file.  The call to OpenRead() reads metadata from
       // the file and populates an internal AudioDescriptor object. Each subsequent call to
       // ReadFrame() reads exactly one frame from the stream into the given FrameBuffer object.
@@ -947,8 +996,10 @@ namespace ASDCP {
 
 	  // Opens the stream for reading, parses enough data to provide a complete
 	  // set of stream metadata for the MXFWriter below. PictureRate controls
-	  // ther frame rate for the MXF frame wrapping option.
-	  Result_t OpenRead(const std::string& filename, const Rational& PictureRate) const;
+	  // ther frame rate for the MXF frame wrapping option. Conversion selects
+	  // the sample conversion applied by ReadFrame().
+	  Result_t OpenRead(const std::string& filename, const Rational& PictureRate,
+			    SampleConversion_t Conversion = SC_NONE) const;
 
 	  // Fill an AudioDescriptor struct with the values from the file's header.
 	  // Returns RESULT_INIT if the file is not open.
@@ -962,6 +1013,24 @@ namespace ASDCP {
 	  Result_t ReadFrame(FrameBuffer&) const;
 
 	  Result_t Seek(ui32_t frame_number) const;
+
+	  // Opens the stream as OpenRead() does, but maps the whole file into memory
+	  // instead of reading it. ReadFrame() then copies frames out of the mapping,
+	  // and ReadFrameView() may be used to avoid the copy.
+	  Result_t OpenReadMapped(const std::string& filename, const Rational& PictureRate,
+				  SampleConversion_t Conversion = SC_NONE) const;
+
+	  // Returns true if the stream was opened with OpenReadMapped().
+	  bool IsMapped() const;
+
+	  // Like ReadFrame(), but uses FrameBuffer::SetData() to point the frame buffer
+	  // at the frame rather than copying it. Unconverted whole frames are referenced
+	  // in place in the mapping; converted frames and a short final frame are held
+	  // in storage owned by the parser. The data must be treated as read-only and is
+	  // valid until the next read, Reset(), Seek() or until the parser is destroyed.
+	  // Call FB.SetData(0, 0) to return the buffer to internal allocation.
+	  // Returns RESULT_STATE if the stream was not opened with OpenReadMapped().
+	  Result_t ReadFrameView(FrameBuffer&) const;
 	};
 
 
@@ -1019,6 +1088,9 @@ namespace ASDCP {
 	  // operation cannot be completed.
 	  Result_t OpenRead(const std::string& filename) const;
 
+	  // Open the file examined by the given probe (see EssenceProbe).
+	  Result_t OpenRead(EssenceProbe& probe) const;
+
 	  // Returns RESULT_INIT if the file is not open.
 	  Result_t Close() const;
 
@@ -1297,6 +1369,9 @@ namespace ASDCP {
 	  // operation cannot be completed.
 	  Result_t OpenRead(const std::string& filename) const;
 
+	  // Open the file examined by the given probe (see EssenceProbe).
+	  Result_t OpenRead(EssenceProbe& probe) const;
+
 	  // Returns RESULT_INIT if the file is not open.
 	  Result_t Close() const;
 
@@ -1412,6 +1487,9 @@ namespace ASDCP {
 	  // operation cannot be completed.
 	  Result_t OpenRead(const std::string& filename) const;
 
+	  // Open the file examined by the given probe (see EssenceProbe).
+	  Result_t OpenRead(EssenceProbe& probe) const;
+
 	  // Returns RESULT_INIT if the file is not open.
 	  Result_t Close() const;
 
@@ -1522,11 +1600,14 @@ namespace ASDCP {
       };
 
       // Resolves resource references by testing the named directory for file names containing
-      // the respective UUID.
+      // the respective UUID. The directory is indexed once by OpenRead(). ResolveRID()
+      // reads into the given buffer, enlarging it only when the resource does not fit.
       //
       class LocalFilenameResolver : public ASDCP::TimedText::IResourceResolver
 	{
+	  typedef std::map<Kumu::UUID, Kumu::PathList_t> ResourceMap;
 	  std::string m_Dirname;
+	  ResourceMap m_ResourceMap;
 	  ASDCP_NO_COPY_CONSTRUCT(LocalFilenameResolver);
 
 	public:
@@ -1638,6 +1719,9 @@ namespace ASDCP {
 	  // operation cannot be completed.
 	  Result_t OpenRead(const std::string& filename) const;
 
+	  // Open the file examined by the given probe (see EssenceProbe).
+	  Result_t OpenRead(EssenceProbe& probe) const;
+
 	  // Returns RESULT_INIT if the file is not open.
 	  Result_t Close() const;
 
@@ -1799,6 +1883,11 @@ namespace ASDCP {
 	  // error occurs.
 	  Result_t WriteFrame(const FrameBuffer&, AESEncContext* = 0, HMACContext* = 0);
 
+	  // Writes frame_count frames from the array as WriteFrame() would. Plaintext
+	  // frames are written with one gather write per batch of packets, which
+	  // saves a system call per frame for small frames.
+	  Result_t WriteFrames(const FrameBuffer*, ui32_t frame_count, AESEncContext* = 0, HMACContext* = 0);
+
 	  // Closes the MXF file, writing the index and revised header.
 	  Result_t Finalize();
 	};
@@ -1824,6 +1913,9 @@ namespace ASDCP {
 	  // operation cannot be completed.
 	  Result_t OpenRead(const std::string& filename) const;
 
+	  // Open the file examined by the given probe (see EssenceProbe).
+	  Result_t OpenRead(EssenceProbe& probe) const;
+
 	  // Returns RESULT_INIT if the file is not open.
 	  Result_t Close() const;
 
@@ -1907,6 +1999,11 @@ namespace ASDCP {
 	  // error occurs.
       Result_t WriteFrame(const DCData::FrameBuffer&, AESEncContext* = 0, HMACContext* = 0);
 
+	  // Writes frame_count frames from the array as WriteFrame() would. Plaintext
+	  // frames are written with one gather write per batch of packets, which
+	  // saves a system call per frame for small frames.
+	  Result_t WriteFrames(const DCData::FrameBuffer*, ui32_t frame_count, AESEncContext* = 0, HMACContext* = 0);
+
 	  // Closes the MXF file, writing the index and revised header.
 	  Result_t Finalize();
 	};
@@ -1932,6 +2029,9 @@ namespace ASDCP {
 	  // operation cannot be completed.
 	  Result_t OpenRead(const std::string& filename) const;
 
+	  // Open the file examined by the given probe (see EssenceProbe).
+	  Result_t OpenRead(EssenceProbe& probe) const;
+
 	  // Returns RESULT_INIT if the file is not open.
 	  Result_t Close() const;
 
@@ -315,6 +315,14 @@ ASDCP::ATMOS::MXFReader::OpenRead(const std::string& filename) const
   return m_Reader->OpenRead(filename);
 }
 
+//
+ASDCP::Result_t
+ASDCP::ATMOS::MXFReader::OpenRead(EssenceProbe& probe) const
+{
+  m_Reader->AdoptFileReader(probe);
+  return OpenRead(probe.Filename());
+}
+
 //
 ASDCP::Result_t
 ASDCP::ATMOS::MXFReader::ReadFrame(ui32_t FrameNum, DCData::FrameBuffer& FrameBuf,
@@ -417,6 +425,7 @@ class ASDCP::ATMOS::MXFWriter::h__Writer : public ASDCP::h__ASDCPWriter
   Result_t OpenWrite(const std::string&, ui32_t HeaderSize, const AtmosDescriptor& ADesc);
   Result_t SetSourceStream(const DCData::DCDataDescriptor&, const byte_t*, const std::string&, const std::string&);
   Result_t WriteFrame(const FrameBuffer&, AESEncContext* = 0, HMACContext* = 0);
+  Result_t WriteFrames(const DCData::FrameBuffer*, ui32_t, AESEncContext* = 0, HMACContext* = 0);
   Result_t Finalize();
   Result_t DCData_DDesc_to_MD(ASDCP::DCData::DCDataDescriptor& DDesc);
   Result_t Atmos_ADesc_to_MD(const AtmosDescriptor& ADesc);
@@ -541,6 +550,9 @@ ASDCP::ATMOS::MXFWriter::h__Writer::SetSourceStream(ASDCP::DCData::DCDataDescrip
 			      m_DDesc.EditRate, TCFrameRate);
   }
 
+  if ( ASDCP_SUCCESS(result) )
+    m_FooterPart.ReserveIndexEntries(m_DDesc.ContainerDuration);
+
   return result;
 }
 
@@ -569,6 +581,28 @@ ASDCP::ATMOS::MXFWriter::h__Writer::WriteFrame(const FrameBuffer& FrameBuf,
   return result;
 }
 
+//
+ASDCP::Result_t
+ASDCP::ATMOS::MXFWriter::h__Writer::WriteFrames(const DCData::FrameBuffer* FrameBufs, ui32_t frame_count,
+						 ASDCP::AESEncContext* Ctx, ASDCP::HMACContext* HMAC)
+{
+  ASDCP_TEST_NULL(FrameBufs);
+  Result_t result = RESULT_OK;
+
+  if ( m_State.Test_READY() )
+    result = m_State.Goto_RUNNING(); // first time through
+
+  std::vector<const ASDCP::FrameBuffer*> FrameBufList(frame_count);
+
+  for ( ui32_t i = 0; i < frame_count; ++i )
+    FrameBufList[i] = &FrameBufs[i];
+
+  if ( ASDCP_SUCCESS(result) && frame_count > 0 )
+    result = WriteIndexedEKLVPackets(&FrameBufList[0], frame_count, m_EssenceUL, MXF_BER_LENGTH, Ctx, HMAC);
+
+  return result;
+}
+
 // Closes the MXF file, writing the index and other closing information.
 //
 ASDCP::Result_t
@@ -679,6 +713,17 @@ ASDCP::ATMOS::MXFWriter::WriteFrame(const DCData::FrameBuffer& FrameBuf, AESEncC
   return m_Writer->WriteFrame(FrameBuf, Ctx, HMAC);
 }
 
+// Writes several frames of essence to the MXF file, gathering plaintext
+// packets into fewer writes.
+ASDCP::Result_t
+ASDCP::ATMOS::MXFWriter::WriteFrames(const DCData::FrameBuffer* FrameBufs, ui32_t frame_count, AESEncContext* Ctx, HMACContext* HMAC)
+{
+  if ( m_Writer.empty() )
+    return RESULT_INIT;
+
+  return m_Writer->WriteFrames(FrameBufs, frame_count, Ctx, HMAC);
+}
+
 // Closes the MXF file, writing the index and other closing information.
 ASDCP::Result_t
 ASDCP::ATMOS::MXFWriter::Finalize()
@@ -289,6 +289,14 @@ ASDCP::DCData::MXFReader::OpenRead(const std::string& filename) const
   return m_Reader->OpenRead(filename);
 }
 
+//
+ASDCP::Result_t
+ASDCP::DCData::MXFReader::OpenRead(EssenceProbe& probe) const
+{
+  m_Reader->AdoptFileReader(probe);
+  return OpenRead(probe.Filename());
+}
+
 //
 ASDCP::Result_t
 ASDCP::DCData::MXFReader::ReadFrame(ui32_t FrameNum, FrameBuffer& FrameBuf,
@@ -388,6 +396,7 @@ public:
   Result_t OpenWrite(const std::string&, ui32_t HeaderSize, const SubDescriptorList_t& subDescriptors);
   Result_t SetSourceStream(const DCDataDescriptor&, const byte_t*, const std::string&, const std::string&);
   Result_t WriteFrame(const FrameBuffer&, AESEncContext* = 0, HMACContext* = 0);
+  Result_t WriteFrames(const DCData::FrameBuffer*, ui32_t, AESEncContext* = 0, HMACContext* = 0);
   Result_t Finalize();
   Result_t DCData_DDesc_to_MD(DCData::DCDataDescriptor& DDesc);
 };
@@ -485,6 +494,9 @@ ASDCP::DCData::MXFWriter::h__Writer::SetSourceStream(DCDataDescriptor const& DDe
 			      m_DDesc.EditRate, TCFrameRate);
   }
 
+  if ( ASDCP_SUCCESS(result) )
+    m_FooterPart.ReserveIndexEntries(m_DDesc.ContainerDuration);
+
   return result;
 }
 
@@ -513,6 +525,28 @@ ASDCP::DCData::MXFWriter::h__Writer::WriteFrame(const FrameBuffer& FrameBuf,
   return result;
 }
 
+//
+ASDCP::Result_t
+ASDCP::DCData::MXFWriter::h__Writer::WriteFrames(const DCData::FrameBuffer* FrameBufs, ui32_t frame_count,
+                                                 ASDCP::AESEncContext* Ctx, ASDCP::HMACContext* HMAC)
+{
+  ASDCP_TEST_NULL(FrameBufs);
+  Result_t result = RESULT_OK;
+
+  if ( m_State.Test_READY() )
+    result = m_State.Goto_RUNNING(); // first time through
+
+  std::vector<const ASDCP::FrameBuffer*> FrameBufList(frame_count);
+
+  for ( ui32_t i = 0; i < frame_count; ++i )
+    FrameBufList[i] = &FrameBufs[i];
+
+  if ( ASDCP_SUCCESS(result) && frame_count > 0 )
+    result = WriteIndexedEKLVPackets(&FrameBufList[0], frame_count, m_EssenceUL, MXF_BER_LENGTH, Ctx, HMAC);
+
+  return result;
+}
+
 // Closes the MXF file, writing the index and other closing information.
 //
 ASDCP::Result_t
@@ -622,6 +656,17 @@ ASDCP::DCData::MXFWriter::WriteFrame(const FrameBuffer& FrameBuf, AESEncContext*
   return m_Writer->WriteFrame(FrameBuf, Ctx, HMAC);
 }
 
+// Writes several frames of essence to the MXF file, gathering plaintext
+// packets into fewer writes.
+ASDCP::Result_t
+ASDCP::DCData::MXFWriter::WriteFrames(const FrameBuffer* FrameBufs, ui32_t frame_count, AESEncContext* Ctx, HMACContext* HMAC)
+{
+  if ( m_Writer.empty() )
+    return RESULT_INIT;
+
+  return m_Writer->WriteFrames(FrameBufs, frame_count, Ctx, HMAC);
+}
+
 // Closes the MXF file, writing the index and other closing information.
 ASDCP::Result_t
 ASDCP::DCData::MXFWriter::Finalize()
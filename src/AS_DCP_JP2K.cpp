@@ -812,6 +812,14 @@ ASDCP::JP2K::MXFReader::OpenRead(const std::string& filename) const
   return m_Reader->OpenRead(filename, ASDCP::ESS_JPEG_2000);
 }
 
+//
+ASDCP::Result_t
+ASDCP::JP2K::MXFReader::OpenRead(EssenceProbe& probe) const
+{
+  m_Reader->AdoptFileReader(probe);
+  return OpenRead(probe.Filename());
+}
+
 //
 ASDCP::Result_t
 ASDCP::JP2K::MXFReader::ReadFrame(ui32_t FrameNum, FrameBuffer& FrameBuf,
@@ -1038,6 +1046,14 @@ ASDCP::JP2K::MXFSReader::OpenRead(const std::string& filename) const
   return m_Reader->OpenRead(filename, ASDCP::ESS_JPEG_2000_S);
 }
 
+//
+ASDCP::Result_t
+ASDCP::JP2K::MXFSReader::OpenRead(EssenceProbe& probe) const
+{
+  m_Reader->AdoptFileReader(probe);
+  return OpenRead(probe.Filename());
+}
+
 //
 ASDCP::Result_t
 ASDCP::JP2K::MXFSReader::ReadFrame(ui32_t FrameNum, SFrameBuffer& FrameBuf, AESDecContext* Ctx, HMACContext* HMAC) const
@@ -338,6 +338,14 @@ ASDCP::JXS::MXFReader::OpenRead(const std::string& filename) const
   return m_Reader->OpenRead(filename, ASDCP::ESS_JPEG_XS);
 }
 
+//
+ASDCP::Result_t
+ASDCP::JXS::MXFReader::OpenRead(EssenceProbe& probe) const
+{
+  m_Reader->AdoptFileReader(probe);
+  return OpenRead(probe.Filename());
+}
+
 //
 ASDCP::Result_t
 ASDCP::JXS::MXFReader::ReadFrame(ui32_t FrameNum, FrameBuffer& FrameBuf,
@@ -150,6 +150,9 @@ namespace ASDCP {
 		  // operation cannot be completed.
 		  Result_t OpenRead(const std::string& filename) const;
 
+		  // Open the file examined by the given probe (see EssenceProbe).
+		  Result_t OpenRead(EssenceProbe& probe) const;
+
 		  // Returns RESULT_INIT if the file is not open.
 		  Result_t Close() const;
 
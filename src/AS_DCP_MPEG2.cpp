@@ -411,6 +411,14 @@ ASDCP::MPEG2::MXFReader::OpenRead(const std::string& filename) const
   return m_Reader->OpenRead(filename);
 }
 
+//
+ASDCP::Result_t
+ASDCP::MPEG2::MXFReader::OpenRead(EssenceProbe& probe) const
+{
+  m_Reader->AdoptFileReader(probe);
+  return OpenRead(probe.Filename());
+}
+
 //
 ASDCP::Result_t
 ASDCP::MPEG2::MXFReader::ReadFrame(ui32_t FrameNum, FrameBuffer& FrameBuf,
@@ -160,22 +160,252 @@ ASDCP::MD_to_CryptoInfo(CryptographicContext* InfoObj, WriterInfo& Info, const D
   return RESULT_OK;
 }
 
+//------------------------------------------------------------------------------------------
+// EssenceProbe
+
+// Upper bounds on the number of bytes a probe keeps in memory
+static const ui32_t s_ProbeHeaderCacheMax = 16 * Kumu::Megabyte;
+static const ui32_t s_ProbeRIPCacheMax = 4 * Kumu::Megabyte;
+
+// An IFileReader that keeps the bytes read from the start of the file while the
+// essence type is being determined, along with the RIP loaded by PreloadRIP(),
+// and serves later reads of those regions from memory. All other reads are
+// passed to the wrapped file. The cached bytes are released by the first read
+// that starts in the body of the file, by which time a TrackFileReader has
+// finished with them.
+class ProbeFileReader : public Kumu::IFileReader
+{
+  ASDCP::mem_ptr<Kumu::IFileReader> m_File;
+  mutable std::string m_Filename;
+  mutable mem_ptr<Kumu::ByteString> m_Head; // file bytes [0, m_Head->Length())
+  mutable mem_ptr<Kumu::ByteString> m_Tail; // file bytes [m_TailStart, m_TailStart + m_Tail->Length())
+  mutable Kumu::fpos_t m_TailStart;
+  mutable Kumu::fpos_t m_Position;          // the position reported by Tell()
+  mutable bool m_FileAtPosition;            // true if m_File's own file pointer is at m_Position
+  mutable bool m_Recording;                 // true while reads from the start of the file are kept
+
+  ASDCP_NO_COPY_CONSTRUCT(ProbeFileReader);
+  ProbeFileReader();
+
+  //
+  bool ReadCached(const Kumu::ByteString* cache, Kumu::fpos_t cache_start, byte_t* buf, ui32_t buf_len) const
+  {
+    if ( cache == 0 || m_Position < cache_start
+	 || m_Position + buf_len > cache_start + cache->Length() )
+      return false;
+
+    memcpy(buf, cache->RoData() + ( m_Position - cache_start ), buf_len);
+    return true;
+  }
+
+  // Appends bytes read at pos to m_Head if they continue it. Recording ends at
+  // the first read that does not, or when the cache limit is reached.
+  void Record(const byte_t* buf, Kumu::fpos_t pos, ui32_t length) const
+  {
+    ui32_t head_len = m_Head.empty() ? 0 : m_Head->Length();
+
+    if ( pos != head_len || head_len + length > s_ProbeHeaderCacheMax )
+      {
+	m_Recording = false;
+	return;
+      }
+
+    if ( m_Head.empty() )
+      m_Head = new Kumu::ByteString;
+
+    if ( m_Head->Capacity() < head_len + length
+	 && KM_FAILURE(m_Head->Capacity(Kumu::xmax(head_len + length, m_Head->Capacity() * 2))) )
+      {
+	m_Recording = false;
+	return;
+      }
+
+    m_Head->Append(buf, length);
+  }
+
+  //
+  void ReleaseCache() const
+  {
+    m_Head.set(0);
+    m_Tail.set(0);
+  }
+
+public:
+  ProbeFileReader(Kumu::IFileReader* file) :
+    m_File(file), m_TailStart(0), m_Position(0), m_FileAtPosition(true), m_Recording(true) {}
+  virtual ~ProbeFileReader() {}
+
+  // Loads the RIP into memory. If it cannot be located or read it is simply
+  // not cached; reading it later goes to the file.
+  void PreloadRIP()
+  {
+    int64_t file_size = m_File->Size();
+    byte_t rip_size_buf[MXF_BER_LENGTH];
+    ui32_t read_count = 0;
+
+    if ( file_size < (int64_t)( SMPTE_UL_LENGTH + MXF_BER_LENGTH ) )
+      return;
+
+    // the RIP length is in the last four bytes of the file
+    if ( KM_SUCCESS(m_File->Seek(file_size - MXF_BER_LENGTH))
+	 && KM_SUCCESS(m_File->Read(rip_size_buf, MXF_BER_LENGTH, &read_count))
+	 && read_count == MXF_BER_LENGTH )
+      {
+	ui32_t rip_size = KM_i32_BE(Kumu::cp2i<ui32_t>(rip_size_buf));
+
+	if ( rip_size >= MXF_BER_LENGTH && rip_size <= file_size && rip_size <= s_ProbeRIPCacheMax )
+	  {
+	    mem_ptr<Kumu::ByteString> tmp_cache(new Kumu::ByteString);
+
+	    if ( KM_SUCCESS(tmp_cache->Capacity(rip_size))
+		 && KM_SUCCESS(m_File->Seek(file_size - rip_size))
+		 && KM_SUCCESS(m_File->Read(tmp_cache->Data(), rip_size, &read_count))
+		 && read_count == rip_size )
+	      {
+		tmp_cache->Length(rip_size);
+		m_Tail = tmp_cache.get();
+		tmp_cache.release();
+		m_TailStart = file_size - rip_size;
+	      }
+	  }
+      }
+
+    m_FileAtPosition = false;
+    m_Position = 0;
+  }
+
+  // Ends the recording of reads from the start of the file.
+  void StopRecording() { m_Recording = false; }
+
+  //
+  virtual Result_t OpenRead(const std::string& filename) const
+  {
+    if ( m_File->IsOpen() && filename == m_Filename )
+      {
+	m_Position = 0;
+	m_FileAtPosition = false;
+	return RESULT_OK;
+      }
+
+    ReleaseCache();
+    m_Filename = filename;
+    m_Position = 0;
+    m_FileAtPosition = true;
+    return m_File->OpenRead(filename);
+  }
+
+  //
+  virtual Result_t Close() const
+  {
+    ReleaseCache();
+    m_Filename.clear();
+    return m_File->Close();
+  }
+
+  virtual int64_t Size() const { return m_File->Size(); }
+  virtual bool IsOpen() const { return m_File->IsOpen(); }
+
+  //
+  virtual Result_t Seek(Kumu::fpos_t position, Kumu::SeekPos_t whence) const
+  {
+    if ( ! m_File->IsOpen() )
+      return Kumu::RESULT_STATE;
+
+    if ( whence == Kumu::SP_POS )
+      position += m_Position;
+    else if ( whence == Kumu::SP_END )
+      position += m_File->Size();
+
+    if ( position < 0 )
+      return Kumu::RESULT_READFAIL;
+
+    m_Position = position;
+    m_FileAtPosition = false;
+    return RESULT_OK;
+  }
+
+  //
+  virtual Result_t Tell(Kumu::fpos_t* pos) const
+  {
+    KM_TEST_NULL_L(pos);
+
+    if ( ! m_File->IsOpen() )
+      return Kumu::RESULT_STATE;
+
+    *pos = m_Position;
+    return RESULT_OK;
+  }
+
+  //
+  virtual Result_t Read(byte_t* buf, ui32_t buf_len, ui32_t* read_count) const
+  {
+    KM_TEST_NULL_L(buf);
+
+    if ( ! m_File->IsOpen() )
+      return Kumu::RESULT_STATE;
+
+    if ( ReadCached(m_Head, 0, buf, buf_len) || ReadCached(m_Tail, m_TailStart, buf, buf_len) )
+      {
+	m_Position += buf_len;
+
+	if ( read_count != 0 )
+	  *read_count = buf_len;
+
+	return RESULT_OK;
+      }
+
+    if ( ! m_Recording && ( m_Head.empty() || m_Position >= (Kumu::fpos_t)m_Head->Length() ) )
+      ReleaseCache();
+
+    Result_t result = RESULT_OK;
+
+    if ( ! m_FileAtPosition )
+      result = m_File->Seek(m_Position);
+
+    ui32_t tmp_count = 0;
+
+    if ( KM_SUCCESS(result) )
+      result = m_File->Read(buf, buf_len, &tmp_count);
+
+    if ( m_Recording && KM_SUCCESS(result) )
+      Record(buf, m_Position, tmp_count);
+
+    m_Position += tmp_count;
+    m_FileAtPosition = KM_SUCCESS(result);
+
+    if ( read_count != 0 )
+      *read_count = tmp_count;
+
+    return result;
+  }
+};
+
 //
-//
-ASDCP::Result_t
-ASDCP::EssenceType(const std::string& filename, EssenceType_t& type, const Kumu::IFileReaderFactory& fileReaderFactory)
+class ASDCP::EssenceProbe::h__EssenceProbe
+{
+  ASDCP_NO_COPY_CONSTRUCT(h__EssenceProbe);
+
+public:
+  std::string m_Filename;
+  EssenceType_t m_Type;
+  mem_ptr<ProbeFileReader> m_Reader;
+
+  h__EssenceProbe() : m_Type(ESS_UNKNOWN) {}
+};
+
+// Determine the essence type of the MXF file open in Reader.
+static Result_t
+s_EssenceTypeFromFile(const Kumu::IFileReader& Reader, EssenceType_t& type)
 {
   const Dictionary* m_Dict = &DefaultCompositeDict();
   InterchangeObject* md_object = 0;
 
   assert(m_Dict);
-  ASDCP::mem_ptr<Kumu::IFileReader> Reader(fileReaderFactory.CreateFileReader());
   OP1aHeader TestHeader(m_Dict);
+  TestHeader.SetLazyMode(true); // only a handful of descriptors are examined below
+  TestHeader.SetArenaMode(true); // the sets are released together when TestHeader goes out of scope
 
-  Result_t result = Reader->OpenRead(filename);
-
-  if ( ASDCP_SUCCESS(result) )
-    result = TestHeader.InitFromFile(*Reader); // test UL and OP
+  Result_t result = TestHeader.InitFromFile(Reader); // test UL and OP
 
   if ( ASDCP_SUCCESS(result) )
     {
@@ -296,6 +526,94 @@ ASDCP::EssenceType(const std::string& filename, EssenceType_t& type, const Kumu:
   return result;
 }
 
+//
+ASDCP::Result_t
+ASDCP::EssenceType(const std::string& filename, EssenceType_t& type, const Kumu::IFileReaderFactory& fileReaderFactory)
+{
+  ASDCP::mem_ptr<Kumu::IFileReader> Reader(fileReaderFactory.CreateFileReader());
+  Result_t result = Reader->OpenRead(filename);
+
+  if ( ASDCP_SUCCESS(result) )
+    result = s_EssenceTypeFromFile(*Reader, type);
+
+  return result;
+}
+
+//
+ASDCP::Result_t
+ASDCP::EssenceType(const std::string& filename, EssenceType_t& type,
+		   const Kumu::IFileReaderFactory& fileReaderFactory, EssenceProbe& probe)
+{
+  Result_t result = probe.OpenRead(filename, fileReaderFactory);
+
+  if ( ASDCP_SUCCESS(result) )
+    type = probe.Type();
+
+  return result;
+}
+
+//
+ASDCP::EssenceProbe::EssenceProbe()
+{
+  m_Probe = new h__EssenceProbe;
+}
+
+ASDCP::EssenceProbe::~EssenceProbe() {}
+
+//
+ASDCP::Result_t
+ASDCP::EssenceProbe::OpenRead(const std::string& filename, const Kumu::IFileReaderFactory& fileReaderFactory)
+{
+  Close();
+  m_Probe->m_Reader = new ProbeFileReader(fileReaderFactory.CreateFileReader());
+  Result_t result = m_Probe->m_Reader->OpenRead(filename);
+
+  if ( ASDCP_SUCCESS(result) )
+    {
+      m_Probe->m_Filename = filename;
+      m_Probe->m_Reader->PreloadRIP();
+      result = s_EssenceTypeFromFile(*m_Probe->m_Reader, m_Probe->m_Type);
+      m_Probe->m_Reader->StopRecording();
+    }
+
+  if ( ASDCP_FAILURE(result) )
+    Close();
+
+  return result;
+}
+
+//
+const std::string&
+ASDCP::EssenceProbe::Filename() const
+{
+  return m_Probe->m_Filename;
+}
+
+//
+ASDCP::EssenceType_t
+ASDCP::EssenceProbe::Type() const
+{
+  return m_Probe->m_Type;
+}
+
+//
+Kumu::IFileReader*
+ASDCP::EssenceProbe::ReleaseFileReader()
+{
+  Kumu::IFileReader* reader = m_Probe->m_Reader.get();
+  m_Probe->m_Reader.release();
+  return reader;
+}
+
+//
+void
+ASDCP::EssenceProbe::Close()
+{
+  m_Probe->m_Reader.set(0);
+  m_Probe->m_Filename.clear();
+  m_Probe->m_Type = ESS_UNKNOWN;
+}
+
 //
 static bool
 string_is_xml(const ASDCP::FrameBuffer& buffer)
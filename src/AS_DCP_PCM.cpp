@@ -435,6 +435,14 @@ ASDCP::PCM::MXFReader::OpenRead(const std::string& filename) const
   return m_Reader->OpenRead(filename);
 }
 
+//
+ASDCP::Result_t
+ASDCP::PCM::MXFReader::OpenRead(EssenceProbe& probe) const
+{
+  m_Reader->AdoptFileReader(probe);
+  return OpenRead(probe.Filename());
+}
+
 // Reads a frame of essence from the MXF file. If the optional AESEncContext
 // argument is present, the essence is decrypted after reading. If the MXF
 // file is encrypted and the AESDecContext argument is NULL, the frame buffer
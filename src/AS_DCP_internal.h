@@ -164,6 +164,13 @@ extern MXF::RIP *g_RIP;
   Result_t PCM_ADesc_to_MD(PCM::AudioDescriptor& ADesc, ASDCP::MXF::WaveAudioDescriptor* ADescObj);
   Result_t MD_to_PCM_ADesc(ASDCP::MXF::WaveAudioDescriptor* ADescObj, PCM::AudioDescriptor& ADesc);
 
+  // Scale little-endian 32-bit float samples in [-1.0, 1.0) to packed 24-bit samples,
+  // rounding to nearest (ties to even) and clipping. TPDF dither is added if
+  // dither_state is not NULL. The _Scalar version never uses the vector kernel;
+  // both give the same output for the same input and dither state.
+  void PCM_Float_to_24(const byte_t* src, ui32_t sample_count, byte_t* dst, ui32_t* dither_state);
+  void PCM_Float_to_24_Scalar(const byte_t* src, ui32_t sample_count, byte_t* dst, ui32_t* dither_state);
+
   void     AddDmsCrypt(Partition& HeaderPart, SourcePackage& Package,
 		       WriterInfo& Descr, const UL& WrappingUL, const Dictionary *Dict);
 
@@ -185,6 +192,19 @@ extern MXF::RIP *g_RIP;
 			     const ui32_t& MinEssenceElementBerLength,
 			     AESEncContext* Ctx, HMACContext* HMAC);
 
+  // writes a plaintext KLV packet whose value is copied from the reader's file position
+  Result_t Write_KLV_PacketFromFile(Kumu::FileWriter& File, ui64_t& StreamOffset, const Kumu::IFileReader& Reader,
+				    ui64_t length, const byte_t* EssenceUL, const ui32_t& MinEssenceElementBerLength);
+
+  // the most packets Write_KLV_Packets() will gather into one write (two iovec entries each)
+  const ui32_t KLVPacketBatchSize = 16;
+
+  // writes up to KLVPacketBatchSize plaintext KLV packets with a single gather write,
+  // storing the stream offset of each packet in PacketOffsets
+  Result_t Write_KLV_Packets(Kumu::FileWriter& File, ui64_t& StreamOffset, const ASDCP::FrameBuffer* const* FrameBufs,
+			     ui32_t FrameCount, const byte_t* EssenceUL, const ui32_t& MinEssenceElementBerLength,
+			     ui64_t* PacketOffsets);
+
   //
  class KLReader : public ASDCP::KLVPacket
     {
@@ -239,6 +259,23 @@ extern MXF::RIP *g_RIP;
 
 	const MXF::RIP& GetRIP() const { return m_RIP; }
 
+	// Takes over the open file held by the probe. OpenMXFRead() called with
+	// the probe's filename will then read the RIP and header from the bytes
+	// cached by the probe. Has no effect if this reader already has a file open.
+	void AdoptFileReader(EssenceProbe& probe)
+	{
+	  if ( ! m_File->IsOpen() )
+	    {
+	      Kumu::IFileReader* reader = probe.ReleaseFileReader();
+
+	      if ( reader != 0 )
+		{
+		  delete m_File;
+		  m_File = reader;
+		}
+	    }
+	}
+
 	//
 	Result_t OpenMXFRead(const std::string& filename)
 	{
@@ -417,14 +454,14 @@ extern MXF::RIP *g_RIP;
 	  return RESULT_OK;
 	}
 
-	// Reads a Generic Stream Partition payload. Returns RESULT_FORMAT if the SID is
-	// not present in the  RIP, or if the actual partition at ByteOffset does not have
-	// a matching BodySID value. Encryption is not currently supported.
-	Result_t ReadGenericStreamPartitionPayload(const ui32_t sid, ASDCP::FrameBuffer& frame_buf,
-						   AESDecContext* Ctx, HMACContext* HMAC)
+	// Positions the file at the payload of a Generic Stream Partition and sets
+	// sequence to the value needed to complete the HMAC. Returns RESULT_NOT_FOUND
+	// if the SID is not present in the RIP, or RESULT_FORMAT if the actual partition
+	// at ByteOffset does not have a matching BodySID value.
+	Result_t SeekGenericStreamPartitionPayload(const ui32_t sid, ui32_t& sequence, ui64_t& partition_size)
 	{
 	  Kumu::fpos_t start_offset = 0, end_offset = 0;
-	  ui32_t sequence = 0;
+	  sequence = 0;
 
 	  // locate SID, record the offset
 	  // Count the sequence length in because this is the sequence
@@ -455,35 +492,81 @@ extern MXF::RIP *g_RIP;
 	      return RESULT_NOT_FOUND;
 	    }
 
-	  // Read the Partition header and then read the payload.
+	  partition_size = end_offset - start_offset;
+
+	  // the next frame read must seek
+	  m_LastPosition = 0;
+
+	  // Read the Partition header
 	  Result_t result = m_File->Seek(start_offset);
 
 	  if ( KM_SUCCESS(result) )
 	    {
-	      result = frame_buf.Capacity(end_offset-start_offset);
+	      ASDCP::MXF::Partition GSPart(m_Dict);
+	      result = GSPart.InitFromFile(*m_File);
+
+	      // check the SID
+	      if ( KM_SUCCESS(result) && GSPart.BodySID != sid )
+		{
+		  DefaultLogSink().Error("Generic stream partition Body SID differs: %u\n", sid);
+		  result = RESULT_FORMAT;
+		}
+	    }
+
+	  return result;
+	}
+
+	// Reads a Generic Stream Partition payload. Returns RESULT_FORMAT if the SID is
+	// not present in the  RIP, or if the actual partition at ByteOffset does not have
+	// a matching BodySID value. Encryption is not currently supported.
+	Result_t ReadGenericStreamPartitionPayload(const ui32_t sid, ASDCP::FrameBuffer& frame_buf,
+						   AESDecContext* Ctx, HMACContext* HMAC)
+	{
+	  ui32_t sequence = 0;
+	  ui64_t partition_size = 0;
+	  Result_t result = SeekGenericStreamPartitionPayload(sid, sequence, partition_size);
+
+	  if ( KM_SUCCESS(result) )
+	    {
+	      result = frame_buf.Capacity(partition_size);
 	    }
-    
+
 	  if ( KM_SUCCESS(result) )
 	    {
-	      // read the partition header
-	      ASDCP::MXF::Partition GSPart(m_Dict);
-          result = GSPart.InitFromFile(*m_File);
+	      result = ReadEKLVPacket(0, sequence, frame_buf, m_Dict->ul(MDD_GenericStream_DataElement), Ctx, HMAC);
+	    }
 
-	      if ( KM_SUCCESS(result) )
+	  return result;
+	}
+
+	// Copies a plaintext Generic Stream Partition payload to the writer's file
+	// position without reading it into memory. Returns RESULT_FORMAT if the
+	// payload is encrypted; use ReadGenericStreamPartitionPayload() instead.
+	Result_t CopyGenericStreamPartitionPayload(const ui32_t sid, Kumu::FileWriter& writer)
+	{
+	  ui32_t sequence = 0;
+	  ui64_t partition_size = 0;
+	  Result_t result = SeekGenericStreamPartitionPayload(sid, sequence, partition_size);
+	  KLReader Reader;
+
+	  if ( KM_SUCCESS(result) )
+	    {
+	      result = Reader.ReadKLFromFile(*m_File);
+	    }
+
+	  if ( KM_SUCCESS(result) )
+	    {
+	      if ( ! UL(Reader.Key()).MatchIgnoreStream(m_Dict->ul(MDD_GenericStream_DataElement)) )
+		{
+		  DefaultLogSink().Error("Generic stream payload is not a plaintext GenericStream_DataElement.\n");
+		  result = RESULT_FORMAT;
+		}
+	      else
 		{
-		  // check the SID
-		  if ( GSPart.BodySID != sid )
-		    {
-		      DefaultLogSink().Error("Generic stream partition Body SID differs: %s\n", sid);
-		      result = RESULT_FORMAT;
-		    }
-		  else
-		    {
-		      result = ReadEKLVPacket(0, sequence, frame_buf, m_Dict->ul(MDD_GenericStream_DataElement), Ctx, HMAC);
-		    }
+		  result = writer.WriteFromFile(*m_File, Reader.Length());
 		}
 	    }
-  
+
 	  return result;
 	}
 
@@ -966,6 +1049,13 @@ extern MXF::RIP *g_RIP;
       Result_t WriteEKLVPacket(const ASDCP::FrameBuffer& FrameBuf,const byte_t* EssenceUL,
 			       const ui32_t& MinEssenceElementBerLength,
 			       AESEncContext* Ctx, HMACContext* HMAC);
+
+      // Writes each frame as WriteEKLVPacket() does and pushes a VBR index entry
+      // holding only its stream offset. Plaintext packets are gathered into writes
+      // of up to KLVPacketBatchSize packets.
+      Result_t WriteIndexedEKLVPackets(const ASDCP::FrameBuffer* const* FrameBufs, ui32_t FrameCount,
+				       const byte_t* EssenceUL, const ui32_t& MinEssenceElementBerLength,
+				       AESEncContext* Ctx, HMACContext* HMAC);
       Result_t WriteASDCPFooter();
     };
 
@@ -172,37 +172,326 @@ ASDCP::AtmosSMPTEDict()
 //------------------------------------------------------------------------------------------
 //
 
-ASDCP::Dictionary::Dictionary() {}
+ASDCP::Dictionary::Dictionary()
+{
+  memset(m_md_present, 0, sizeof(m_md_present));
+  memset(m_md_exact_index, 0, sizeof(m_md_exact_index));
+  memset(m_md_any_version_index, 0, sizeof(m_md_any_version_index));
+  memset(m_md_symbol_index, 0, sizeof(m_md_symbol_index));
+}
+
 ASDCP::Dictionary::~Dictionary() {}
 
 //
+static bool
+s_has_placeholder(const byte_t* ul)
+{
+  for ( ui32_t i = 4; i < ASDCP::SMPTE_UL_LENGTH; ++i )
+    {
+      if ( i != 7 && ul[i] == 0x7f )
+	return true;
+    }
+
+  return false;
+}
+
+//
+static bool
+s_match_ignore_stream(const byte_t* lhs, const byte_t* rhs)
+{
+  return memcmp(lhs, rhs, 7) == 0 && memcmp(lhs + 8, rhs + 8, 7) == 0;
+}
+
+// FNV-1a, as used for the UL hashes
+static ui32_t
+s_hash_symbol(const char* str)
+{
+  ui32_t h = 2166136261U;
+
+  for ( ; *str != 0; ++str )
+    h = ( h ^ (byte_t)*str ) * 16777619U;
+
+  return h;
+}
+
+// The static table is copied in a single pass and indexed once; entries are
+// not registered one at a time through AddEntry().
 void
 ASDCP::Dictionary::Init()
 {
-  m_md_lookup.clear();
-  memset(m_MDD_Table, 0, sizeof(m_MDD_Table));
+  assert(IndexSize >= 2 * (ui32_t)ASDCP::MDD_Max);
+  memcpy(m_MDD_Table, s_MDD_Table, sizeof(m_MDD_Table));
+
+  for ( ui32_t x = 0; x < (ui32_t)ASDCP::MDD_Max; ++x )
+    {
+      memcpy(m_md_keys[x], s_MDD_Table[x].ul, SMPTE_UL_LENGTH);
+      m_md_present[x] = true;
+    }
+
+  static const MDD_t deprecated_types[] = {
+    MDD_PartitionMetadata_IndexSID_DEPRECATED,  // 30
+    MDD_PartitionMetadata_BodySID_DEPRECATED,  // 32
+    MDD_PartitionMetadata_OperationalPattern_DEPRECATED,  // 33
+    MDD_PartitionMetadata_EssenceContainers_DEPRECATED,  // 34
+    MDD_IndexTableSegmentBase_IndexSID_DEPRECATED,  // 56
+    MDD_IndexTableSegmentBase_BodySID_DEPRECATED,  // 57
+    MDD_PartitionArray_RandomIndexMetadata_BodySID_DEPRECATED,  // 73
+    MDD_Preface_OperationalPattern_DEPRECATED,  // 84
+    MDD_Preface_EssenceContainers_DEPRECATED,  // 85
+    MDD_EssenceContainerData_IndexSID_DEPRECATED,  // 103
+    MDD_EssenceContainerData_BodySID_DEPRECATED,  // 104
+    MDD_TimedTextResourceSubDescriptor_EssenceStreamID_DEPRECATED, // 264
+    MDD_DMSegment_DataDefinition_DEPRECATED, // 266
+    MDD_DMSegment_Duration_DEPRECATED, // 267
+  };
+
+  for ( ui32_t i = 0; i < sizeof(deprecated_types) / sizeof(deprecated_types[0]); ++i )
+    {
+      memset(&m_MDD_Table[deprecated_types[i]], 0, sizeof(MDDEntry));
+      m_md_present[deprecated_types[i]] = false;
+    }
+
+  RebuildIndex();
+}
+
+// Add the entry at index to the hash indexes. The first entry registered for
+// a given UL or symbol wins, as with the map-based lookup this replaces.
+void
+ASDCP::Dictionary::IndexEntry(ui32_t index)
+{
+  const byte_t* key = m_md_keys[index];
+  const ui32_t mask = IndexSize - 1;
+  ui32_t slot = HashUL(key) & mask;
+
+  while ( m_md_exact_index[slot] != 0 )
+    {
+      if ( memcmp(m_md_keys[m_md_exact_index[slot] - 1], key, SMPTE_UL_LENGTH) == 0 )
+	break;
+
+      slot = ( slot + 1 ) & mask;
+    }
+
+  if ( m_md_exact_index[slot] == 0 )
+    m_md_exact_index[slot] = (ui16_t)( index + 1 );
+
+  slot = HashULIgnoreStream(key) & mask;
+
+  while ( m_md_any_version_index[slot] != 0 )
+    {
+      const byte_t* other = m_md_keys[m_md_any_version_index[slot] - 1];
+
+      if ( s_match_ignore_stream(other, key) )
+	{
+	  if ( memcmp(key, other, SMPTE_UL_LENGTH) < 0 )
+	    m_md_any_version_index[slot] = (ui16_t)( index + 1 );
+
+	  break;
+	}
+
+      slot = ( slot + 1 ) & mask;
+    }
+
+  if ( m_md_any_version_index[slot] == 0 )
+    m_md_any_version_index[slot] = (ui16_t)( index + 1 );
+
+  const char* name = m_MDD_Table[index].name;
+
+  if ( name != 0 )
+    {
+      slot = s_hash_symbol(name) & mask;
+
+      while ( m_md_symbol_index[slot] != 0 )
+	{
+	  if ( strcmp(m_MDD_Table[m_md_symbol_index[slot] - 1].name, name) == 0 )
+	    break;
+
+	  slot = ( slot + 1 ) & mask;
+	}
+
+      if ( m_md_symbol_index[slot] == 0 )
+	m_md_symbol_index[slot] = (ui16_t)( index + 1 );
+    }
+
+  if ( s_has_placeholder(key) )
+    {
+      std::vector<ui16_t>::iterator i = m_md_placeholder_entries.begin();
+
+      while ( i != m_md_placeholder_entries.end() && memcmp(m_md_keys[*i], key, SMPTE_UL_LENGTH) < 0 )
+	++i;
+
+      if ( i == m_md_placeholder_entries.end() || *i != index )
+	m_md_placeholder_entries.insert(i, (ui16_t)index);
+    }
+}
+
+// Clear a slot of a linear-probed index using backward-shift deletion, so that
+// the probe sequences of the entries that follow it stay intact.
+template <class HashFn>
+static void
+s_remove_slot(ui16_t* index_table, ui32_t mask, ui32_t slot, const HashFn& hash_fn)
+{
+  ui32_t next = slot;
+
+  for (;;)
+    {
+      next = ( next + 1 ) & mask;
+
+      if ( index_table[next] == 0 )
+	break;
+
+      ui32_t home = hash_fn(index_table[next] - 1) & mask;
+
+      // move the entry back unless its home slot lies cyclically in (slot, next]
+      bool stays = ( slot <= next ) ? ( slot < home && home <= next ) : ( slot < home || home <= next );
+
+      if ( ! stays )
+	{
+	  index_table[slot] = index_table[next];
+	  slot = next;
+	}
+    }
+
+  index_table[slot] = 0;
+}
+
+// Returns the slot holding index, probing from its home slot, or -1.
+static i32_t
+s_find_slot(const ui16_t* index_table, ui32_t mask, ui32_t hash, ui32_t index)
+{
+  ui32_t slot = hash & mask;
+
+  while ( index_table[slot] != 0 )
+    {
+      if ( index_table[slot] == index + 1 )
+	return slot;
+
+      slot = ( slot + 1 ) & mask;
+    }
+
+  return -1;
+}
+
+//
+struct ExactHash
+{
+  const byte_t (*keys)[ASDCP::SMPTE_UL_LENGTH];
+  ui32_t operator()(ui32_t index) const { return ASDCP::HashUL(keys[index]); }
+};
+
+struct AnyVersionHash
+{
+  const byte_t (*keys)[ASDCP::SMPTE_UL_LENGTH];
+  ui32_t operator()(ui32_t index) const { return ASDCP::HashULIgnoreStream(keys[index]); }
+};
+
+struct SymbolHash
+{
+  const ASDCP::MDDEntry* table;
+  ui32_t operator()(ui32_t index) const { return s_hash_symbol(table[index].name); }
+};
+
+// Remove the entry at index from the hash indexes. It must still be present in
+// m_MDD_Table. Any other entry that shared its UL or symbol is indexed again.
+void
+ASDCP::Dictionary::UnindexEntry(ui32_t index)
+{
+  const ui32_t mask = IndexSize - 1;
+  const byte_t* key = m_md_keys[index];
+  const char* name = m_MDD_Table[index].name;
+  ExactHash exact_fn = { m_md_keys };
+  i32_t slot = s_find_slot(m_md_exact_index, mask, exact_fn(index), index);
+
+  if ( slot >= 0 )
+    s_remove_slot(m_md_exact_index, mask, slot, exact_fn);
+
+  AnyVersionHash any_version_fn = { m_md_keys };
+  slot = s_find_slot(m_md_any_version_index, mask, any_version_fn(index), index);
+
+  if ( slot >= 0 )
+    s_remove_slot(m_md_any_version_index, mask, slot, any_version_fn);
+
+  if ( name != 0 )
+    {
+      SymbolHash symbol_fn = { m_MDD_Table };
+      slot = s_find_slot(m_md_symbol_index, mask, symbol_fn(index), index);
+
+      if ( slot >= 0 )
+	s_remove_slot(m_md_symbol_index, mask, slot, symbol_fn);
+    }
+
+  std::vector<ui16_t>::iterator pi = m_md_placeholder_entries.begin();
+
+  while ( pi != m_md_placeholder_entries.end() )
+    {
+      if ( *pi == index )
+	pi = m_md_placeholder_entries.erase(pi);
+      else
+	++pi;
+    }
+
+  for ( ui32_t x = 0; x < (ui32_t)ASDCP::MDD_Max; ++x )
+    {
+      if ( x != index && m_md_present[x]
+	   && ( s_match_ignore_stream(m_md_keys[x], key)
+		|| ( name != 0 && m_MDD_Table[x].name != 0 && strcmp(m_MDD_Table[x].name, name) == 0 ) ) )
+	IndexEntry(x);
+    }
+}
+
+//
+void
+ASDCP::Dictionary::RebuildIndex()
+{
+  memset(m_md_exact_index, 0, sizeof(m_md_exact_index));
+  memset(m_md_any_version_index, 0, sizeof(m_md_any_version_index));
+  memset(m_md_symbol_index, 0, sizeof(m_md_symbol_index));
+  m_md_placeholder_entries.clear();
 
   for ( ui32_t x = 0; x < (ui32_t)ASDCP::MDD_Max; ++x )
     {
-      if ( x == MDD_PartitionMetadata_IndexSID_DEPRECATED  // 30
-	   || x == MDD_PartitionMetadata_BodySID_DEPRECATED  // 32
-	   || x == MDD_PartitionMetadata_OperationalPattern_DEPRECATED  // 33
-	   || x == MDD_PartitionMetadata_EssenceContainers_DEPRECATED  // 34
-	   || x == MDD_IndexTableSegmentBase_IndexSID_DEPRECATED  // 56
-	   || x == MDD_IndexTableSegmentBase_BodySID_DEPRECATED  // 57
-	   || x == MDD_PartitionArray_RandomIndexMetadata_BodySID_DEPRECATED  // 73
-	   || x == MDD_Preface_OperationalPattern_DEPRECATED  // 84
-	   || x == MDD_Preface_EssenceContainers_DEPRECATED  // 85
-	   || x == MDD_EssenceContainerData_IndexSID_DEPRECATED  // 103
-	   || x == MDD_EssenceContainerData_BodySID_DEPRECATED  // 104
-	   || x == MDD_TimedTextResourceSubDescriptor_EssenceStreamID_DEPRECATED // 264
-	   || x == MDD_DMSegment_DataDefinition_DEPRECATED // 266
-	   || x == MDD_DMSegment_Duration_DEPRECATED // 267
-	   )
-	continue;
-
-      AddEntry(s_MDD_Table[x], x);
+      if ( m_md_present[x] )
+	IndexEntry(x);
+    }
+}
+
+//
+i32_t
+ASDCP::Dictionary::LookupExact(const byte_t* ul_buf) const
+{
+  const ui32_t mask = IndexSize - 1;
+  ui32_t slot = HashUL(ul_buf) & mask;
+
+  while ( m_md_exact_index[slot] != 0 )
+    {
+      ui32_t index = m_md_exact_index[slot] - 1;
+
+      if ( memcmp(m_md_keys[index], ul_buf, SMPTE_UL_LENGTH) == 0 )
+	return index;
+
+      slot = ( slot + 1 ) & mask;
+    }
+
+  return -1;
+}
+
+//
+i32_t
+ASDCP::Dictionary::LookupAnyVersion(const byte_t* ul_buf) const
+{
+  const ui32_t mask = IndexSize - 1;
+  ui32_t slot = HashULIgnoreStream(ul_buf) & mask;
+
+  while ( m_md_any_version_index[slot] != 0 )
+    {
+      ui32_t index = m_md_any_version_index[slot] - 1;
+
+      if ( s_match_ignore_stream(m_md_keys[index], ul_buf) )
+	return index;
+
+      slot = ( slot + 1 ) & mask;
     }
+
+  return -1;
 }
 
 //
@@ -217,34 +506,31 @@ ASDCP::Dictionary::AddEntry(const MDDEntry& Entry, ui32_t index)
 
   bool result = true;
   // is this index already there?
-  std::map<ui32_t, ASDCP::UL>::iterator rii = m_md_rev_lookup.find(index);
-
-  if ( rii != m_md_rev_lookup.end() )
+  if ( m_md_present[index] )
     {
       DeleteEntry(index);
       result = false;
     }
 
-  UL TmpUL(Entry.ul);
-
 #define MDD_AUTHORING_MODE
 #ifdef MDD_AUTHORING_MODE
   char buf[64];
-  std::map<ASDCP::UL, ui32_t>::iterator ii = m_md_lookup.find(TmpUL);
-  if ( ii != m_md_lookup.end() )
+  i32_t other = LookupExact(Entry.ul);
+  if ( other >= 0 )
     {
+      UL TmpUL(Entry.ul);
       Kumu::DefaultLogSink().Warn("Duplicate Dictionary item: %s (%02x, %02x) %s | (%02x, %02x) %s\n",
 	      TmpUL.EncodeString(buf, 64),
-	      m_MDD_Table[ii->second].tag.a, m_MDD_Table[ii->second].tag.b,
-	      m_MDD_Table[ii->second].name,
+	      m_MDD_Table[other].tag.a, m_MDD_Table[other].tag.b,
+	      m_MDD_Table[other].name,
 	      Entry.tag.a, Entry.tag.b, Entry.name);
     }
 #endif
 
-  m_md_lookup.insert(std::map<UL, ui32_t>::value_type(TmpUL, index));
-  m_md_rev_lookup.insert(std::map<ui32_t, UL>::value_type(index, TmpUL));
-  m_md_sym_lookup.insert(std::map<std::string, ui32_t>::value_type(Entry.name, index));
+  memcpy(m_md_keys[index], Entry.ul, SMPTE_UL_LENGTH);
+  m_md_present[index] = true;
   m_MDD_Table[index] = Entry;
+  IndexEntry(index);
 
   return result;
 }
@@ -253,17 +539,13 @@ ASDCP::Dictionary::AddEntry(const MDDEntry& Entry, ui32_t index)
 bool
 ASDCP::Dictionary::DeleteEntry(ui32_t index)
 {
-  std::map<ui32_t, ASDCP::UL>::iterator rii = m_md_rev_lookup.find(index);
-  if ( rii != m_md_rev_lookup.end() )
+  if ( index < (ui32_t)MDD_Max && m_md_present[index] )
     {
-      std::map<ASDCP::UL, ui32_t>::iterator ii = m_md_lookup.find(rii->second);
-      assert(ii != m_md_lookup.end());
-
       MDDEntry NilEntry;
       memset(&NilEntry, 0, sizeof(NilEntry));
 
-      m_md_lookup.erase(ii);
-      m_md_rev_lookup.erase(rii);
+      UnindexEntry(index);
+      m_md_present[index] = false;
       m_MDD_Table[index] = NilEntry;
       return true;
     }
@@ -276,9 +558,8 @@ const ASDCP::MDDEntry&
 ASDCP::Dictionary::Type(MDD_t type_id) const
 {
   assert(m_MDD_Table[0].name[0]);
-  std::map<ui32_t, ASDCP::UL>::const_iterator rii = m_md_rev_lookup.find(type_id);
 
-  if ( rii == m_md_rev_lookup.end() )
+  if ( ! m_md_present[type_id] )
     Kumu::DefaultLogSink().Warn("UL Dictionary: unknown UL type_id: %d\n", type_id);
 
   return m_MDD_Table[type_id];
@@ -289,56 +570,49 @@ ASDCP::MDDEntry&
 ASDCP::Dictionary::MutableType(MDD_t type_id)
 {
   assert(m_MDD_Table[0].name[0]);
-  std::map<ui32_t, ASDCP::UL>::iterator rii = m_md_rev_lookup.find(type_id);
 
-  if ( rii == m_md_rev_lookup.end() )
+  if ( ! m_md_present[type_id] )
     Kumu::DefaultLogSink().Warn("UL Dictionary: unknown UL type_id: %d\n", type_id);
 
   return m_MDD_Table[type_id];
 }
 
-//
+// An exact match is preferred. Failing that, the lowest registered UL that
+// matches with the version and stream number ignored, or that matches a 0x7f
+// placeholder entry, is returned.
 const ASDCP::MDDEntry*
 ASDCP::Dictionary::FindULAnyVersion(const byte_t* ul_buf) const
 {
   assert(m_MDD_Table[0].name[0]);
-  byte_t search_ul[SMPTE_UL_LENGTH];
-  memcpy(search_ul, ul_buf, SMPTE_UL_LENGTH);
-  memset(search_ul+7, 0, SMPTE_UL_LENGTH-7);
+  i32_t index = LookupExact(ul_buf);
 
-  UL target(ul_buf);
-  const ASDCP::MDDEntry *found_entry = 0;
-
-  std::map<UL, ui32_t>::const_iterator lower = m_md_lookup.lower_bound(UL(search_ul));
-
-  for ( ; lower != m_md_lookup.end(); ++lower )
+  if ( index < 0 )
     {
-      if ( lower->first.MatchExact(target) )
-	{
-	  found_entry = &m_MDD_Table[lower->second];
-	  break;
-	}
-      else if ( found_entry == 0 && lower->first.MatchIgnoreStream(target) )
-	{
-	  found_entry = &m_MDD_Table[lower->second];
-	}
-      else if ( found_entry == 0 && lower->first.MatchIgnorePlaceholder(target) )
-	{
-	  found_entry = &m_MDD_Table[lower->second];
-	}
-      else if ( found_entry != 0 && ! lower->first.MatchIgnoreStream(target) )
+      UL target(ul_buf);
+      index = LookupAnyVersion(ul_buf);
+      std::vector<ui16_t>::const_iterator i;
+
+      for ( i = m_md_placeholder_entries.begin(); i != m_md_placeholder_entries.end(); ++i )
 	{
-	  break;
+	  if ( UL(m_md_keys[*i]).MatchIgnorePlaceholder(target) )
+	    {
+	      if ( index < 0 || memcmp(m_md_keys[*i], m_md_keys[index], SMPTE_UL_LENGTH) < 0 )
+		index = *i;
+
+	      break;
+	    }
 	}
     }
 
-  if ( found_entry == 0 )
+  if ( index < 0 )
     {
       char buf[64];
-      Kumu::DefaultLogSink().Warn("UL Dictionary: unknown UL: %s\n", target.EncodeString(buf, 64));
+      UL tmp_ul(ul_buf);
+      Kumu::DefaultLogSink().Warn("UL Dictionary: unknown UL: %s\n", tmp_ul.EncodeString(buf, 64));
+      return 0;
     }
 
-  return found_entry;
+  return &m_MDD_Table[index];
 }
 
 //
@@ -346,9 +620,9 @@ const ASDCP::MDDEntry*
 ASDCP::Dictionary::FindULExact(const byte_t* ul_buf) const
 {
   assert(m_MDD_Table[0].name[0]);
-  std::map<UL, ui32_t>::const_iterator i = m_md_lookup.find(UL(ul_buf));
-  
-  if ( i == m_md_lookup.end() )
+  i32_t index = LookupExact(ul_buf);
+
+  if ( index < 0 )
     {
       char buf[64];
       UL tmp_ul(ul_buf);
@@ -356,7 +630,7 @@ ASDCP::Dictionary::FindULExact(const byte_t* ul_buf) const
       return 0;
     }
 
-  return &m_MDD_Table[i->second];
+  return &m_MDD_Table[index];
 }
 
 //
@@ -364,15 +638,42 @@ const ASDCP::MDDEntry*
 ASDCP::Dictionary::FindSymbol(const std::string& str) const
 {
   assert(m_MDD_Table[0].name[0]);
-  std::map<std::string, ui32_t>::const_iterator i = m_md_sym_lookup.find(str);
-  
-  if ( i == m_md_sym_lookup.end() )
+  const ui32_t mask = IndexSize - 1;
+  ui32_t slot = s_hash_symbol(str.c_str()) & mask;
+
+  while ( m_md_symbol_index[slot] != 0 )
     {
-      Kumu::DefaultLogSink().Warn("UL Dictionary: unknown symbol: %s\n", str.c_str());
-      return 0;
+      ui32_t index = m_md_symbol_index[slot] - 1;
+
+      if ( str == m_MDD_Table[index].name )
+	return &m_MDD_Table[index];
+
+      slot = ( slot + 1 ) & mask;
     }
 
-  return &m_MDD_Table[i->second];
+  Kumu::DefaultLogSink().Warn("UL Dictionary: unknown symbol: %s\n", str.c_str());
+  return 0;
+}
+
+//
+bool
+ASDCP::Dictionary::TypeForUL(const byte_t* ul_buf, MDD_t& type_id) const
+{
+  i32_t index = LookupExact(ul_buf);
+
+  if ( index < 0 )
+    {
+      index = LookupAnyVersion(ul_buf);
+
+      if ( index >= 0 && m_md_keys[index][15] != ul_buf[15] )
+	index = -1;
+    }
+
+  if ( index < 0 )
+    return false;
+
+  type_id = (MDD_t)index;
+  return true;
 }
 
 //
@@ -0,0 +1,388 @@
+/*
+Copyright (c) 2003-2014, John Hurst
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*! \file    InfoJSON.cpp
+    \version $Id$
+    \brief   JSON batch output shared by asdcp-info and as-02-info
+*/
+
+#include <InfoJSON.h>
+#include <KM_mutex.h>
+#include <Metadata.h>
+#include <vector>
+
+#ifndef KM_WIN32
+#include <unistd.h>
+#endif
+
+using namespace ASDCP;
+using Kumu::PathList_t;
+
+//------------------------------------------------------------------------------------------
+// JSONObject
+
+//
+std::string
+ASDCP::JSONObject::quote(const std::string& value)
+{
+  std::string out = "\"";
+
+  for ( std::string::const_iterator i = value.begin(); i != value.end(); ++i )
+    {
+      if ( *i == '"' || *i == '\\' )
+	{
+	  out += '\\';
+	  out += *i;
+	}
+      else if ( (unsigned char)*i < 0x20 )
+	{
+	  char buf[8];
+	  snprintf(buf, 8, "\\u%04x", (unsigned char)*i);
+	  out += buf;
+	}
+      else
+	{
+	  out += *i;
+	}
+    }
+
+  return out + "\"";
+}
+
+//
+void
+ASDCP::JSONObject::add_key(const char* key)
+{
+  if ( ! m_Members.empty() )
+    m_Members += ", ";
+
+  m_Members += quote(key) + ": ";
+}
+
+//
+void
+ASDCP::JSONObject::add_string(const char* key, const std::string& value)
+{
+  add_key(key);
+  m_Members += quote(value);
+}
+
+//
+void
+ASDCP::JSONObject::add_bool(const char* key, bool value)
+{
+  add_key(key);
+  m_Members += ( value ? "true" : "false" );
+}
+
+//
+void
+ASDCP::JSONObject::add_number(const char* key, ui64_t value)
+{
+  char buf[32];
+  snprintf(buf, 32, "%llu", (unsigned long long)value);
+  add_key(key);
+  m_Members += buf;
+}
+
+//
+void
+ASDCP::JSONObject::add_real(const char* key, double value)
+{
+  char buf[32];
+  snprintf(buf, 32, "%0.3f", value);
+  add_key(key);
+  m_Members += ( value == value && value - value == 0.0 ) ? buf : "null";
+}
+
+//
+void
+ASDCP::JSONObject::add_rational(const char* key, const Rational& value)
+{
+  char buf[32];
+  snprintf(buf, 32, "%d/%d", value.Numerator, value.Denominator);
+  add_string(key, buf);
+}
+
+//
+void
+ASDCP::JSONObject::add_string_list(const char* key, const std::list<std::string>& values)
+{
+  add_key(key);
+  m_Members += "[";
+
+  for ( std::list<std::string>::const_iterator i = values.begin(); i != values.end(); ++i )
+    {
+      if ( i != values.begin() )
+	m_Members += ", ";
+
+      m_Members += quote(*i);
+    }
+
+  m_Members += "]";
+}
+
+//
+void
+ASDCP::JSONObject::add_object(const char* key, const JSONObject& value)
+{
+  add_key(key);
+  m_Members += value.str();
+}
+
+//
+std::string
+ASDCP::JSONObject::str() const
+{
+  return "{" + m_Members + "}";
+}
+
+//------------------------------------------------------------------------------------------
+// metadata records
+
+//
+JSONObject
+ASDCP::WriterInfoJSON(const WriterInfo& Info, const char* label_set_name)
+{
+  JSONObject info;
+  char str_buf[64];
+
+  info.add_string("product_uuid", Kumu::UUID(Info.ProductUUID).EncodeHex(str_buf, 64));
+  info.add_string("product_version", Info.ProductVersion);
+  info.add_string("company_name", Info.CompanyName);
+  info.add_string("product_name", Info.ProductName);
+  info.add_bool("encrypted_essence", Info.EncryptedEssence);
+
+  if ( Info.EncryptedEssence )
+    {
+      info.add_bool("hmac", Info.UsesHMAC);
+      info.add_string("context_id", Kumu::UUID(Info.ContextID).EncodeHex(str_buf, 64));
+      info.add_string("cryptographic_key_id", Kumu::UUID(Info.CryptographicKeyID).EncodeHex(str_buf, 64));
+    }
+
+  info.add_string("asset_uuid", Kumu::UUID(Info.AssetUUID).EncodeHex(str_buf, 64));
+  info.add_string("label_set_type", label_set_name);
+  return info;
+}
+
+//
+static std::string
+object_type_name(MXF::InterchangeObject* object)
+{
+  const MDDEntry* entry = DefaultCompositeDict().FindULAnyVersion(object->GetUL().Value());
+  return entry ? entry->name : "Unknown";
+}
+
+//
+JSONObject
+ASDCP::DescriptorJSON(MXF::OP1aHeader& Header)
+{
+  JSONObject desc;
+  MXF::SourcePackage* package = Header.GetSourcePackage();
+  MXF::InterchangeObject* object = 0;
+  char str_buf[64];
+
+  if ( package == 0 || KM_FAILURE(Header.GetMDObjectByID(package->Descriptor, &object)) )
+    return desc;
+
+  desc.add_string("type", object_type_name(object));
+
+  if ( MXF::FileDescriptor* file_desc = dynamic_cast<MXF::FileDescriptor*>(object) )
+    {
+      desc.add_rational("sample_rate", file_desc->SampleRate);
+      desc.add_string("essence_container", file_desc->EssenceContainer.EncodeString(str_buf, 64));
+
+      if ( ! file_desc->ContainerDuration.empty() )
+	desc.add_number("container_duration", file_desc->ContainerDuration.get());
+    }
+
+  if ( MXF::GenericPictureEssenceDescriptor* picture = dynamic_cast<MXF::GenericPictureEssenceDescriptor*>(object) )
+    {
+      desc.add_number("stored_width", picture->StoredWidth);
+      desc.add_number("stored_height", picture->StoredHeight);
+      desc.add_rational("aspect_ratio", picture->AspectRatio);
+      desc.add_number("frame_layout", picture->FrameLayout);
+      desc.add_string("picture_essence_coding", picture->PictureEssenceCoding.EncodeString(str_buf, 64));
+    }
+  else if ( MXF::GenericSoundEssenceDescriptor* sound = dynamic_cast<MXF::GenericSoundEssenceDescriptor*>(object) )
+    {
+      desc.add_rational("audio_sampling_rate", sound->AudioSamplingRate);
+      desc.add_number("channel_count", sound->ChannelCount);
+      desc.add_number("quantization_bits", sound->QuantizationBits);
+      desc.add_bool("locked", sound->Locked != 0);
+
+      if ( MXF::WaveAudioDescriptor* wave = dynamic_cast<MXF::WaveAudioDescriptor*>(object) )
+	{
+	  desc.add_number("block_align", wave->BlockAlign);
+	  desc.add_number("avg_bps", wave->AvgBps);
+	}
+    }
+  else if ( MXF::GenericDataEssenceDescriptor* data = dynamic_cast<MXF::GenericDataEssenceDescriptor*>(object) )
+    {
+      desc.add_string("data_essence_coding", data->DataEssenceCoding.EncodeString(str_buf, 64));
+    }
+
+  if ( MXF::GenericDescriptor* generic = dynamic_cast<MXF::GenericDescriptor*>(object) )
+    {
+      std::list<std::string> names;
+      MXF::Array<Kumu::UUID>::const_iterator i;
+
+      for ( i = generic->SubDescriptors.begin(); i != generic->SubDescriptors.end(); ++i )
+	{
+	  MXF::InterchangeObject* sub_object = 0;
+
+	  if ( KM_SUCCESS(Header.GetMDObjectByID(*i, &sub_object)) )
+	    names.push_back(object_type_name(sub_object));
+	}
+
+      desc.add_string_list("sub_descriptors", names);
+    }
+
+  return desc;
+}
+
+//------------------------------------------------------------------------------------------
+// batch output
+
+//
+bool
+ASDCP::ReadFilenameList(const char* list_name, PathList_t& filenames)
+{
+  FILE* list_file = ( strcmp(list_name, "-") == 0 ) ? stdin : fopen(list_name, "r");
+
+  if ( list_file == 0 )
+    {
+      fprintf(stderr, "Unable to open filename list %s.\n", list_name);
+      return false;
+    }
+
+  char line_buf[Kumu::MaxFilePath + 3]; // room for CR LF and the terminator
+  ui32_t line_number = 0;
+  bool result = true;
+
+  while ( result && fgets(line_buf, sizeof(line_buf), list_file) != 0 )
+    {
+      size_t len = strlen(line_buf);
+      bool line_complete = ( len > 0 && line_buf[len-1] == '\n' ) || feof(list_file);
+      ++line_number;
+
+      while ( len > 0 && ( line_buf[len-1] == '\n' || line_buf[len-1] == '\r' ) )
+	line_buf[--len] = 0;
+
+      if ( ! line_complete || len > Kumu::MaxFilePath )
+	{
+	  fprintf(stderr, "Filename on line %u of %s is longer than %u characters.\n",
+		  line_number, list_name, Kumu::MaxFilePath);
+	  result = false;
+	}
+      else if ( len > 0 )
+	{
+	  filenames.push_back(line_buf);
+	}
+    }
+
+  if ( list_file != stdin )
+    fclose(list_file);
+
+  return result;
+}
+
+// Builds the record for one file per work item and writes the finished records
+// to stdout in list order.
+class JSONRecordWriter : public Kumu::IWorkItemHandler
+{
+  Kumu::Mutex m_Lock;
+  const IJSONRecordSource& m_Source;
+  std::vector<std::string> m_Filenames;
+  std::vector<std::string> m_Records;
+  std::vector<bool> m_Complete;
+  ui32_t m_NextRecord;
+  ui32_t m_Failures;
+
+  KM_NO_COPY_CONSTRUCT(JSONRecordWriter);
+  JSONRecordWriter();
+
+public:
+  JSONRecordWriter(const PathList_t& f, const IJSONRecordSource& s) :
+    m_Source(s), m_Filenames(f.begin(), f.end()), m_Records(m_Filenames.size()),
+    m_Complete(m_Filenames.size(), false), m_NextRecord(0), m_Failures(0) {}
+
+  ui32_t FileCount() const { return m_Filenames.size(); }
+  ui32_t Failures() const { return m_Failures; }
+
+  void HandleItem(ui32_t index)
+  {
+    JSONObject record;
+    Result_t result = m_Source.FillRecord(m_Filenames[index], record);
+
+    if ( ASDCP_FAILURE(result) )
+      record.add_string("error", result.Label());
+
+    Kumu::AutoMutex l(m_Lock);
+    m_Records[index] = record.str();
+    m_Complete[index] = true;
+
+    if ( ASDCP_FAILURE(result) )
+      ++m_Failures;
+
+    // write every record that no longer waits on an earlier one
+    while ( m_NextRecord < m_Filenames.size() && m_Complete[m_NextRecord] )
+      {
+	fprintf(stdout, "%s\n", m_Records[m_NextRecord].c_str());
+	m_Records[m_NextRecord].clear();
+	++m_NextRecord;
+      }
+
+    fflush(stdout);
+  }
+};
+
+//
+Result_t
+ASDCP::WriteJSONRecords(const PathList_t& filenames, ui32_t worker_count, const IJSONRecordSource& source)
+{
+  JSONRecordWriter writer(filenames, source);
+
+  // initialize the dictionaries before the workers need them
+  DefaultCompositeDict();
+  DefaultInteropDict();
+  DefaultSMPTEDict();
+
+#ifndef KM_WIN32
+  if ( worker_count == 0 )
+    {
+      long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+      worker_count = cpu_count > 0 ? (ui32_t)cpu_count : 1;
+    }
+#endif
+
+  Kumu::RunWorkQueue(writer.FileCount(), worker_count, writer);
+  return writer.Failures() == 0 ? RESULT_OK : RESULT_FAIL;
+}
+
+//
+// end InfoJSON.cpp
+//
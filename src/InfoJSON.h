@@ -0,0 +1,101 @@
+/*
+Copyright (c) 2003-2014, John Hurst
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*! \file    InfoJSON.h
+    \version $Id$
+    \brief   JSON batch output shared by asdcp-info and as-02-info
+*/
+
+#ifndef _INFOJSON_H_
+#define _INFOJSON_H_
+
+#include <KM_fileio.h>
+#include <AS_DCP.h>
+#include <MXF.h>
+
+// Like TEST_EXTRA_ARG, but also accepts "-" (standard input) as the argument.
+#define TEST_EXTRA_ARG_STDIN(i,c)					\
+  if ( ++i >= argc || ( argv[(i)][0] == '-' && argv[(i)][1] != 0 ) ) {	\
+    fprintf(stderr, "Argument not found for option -%c.\n", (c));	\
+    return;								\
+  }
+
+namespace ASDCP
+{
+  // Accumulates the members of a JSON object.
+  class JSONObject
+    {
+      std::string m_Members;
+      void add_key(const char* key);
+
+    public:
+      static std::string quote(const std::string& value);
+
+      void add_string(const char* key, const std::string& value);
+      void add_bool(const char* key, bool value);
+      void add_number(const char* key, ui64_t value);
+      void add_real(const char* key, double value);  // NaN and infinity are written as null
+      void add_rational(const char* key, const Rational& value);
+      void add_string_list(const char* key, const std::list<std::string>& values);
+      void add_object(const char* key, const JSONObject& value);
+      std::string str() const;
+    };
+
+  // Fills a JSON record describing one file. Implemented by each info program.
+  class IJSONRecordSource
+    {
+    public:
+      virtual ~IJSONRecordSource() {}
+      virtual Result_t FillRecord(const std::string& filename, JSONObject& record) const = 0;
+    };
+
+  // Describes the writer info. label_set_name is the program's name for
+  // Info.LabelSetType.
+  JSONObject WriterInfoJSON(const WriterInfo& Info, const char* label_set_name);
+
+  // Describes the essence descriptor linked from the file package, and names
+  // its sub-descriptors.
+  JSONObject DescriptorJSON(MXF::OP1aHeader& Header);
+
+  // Appends the names listed one per line in the given file ("-" for standard
+  // input) to the filename list. Empty lines are ignored, and a line longer
+  // than Kumu::MaxFilePath is an error.
+  bool ReadFilenameList(const char* list_name, Kumu::PathList_t& filenames);
+
+  // Writes a JSON record for each file to stdout, examining up to worker_count
+  // files at once (0: one per CPU). Records are written in list order as soon
+  // as all the records before them are complete. A file that cannot be
+  // described gets an "error" member, and RESULT_FAIL is returned.
+  Result_t WriteJSONRecords(const Kumu::PathList_t& filenames, ui32_t worker_count,
+			    const IJSONRecordSource& source);
+
+} // namespace ASDCP
+
+#endif // _INFOJSON_H_
+
+//
+// end InfoJSON.h
+//
@@ -339,6 +339,11 @@ namespace ASDCP
 		  // byte of the data segment. Set this value to zero if you want
 		  // encrypted headers.
 		  Result_t ReadFrame(FrameBuffer&) const;
+
+		  // Reads up to frame_count frames ahead of ReadFrame() on background
+		  // threads, which are delivered in order. Zero (the default) disables
+		  // read-ahead. Returns RESULT_NOTIMPL on platforms without thread support.
+		  Result_t SetReadAhead(ui32_t frame_count) const;
 	  };
 
 	} //namespace JXS
@@ -31,8 +31,11 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 	\brief   AS-DCP library, JPEG XS sequence codestream essence reader implementation
 */
 
+#include <KM_fileio.h>
 #include <JXS.h>
+#include <KM_log.h>
 using namespace ASDCP;
+using Kumu::DefaultLogSink;
 
 //------------------------------------------------------------------------------------------
 
@@ -92,8 +95,11 @@ class ASDCP::JXS::SequenceParser::h__SequenceParser
 	FileList           m_FileList;
 	FileList::iterator m_CurrentFile;
 	CodestreamParser   m_Parser;
+	ui32_t             m_ReadAhead;      // frames to read ahead, 0 to read on demand
+	Kumu::FileReadAhead m_ReadAheadFiles;
 
 	Result_t OpenRead();
+	Result_t ReadFrameAhead(FrameBuffer&);
 
 	ASDCP_NO_COPY_CONSTRUCT(h__SequenceParser);
 
@@ -101,7 +107,7 @@ public:
 	ASDCP::MXF::GenericPictureEssenceDescriptor m_PDesc;
 	ASDCP::MXF::JPEGXSPictureSubDescriptor m_JxsSubdesc;
 
-	h__SequenceParser() : m_FramesRead(0), m_PDesc(&DefaultSMPTEDict()), m_JxsSubdesc(&DefaultSMPTEDict()) {}
+	h__SequenceParser() : m_FramesRead(0), m_ReadAhead(0), m_PDesc(&DefaultSMPTEDict()), m_JxsSubdesc(&DefaultSMPTEDict()) {}
 
 	~h__SequenceParser()
 	{
@@ -110,15 +116,20 @@ public:
 
 	Result_t OpenRead(const std::string& filename);
 	Result_t OpenRead(const std::list<std::string>& file_list);
-	void     Close() {}
+	void     Close()
+	{
+		m_ReadAheadFiles.Stop();
+	}
 
 	Result_t Reset()
 	{
+		Close();
 		m_FramesRead = 0;
 		m_CurrentFile = m_FileList.begin();
 		return RESULT_OK;
 	}
 
+	Result_t SetReadAhead(ui32_t frame_count);
 	Result_t ReadFrame(FrameBuffer&);
 };
 
@@ -174,6 +185,67 @@ ASDCP::JXS::SequenceParser::h__SequenceParser::OpenRead(const std::list<std::str
 	return OpenRead();
 }
 
+//
+ASDCP::Result_t
+ASDCP::JXS::SequenceParser::h__SequenceParser::SetReadAhead(ui32_t frame_count)
+{
+#ifdef KM_WIN32
+	return frame_count == 0 ? RESULT_OK : RESULT_NOTIMPL;
+#else
+	Close();
+	m_ReadAhead = frame_count;
+	return RESULT_OK;
+#endif
+}
+
+// Copies the current frame out of the read-ahead buffer and parses it in
+// memory, as CodestreamParser::OpenReadFrame() does when reading the file.
+ASDCP::Result_t
+ASDCP::JXS::SequenceParser::h__SequenceParser::ReadFrameAhead(FrameBuffer& FB)
+{
+	Result_t result = RESULT_OK;
+
+	if (!m_ReadAheadFiles.Running())
+		result = m_ReadAheadFiles.Start(m_FileList, m_FramesRead, m_ReadAhead);
+
+	Kumu::ByteString* ReadBuf = 0;
+
+	if (ASDCP_SUCCESS(result))
+		result = m_ReadAheadFiles.Acquire(m_FramesRead, ReadBuf);
+
+	if (ASDCP_SUCCESS(result))
+	{
+		if (FB.Capacity() < ReadBuf->Length())
+		{
+			DefaultLogSink().Error("FrameBuf.Capacity: %u frame length: %u\n", FB.Capacity(), ReadBuf->Length());
+			result = RESULT_SMALLBUF;
+		}
+		else
+		{
+			memcpy(FB.Data(), ReadBuf->RoData(), ReadBuf->Length());
+			FB.Size(ReadBuf->Length());
+		}
+	}
+
+	m_ReadAheadFiles.Release(m_FramesRead);
+
+	if (ASDCP_SUCCESS(result))
+	{
+		ASDCP::MXF::GenericPictureEssenceDescriptor PDesc(&DefaultSMPTEDict());
+		ASDCP::MXF::JPEGXSPictureSubDescriptor JxsSubdesc(&DefaultSMPTEDict());
+		byte_t start_of_data = 0; // out param
+		result = ParseMetadataIntoDesc(FB, PDesc, JxsSubdesc, &start_of_data);
+
+		if (ASDCP_SUCCESS(result))
+			FB.PlaintextOffset(start_of_data);
+	}
+
+	if (ASDCP_FAILURE(result))
+		Close(); // the frame is read again if ReadFrame() is retried
+
+	return result;
+}
+
 //
 ASDCP::Result_t
 ASDCP::JXS::SequenceParser::h__SequenceParser::ReadFrame(FrameBuffer& FB)
@@ -181,8 +253,12 @@ ASDCP::JXS::SequenceParser::h__SequenceParser::ReadFrame(FrameBuffer& FB)
 	if (m_CurrentFile == m_FileList.end())
 		return RESULT_ENDOFFILE;
 
-	// open the file
-	Result_t result = m_Parser.OpenReadFrame((*m_CurrentFile).c_str(), FB);
+	Result_t result = RESULT_OK;
+
+	if (m_ReadAhead > 0)
+		result = ReadFrameAhead(FB);
+	else // open the file
+		result = m_Parser.OpenReadFrame((*m_CurrentFile).c_str(), FB);
 
 	if (ASDCP_SUCCESS(result))
 	{
@@ -254,6 +330,16 @@ ASDCP::JXS::SequenceParser::ReadFrame(FrameBuffer& FB) const
 	return m_Parser->ReadFrame(FB);
 }
 
+//
+ASDCP::Result_t
+ASDCP::JXS::SequenceParser::SetReadAhead(ui32_t frame_count) const
+{
+	if (m_Parser.empty())
+		return RESULT_INIT;
+
+	return m_Parser->SetReadAhead(frame_count);
+}
+
 //
 ASDCP::Result_t
 ASDCP::JXS::SequenceParser::FillPictureDescriptor(
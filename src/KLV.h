@@ -37,6 +37,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "AS_DCP.h"
 #include "MDD.h"
 #include <map>
+#include <vector>
 
 
 namespace ASDCP
@@ -112,6 +113,28 @@ inline const char* ui64sz(ui64_t i, char* buf)
       bool MatchIgnorePlaceholder(const UL& rhs) const;
     };
 
+  // 32-bit FNV-1a hashes of a UL value, for use with open-addressed lookup tables.
+  // The IgnoreStream variant skips the version (byte 7) and stream number (byte 15)
+  // so that ULs which satisfy UL::MatchIgnoreStream() hash to the same value.
+  inline ui32_t HashUL(const byte_t* ul)
+  {
+    ui32_t h = 2166136261U;
+    for ( ui32_t i = 0; i < SMPTE_UL_LENGTH; ++i )
+      h = ( h ^ ul[i] ) * 16777619U;
+    return h;
+  }
+
+  inline ui32_t HashULIgnoreStream(const byte_t* ul)
+  {
+    ui32_t h = 2166136261U;
+    for ( ui32_t i = 0; i < SMPTE_UL_LENGTH - 1; ++i )
+      {
+	if ( i != 7 )
+	  h = ( h ^ ul[i] ) * 16777619U;
+      }
+    return h;
+  }
+
   // UMID
   class UMID : public Kumu::Identifier<SMPTE_UMID_LENGTH>
     {
@@ -144,9 +167,28 @@ inline const char* ui64sz(ui64_t i, char* buf)
   //
   class Dictionary
     {
-      std::map<ASDCP::UL, ui32_t>   m_md_lookup;
-      std::map<std::string, ui32_t> m_md_sym_lookup;
-      std::map<ui32_t, ASDCP::UL>   m_md_rev_lookup;
+      // Slot count of the hash indexes below; a power of two at least twice MDD_Max.
+      enum { IndexSize = 2048 };
+
+      // The UL each entry was registered with, indexed by MDD_t, and whether
+      // the entry is present in the dictionary.
+      byte_t m_md_keys[(ui32_t)ASDCP::MDD_Max][SMPTE_UL_LENGTH];
+      bool   m_md_present[(ui32_t)ASDCP::MDD_Max];
+
+      // Open-addressed hash indexes over the present entries. Slots hold the
+      // table index plus one; zero marks an empty slot. The any-version index
+      // is keyed on the UL less its version and stream bytes and holds the
+      // lowest matching UL.
+      ui16_t m_md_exact_index[IndexSize];
+      ui16_t m_md_any_version_index[IndexSize];
+      ui16_t m_md_symbol_index[IndexSize];
+      std::vector<ui16_t> m_md_placeholder_entries; // entries with 0x7f wildcards, in UL order
+
+      void IndexEntry(ui32_t index);
+      void UnindexEntry(ui32_t index);
+      void RebuildIndex();
+      i32_t LookupExact(const byte_t*) const;
+      i32_t LookupAnyVersion(const byte_t*) const;
 
       ASDCP_NO_COPY_CONSTRUCT(Dictionary);
 
@@ -163,6 +205,10 @@ inline const char* ui64sz(ui64_t i, char* buf)
       const MDDEntry* FindULAnyVersion(const byte_t*) const;
       const MDDEntry* FindULExact(const byte_t*) const;
       const MDDEntry* FindSymbol(const std::string&) const;
+
+      // Silent lookup of the entry whose UL matches ul_buf, ignoring the version
+      // byte as UL::operator== does. Returns false if there is no such entry.
+      bool TypeForUL(const byte_t* ul_buf, MDD_t& type_id) const;
       const MDDEntry& Type(MDD_t type_id) const;
       MDDEntry& MutableType(MDD_t type_id);
 
@@ -189,6 +235,11 @@ inline const char* ui64sz(ui64_t i, char* buf)
       virtual void     ClearTagList() = 0;
       virtual Result_t InsertTag(const MDDEntry& Entry, ASDCP::TagValue& Tag) = 0;
       virtual Result_t TagForKey(const ASDCP::UL& Key, ASDCP::TagValue& Tag) = 0;
+
+      // as TagForKey(), for a dictionary entry; implementations may cache the result
+      virtual Result_t TagForEntry(const MDDEntry& Entry, ASDCP::TagValue& Tag) {
+	return TagForKey(UL(Entry.ul), Tag);
+      }
     };
 
   //
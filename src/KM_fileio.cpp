@@ -34,6 +34,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <fcntl.h>
 
 #include <assert.h>
+#include <vector>
 
 #ifdef KM_WIN32
 #include <direct.h>
@@ -76,7 +77,14 @@ struct iovec {
 
 #include <sys/stat.h>
 #include <sys/uio.h>
+#include <sys/mman.h>
+#include <pthread.h>
+#include <unistd.h>
 typedef struct stat     fstat_t;
+
+# if defined(__linux__) && defined(__GLIBC__) && ( __GLIBC__ > 2 || ( __GLIBC__ == 2 && __GLIBC_MINOR__ >= 27 ) )
+#   define KM_HAVE_COPY_FILE_RANGE
+# endif
 #endif
 
 #if defined(__sun) && defined(__SVR4)
@@ -202,6 +210,29 @@ Kumu::FileSize(const std::string& pathname)
   return 0;
 }
 
+//
+ui64_t
+Kumu::PathModificationTime(const std::string& pathname)
+{
+  if ( pathname.empty() )
+    return 0;
+
+  fstat_t info;
+
+  if ( KM_SUCCESS(do_stat(pathname.c_str(), &info)) )
+    {
+#if defined(__linux__)
+      return (ui64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+      return (ui64_t)info.st_mtimespec.tv_sec * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+      return (ui64_t)info.st_mtime;
+#endif
+    }
+
+  return 0;
+}
+
 //
 static void
 make_canonical_list(const PathCompList_t& in_list, PathCompList_t& out_list)
@@ -735,10 +766,446 @@ Kumu::FileReader::Size() const
   return 0;
 }
 
+//------------------------------------------------------------------------------------------
+//
+
+Kumu::FileMap::FileMap() : m_MapData(0), m_MapSize(0)
+{
+#ifdef KM_WIN32
+  m_MapHandle = 0;
+#endif
+}
+
+Kumu::FileMap::~FileMap()
+{
+  Kumu::FileMap::Close();
+}
+
+//
+Kumu::Result_t
+Kumu::FileMap::OpenRead(const std::string& filename) const
+{
+  Result_t result = FileReader::OpenRead(filename);
+
+  if ( KM_FAILURE(result) )
+    return result;
+
+  int64_t file_size = Size();
+
+  if ( file_size <= 0 || (ui64_t)file_size > (ui64_t)((size_t)-1) )
+    {
+      DefaultLogSink().Error("Unable to map file %s: unsupported size.\n", filename.c_str());
+      FileReader::Close();
+      return RESULT_FILEOPEN;
+    }
+
+  FileMap* self = const_cast<FileMap*>(this);
+
+#ifdef KM_WIN32
+  self->m_MapHandle = ::CreateFileMapping(m_Handle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+  if ( m_MapHandle != 0 )
+    {
+      self->m_MapData = (const byte_t*)::MapViewOfFile(m_MapHandle, FILE_MAP_READ, 0, 0, 0);
+
+      if ( m_MapData == 0 )
+	{
+	  ::CloseHandle(m_MapHandle);
+	  self->m_MapHandle = 0;
+	}
+    }
+#else
+  void* map_addr = mmap(0, (size_t)file_size, PROT_READ, MAP_SHARED, m_Handle, 0);
+
+  if ( map_addr != MAP_FAILED )
+    {
+      self->m_MapData = (const byte_t*)map_addr;
+# ifdef MADV_SEQUENTIAL
+      madvise(map_addr, (size_t)file_size, MADV_SEQUENTIAL);
+# endif
+    }
+#endif
+
+  if ( m_MapData == 0 )
+    {
+      DefaultLogSink().Error("Unable to map file %s.\n", filename.c_str());
+      FileReader::Close();
+      return RESULT_FILEOPEN;
+    }
+
+  self->m_MapSize = file_size;
+  return RESULT_OK;
+}
+
+//
+Kumu::Result_t
+Kumu::FileMap::Close() const
+{
+  FileMap* self = const_cast<FileMap*>(this);
+
+  if ( m_MapData != 0 )
+    {
+#ifdef KM_WIN32
+      ::UnmapViewOfFile(m_MapData);
+      ::CloseHandle(m_MapHandle);
+      self->m_MapHandle = 0;
+#else
+      munmap((void*)m_MapData, (size_t)m_MapSize);
+#endif
+      self->m_MapData = 0;
+      self->m_MapSize = 0;
+    }
+
+  return FileReader::Close();
+}
+
+
+//------------------------------------------------------------------------------------------
+// write-behind
+
+#ifdef KM_WIN32
+// write-behind mode is not implemented on Win32
+class Kumu::FileWriter::h__WriteBehind {};
+#else // KM_WIN32
+
+// Regions of staged data, and the threads that write them at their offsets.
+class Kumu::FileWriter::h__WriteBehind
+{
+  KM_NO_COPY_CONSTRUCT(h__WriteBehind);
+  h__WriteBehind();
+
+public:
+  struct Region
+  {
+    byte_t*       data;
+    ui32_t        length;
+    Kumu::fpos_t  offset;
+  };
+
+  int                     m_Handle;
+  ui32_t                  m_RegionSize;
+  ui32_t                  m_MaxPending;    // regions staged or being written before Append() waits
+  Kumu::fpos_t            m_Position;      // file position of the end of the staged data
+  Region                  m_Current;       // the region being filled
+  std::list<Region>       m_Pending;       // full regions waiting for a thread
+  std::list<byte_t*>      m_FreeBuffers;
+  ui32_t                  m_Busy;          // regions being written
+  bool                    m_Stopping;
+  Result_t                m_Result;        // the first background write error
+  std::list<pthread_t>    m_Threads;
+  pthread_mutex_t         m_Lock;
+  pthread_cond_t          m_WorkReady;     // signaled when a region is pending or stopping
+  pthread_cond_t          m_WorkDone;      // signaled when a region has been written
+
+  h__WriteBehind(int handle, ui32_t region_size, ui32_t thread_count, Kumu::fpos_t position) :
+    m_Handle(handle), m_RegionSize(region_size), m_MaxPending(thread_count * 2),
+    m_Position(position), m_Busy(0), m_Stopping(false), m_Result(RESULT_OK)
+  {
+    m_Current.data = 0;
+    m_Current.length = 0;
+    m_Current.offset = position;
+    pthread_mutex_init(&m_Lock, 0);
+    pthread_cond_init(&m_WorkReady, 0);
+    pthread_cond_init(&m_WorkDone, 0);
+  }
+
+  ~h__WriteBehind()
+  {
+    Stop();
+    delete [] m_Current.data;
+
+    while ( ! m_FreeBuffers.empty() )
+      {
+	delete [] m_FreeBuffers.front();
+	m_FreeBuffers.pop_front();
+      }
+
+    pthread_cond_destroy(&m_WorkDone);
+    pthread_cond_destroy(&m_WorkReady);
+    pthread_mutex_destroy(&m_Lock);
+  }
+
+  //
+  Result_t Start(ui32_t thread_count)
+  {
+    m_Current.data = new byte_t[m_RegionSize];
+
+    for ( ui32_t i = 0; i < thread_count; ++i )
+      {
+	pthread_t thread;
+
+	if ( pthread_create(&thread, 0, &h__WriteBehind::ThreadMain, this) != 0 )
+	  return RESULT_FAIL;
+
+	m_Threads.push_back(thread);
+      }
+
+    return RESULT_OK;
+  }
+
+  // Returns the first background write error after waiting for every thread.
+  Result_t Stop()
+  {
+    Result_t result = Flush();
+    pthread_mutex_lock(&m_Lock);
+    m_Stopping = true;
+    pthread_cond_broadcast(&m_WorkReady);
+    pthread_mutex_unlock(&m_Lock);
+
+    std::list<pthread_t>::iterator i;
+    for ( i = m_Threads.begin(); i != m_Threads.end(); ++i )
+      pthread_join(*i, 0);
+
+    m_Threads.clear();
+    return result;
+  }
+
+  //
+  Result_t Append(const byte_t* buf, ui32_t buf_len)
+  {
+    Result_t result = RESULT_OK;
+
+    while ( buf_len > 0 && KM_SUCCESS(result) )
+      {
+	ui32_t copy_len = xmin(buf_len, m_RegionSize - m_Current.length);
+	memcpy(m_Current.data + m_Current.length, buf, copy_len);
+	m_Current.length += copy_len;
+	m_Position += copy_len;
+	buf += copy_len;
+	buf_len -= copy_len;
+
+	if ( m_Current.length == m_RegionSize )
+	  result = Submit();
+      }
+
+    return result;
+  }
+
+  // Queues the current region, waiting while too many regions are pending.
+  Result_t Submit()
+  {
+    if ( m_Current.length == 0 )
+      return Error();
+
+    pthread_mutex_lock(&m_Lock);
+
+    while ( m_Pending.size() + m_Busy >= m_MaxPending && KM_SUCCESS(m_Result) )
+      pthread_cond_wait(&m_WorkDone, &m_Lock);
+
+    m_Pending.push_back(m_Current);
+    pthread_cond_signal(&m_WorkReady);
+
+    if ( m_FreeBuffers.empty() )
+      {
+	m_Current.data = 0;
+      }
+    else
+      {
+	m_Current.data = m_FreeBuffers.front();
+	m_FreeBuffers.pop_front();
+      }
+
+    Result_t result = m_Result;
+    pthread_mutex_unlock(&m_Lock);
+
+    if ( m_Current.data == 0 )
+      m_Current.data = new byte_t[m_RegionSize];
+
+    m_Current.length = 0;
+    m_Current.offset = m_Position;
+    return result;
+  }
+
+  // Queues the current region and waits until every region is written.
+  Result_t Flush()
+  {
+    Submit();
+    pthread_mutex_lock(&m_Lock);
+
+    while ( ! m_Pending.empty() || m_Busy > 0 )
+      pthread_cond_wait(&m_WorkDone, &m_Lock);
+
+    Result_t result = m_Result;
+    pthread_mutex_unlock(&m_Lock);
+    return result;
+  }
+
+  //
+  Result_t Error()
+  {
+    pthread_mutex_lock(&m_Lock);
+    Result_t result = m_Result;
+    pthread_mutex_unlock(&m_Lock);
+    return result;
+  }
+
+  //
+  static void* ThreadMain(void* arg)
+  {
+    h__WriteBehind* self = static_cast<h__WriteBehind*>(arg);
+    pthread_mutex_lock(&self->m_Lock);
+
+    for (;;)
+      {
+	while ( self->m_Pending.empty() && ! self->m_Stopping )
+	  pthread_cond_wait(&self->m_WorkReady, &self->m_Lock);
+
+	if ( self->m_Pending.empty() )
+	  break;
+
+	Region region = self->m_Pending.front();
+	self->m_Pending.pop_front();
+	++self->m_Busy;
+	pthread_mutex_unlock(&self->m_Lock);
+
+	Result_t result = RESULT_OK;
+	ui32_t written = 0;
+
+	while ( written < region.length )
+	  {
+	    ssize_t write_size = pwrite(self->m_Handle, region.data + written, region.length - written,
+					region.offset + written);
+
+	    if ( write_size == -1L && errno == EINTR )
+	      continue;
+
+	    if ( write_size <= 0 )
+	      {
+		DefaultLogSink().Error("Error writing file region: %s\n", strerror(errno));
+		result = RESULT_WRITEFAIL;
+		break;
+	      }
+
+	    written += write_size;
+	  }
+
+	pthread_mutex_lock(&self->m_Lock);
+	--self->m_Busy;
+	self->m_FreeBuffers.push_back(region.data);
+
+	if ( KM_FAILURE(result) && KM_SUCCESS(self->m_Result) )
+	  self->m_Result = result;
+
+	pthread_cond_broadcast(&self->m_WorkDone);
+      }
+
+    pthread_mutex_unlock(&self->m_Lock);
+    return 0;
+  }
+};
+
+#endif // KM_WIN32
+
 // these are declared here instead of in the header file
 // because we have a mem_ptr that is managing a hidden class
 Kumu::FileWriter::FileWriter() {}
-Kumu::FileWriter::~FileWriter() {}
+
+Kumu::FileWriter::~FileWriter()
+{
+  StopWriteBehind();
+}
+
+//
+Kumu::Result_t
+Kumu::FileWriter::StartWriteBehind(ui32_t thread_count, ui32_t region_size)
+{
+#ifdef KM_WIN32
+  return RESULT_NOTIMPL;
+#else
+  if ( ! IsOpen() || ! m_WriteBehind.empty() )
+    return RESULT_STATE;
+
+  if ( thread_count == 0 || region_size == 0 )
+    return RESULT_PARAM;
+
+  Result_t result = Writev();
+
+  if ( KM_SUCCESS(result) )
+    {
+      m_WriteBehind = new h__WriteBehind(m_Handle, region_size, thread_count, TellPosition());
+      result = m_WriteBehind->Start(thread_count);
+
+      if ( KM_FAILURE(result) )
+	m_WriteBehind.set(0);
+    }
+
+  return result;
+#endif
+}
+
+//
+Kumu::Result_t
+Kumu::FileWriter::EndRegion()
+{
+#ifdef KM_WIN32
+  return RESULT_OK;
+#else
+  if ( m_WriteBehind.empty() )
+    return RESULT_OK;
+
+  return m_WriteBehind->Submit();
+#endif
+}
+
+//
+Kumu::Result_t
+Kumu::FileWriter::StopWriteBehind()
+{
+#ifdef KM_WIN32
+  return RESULT_OK;
+#else
+  if ( m_WriteBehind.empty() )
+    return RESULT_OK;
+
+  // pwrite() did not move the file pointer; leave it at the end of the written data
+  Result_t result = m_WriteBehind->Stop();
+  Kumu::fpos_t position = m_WriteBehind->m_Position;
+  m_WriteBehind.set(0);
+
+  if ( KM_SUCCESS(result) )
+    result = FileReader::Seek(position);
+
+  return result;
+#endif
+}
+
+//
+Kumu::Result_t
+Kumu::FileWriter::Close() const
+{
+  // a failed background write is reported ahead of the close itself
+  Result_t result = const_cast<FileWriter*>(this)->StopWriteBehind();
+  Result_t close_result = FileReader::Close();
+  return KM_SUCCESS(result) ? close_result : result;
+}
+
+//
+Kumu::Result_t
+Kumu::FileWriter::Seek(Kumu::fpos_t position, SeekPos_t whence) const
+{
+  Result_t result = const_cast<FileWriter*>(this)->StopWriteBehind();
+
+  if ( KM_SUCCESS(result) )
+    result = FileReader::Seek(position, whence);
+
+  return result;
+}
+
+//
+Kumu::Result_t
+Kumu::FileWriter::Tell(Kumu::fpos_t* pos) const
+{
+#ifndef KM_WIN32
+  if ( ! m_WriteBehind.empty() )
+    {
+      KM_TEST_NULL_L(pos);
+      *pos = m_WriteBehind->m_Position;
+      return RESULT_OK;
+    }
+#endif
+
+  return FileReader::Tell(pos);
+}
 
 //
 Kumu::Result_t
@@ -1206,6 +1673,18 @@ Kumu::FileWriter::Writev(ui32_t* bytes_written)
   for ( int i = 0; i < iov->m_Count; i++ )
     total_size += iov->m_iovec[i].iov_len;
 
+  if ( ! m_WriteBehind.empty() )
+    {
+      Result_t result = RESULT_OK;
+
+      for ( int i = 0; i < iov->m_Count && KM_SUCCESS(result); i++ )
+	result = m_WriteBehind->Append((const byte_t*)iov->m_iovec[i].iov_base, iov->m_iovec[i].iov_len);
+
+      iov->m_Count = 0;
+      *bytes_written = KM_SUCCESS(result) ? total_size : 0;
+      return result;
+    }
+
   int write_size = writev(m_Handle, iov->m_iovec, iov->m_Count);
   
   if ( write_size == -1L || write_size != total_size )
@@ -1229,6 +1708,18 @@ Kumu::FileWriter::Write(const byte_t* buf, ui32_t buf_len, ui32_t* bytes_written
   if ( m_Handle == -1L )
     return RESULT_STATE;
 
+  if ( ! m_WriteBehind.empty() )
+    {
+      // keep the order of any queued gather-write buffers
+      Result_t result = Writev();
+
+      if ( KM_SUCCESS(result) )
+	result = m_WriteBehind->Append(buf, buf_len);
+
+      *bytes_written = KM_SUCCESS(result) ? buf_len : 0;
+      return result;
+    }
+
   int write_size = write(m_Handle, buf, buf_len);
 
   if ( write_size == -1L || (ui32_t)write_size != buf_len )
@@ -1241,6 +1732,65 @@ Kumu::FileWriter::Write(const byte_t* buf, ui32_t buf_len, ui32_t* bytes_written
 
 #endif // KM_WIN32
 
+// largest buffer used by FileWriter::WriteFromFile()
+const ui32_t CopyBufferSize = Kumu::Megabyte;
+
+//
+Kumu::Result_t
+Kumu::FileWriter::WriteFromFile(const IFileReader& reader, ui64_t length)
+{
+  if ( ! IsOpen() || ! reader.IsOpen() )
+    return RESULT_STATE;
+
+  // keep the order of any queued gather-write buffers
+  Result_t result = Writev();
+
+#ifdef KM_HAVE_COPY_FILE_RANGE
+  const FileReader* file_reader = dynamic_cast<const FileReader*>(&reader);
+
+  if ( KM_SUCCESS(result) && file_reader != 0 && m_WriteBehind.empty() )
+    {
+      while ( length > 0 )
+	{
+	  ssize_t copy_size = copy_file_range(file_reader->m_Handle, 0, m_Handle, 0,
+					      (size_t)xmin(length, (ui64_t)0x40000000), 0);
+
+	  if ( copy_size == -1L && errno == EINTR )
+	    continue;
+
+	  // not supported for these files, or the reader ended; the buffered copy finishes
+	  if ( copy_size <= 0 )
+	    break;
+
+	  length -= copy_size;
+	}
+    }
+#endif
+
+  if ( KM_SUCCESS(result) && length > 0 )
+    {
+      ByteString buffer;
+      result = buffer.Capacity((ui32_t)xmin(length, (ui64_t)CopyBufferSize));
+
+      while ( KM_SUCCESS(result) && length > 0 )
+	{
+	  ui32_t chunk_size = (ui32_t)xmin(length, (ui64_t)buffer.Capacity());
+	  ui32_t read_count = 0;
+	  result = reader.Read(buffer.Data(), chunk_size, &read_count);
+
+	  if ( KM_SUCCESS(result) && read_count != chunk_size )
+	    result = RESULT_READFAIL;
+
+	  if ( KM_SUCCESS(result) )
+	    result = Write(buffer.RoData(), chunk_size);
+
+	  length -= chunk_size;
+	}
+    }
+
+  return result;
+}
+
 //------------------------------------------------------------------------------------------
 
 //
@@ -1415,6 +1965,265 @@ Kumu::WriteBufferIntoFile(const Kumu::ByteString& Buffer, const std::string& Fil
   return result;
 }
 
+//------------------------------------------------------------------------------------------
+// read-ahead
+
+#ifdef KM_WIN32
+// read-ahead is not implemented on Win32
+class Kumu::FileReadAhead::h__ReadAhead {};
+#else // KM_WIN32
+
+// File n is read into slot n % depth, which becomes free when the consumer
+// releases file n - depth.
+class Kumu::FileReadAhead::h__ReadAhead
+{
+  KM_NO_COPY_CONSTRUCT(h__ReadAhead);
+  h__ReadAhead();
+
+  static const ui32_t NoFile = 0xffffffff;
+
+  struct Slot
+  {
+    ByteString  buffer;
+    ui32_t      file;    // the file being read into or held by the slot
+    bool        ready;
+    Result_t    result;
+
+    Slot() : file(NoFile), ready(false), result(RESULT_OK) {}
+  };
+
+  std::vector<std::string> m_Files;
+  std::vector<Slot*>       m_Slots;
+  ui32_t                   m_NextRead;   // the next file to be claimed by a thread
+  bool                     m_Stopping;
+  std::list<pthread_t>     m_Threads;
+  pthread_mutex_t          m_Lock;
+  pthread_cond_t           m_Changed;    // signaled when a slot is filled or released, or when stopping
+
+  //
+  static Result_t ReadFile(const std::string& filename, ByteString& buffer)
+  {
+    FileReader Reader;
+    ui32_t read_count = 0;
+    buffer.Length(0);
+
+    Result_t result = Reader.OpenRead(filename);
+
+    if ( KM_SUCCESS(result) )
+      {
+	int64_t file_size = Reader.Size();
+
+	if ( file_size > 0xffffffffL )
+	  {
+	    DefaultLogSink().Error("%s: file too large for read-ahead\n", filename.c_str());
+	    return RESULT_ALLOC;
+	  }
+
+	if ( file_size == 0 )
+	  return RESULT_OK;
+
+	result = buffer.Capacity((ui32_t)file_size);
+
+	if ( KM_SUCCESS(result) )
+	  result = Reader.Read(buffer.Data(), (ui32_t)file_size, &read_count);
+
+	if ( KM_SUCCESS(result) && read_count != file_size )
+	  result = RESULT_READFAIL;
+      }
+
+    if ( KM_SUCCESS(result) )
+      buffer.Length(read_count);
+
+    return result;
+  }
+
+  //
+  static void* ThreadMain(void* arg)
+  {
+    h__ReadAhead* self = static_cast<h__ReadAhead*>(arg);
+    pthread_mutex_lock(&self->m_Lock);
+
+    for (;;)
+      {
+	while ( ! self->m_Stopping && self->m_NextRead < self->m_Files.size()
+		&& self->m_Slots[self->m_NextRead % self->m_Slots.size()]->file != NoFile )
+	  pthread_cond_wait(&self->m_Changed, &self->m_Lock);
+
+	if ( self->m_Stopping || self->m_NextRead >= self->m_Files.size() )
+	  break;
+
+	ui32_t file = self->m_NextRead++;
+	Slot& slot = *self->m_Slots[file % self->m_Slots.size()];
+	slot.file = file;
+	pthread_mutex_unlock(&self->m_Lock);
+
+	Result_t result = ReadFile(self->m_Files[file], slot.buffer);
+
+	pthread_mutex_lock(&self->m_Lock);
+	slot.result = result;
+	slot.ready = true;
+	pthread_cond_broadcast(&self->m_Changed);
+      }
+
+    pthread_mutex_unlock(&self->m_Lock);
+    return 0;
+  }
+
+public:
+  h__ReadAhead(const std::list<std::string>& files, ui32_t first, ui32_t depth) :
+    m_Files(files.begin(), files.end()), m_NextRead(first), m_Stopping(false)
+  {
+    for ( ui32_t i = 0; i < depth; ++i )
+      m_Slots.push_back(new Slot);
+
+    pthread_mutex_init(&m_Lock, 0);
+    pthread_cond_init(&m_Changed, 0);
+  }
+
+  ~h__ReadAhead()
+  {
+    Stop();
+
+    for ( ui32_t i = 0; i < m_Slots.size(); ++i )
+      delete m_Slots[i];
+
+    pthread_cond_destroy(&m_Changed);
+    pthread_mutex_destroy(&m_Lock);
+  }
+
+  // Starts one thread per slot; succeeds if at least one thread is running.
+  Result_t Start()
+  {
+    for ( ui32_t i = 0; i < m_Slots.size(); ++i )
+      {
+	pthread_t thread;
+
+	if ( pthread_create(&thread, 0, &h__ReadAhead::ThreadMain, this) != 0 )
+	  return m_Threads.empty() ? RESULT_FAIL : RESULT_OK;
+
+	m_Threads.push_back(thread);
+      }
+
+    return RESULT_OK;
+  }
+
+  //
+  void Stop()
+  {
+    pthread_mutex_lock(&m_Lock);
+    m_Stopping = true;
+    pthread_cond_broadcast(&m_Changed);
+    pthread_mutex_unlock(&m_Lock);
+
+    std::list<pthread_t>::iterator i;
+    for ( i = m_Threads.begin(); i != m_Threads.end(); ++i )
+      pthread_join(*i, 0);
+
+    m_Threads.clear();
+  }
+
+  //
+  Result_t Acquire(ui32_t index, ByteString*& buffer)
+  {
+    if ( index >= m_Files.size() )
+      return RESULT_ENDOFFILE;
+
+    Slot& slot = *m_Slots[index % m_Slots.size()];
+    pthread_mutex_lock(&m_Lock);
+
+    // a file before the next one to be read must be in its slot, or it has been released
+    while ( ! ( slot.file == index && slot.ready ) && ( index >= m_NextRead || slot.file == index ) )
+      pthread_cond_wait(&m_Changed, &m_Lock);
+
+    if ( slot.file != index )
+      {
+	pthread_mutex_unlock(&m_Lock);
+	return RESULT_STATE;
+      }
+
+    pthread_mutex_unlock(&m_Lock);
+    buffer = &slot.buffer;
+    return slot.result;
+  }
+
+  // A file that was not acquired may still be being read into its slot.
+  void Release(ui32_t index)
+  {
+    Slot& slot = *m_Slots[index % m_Slots.size()];
+    pthread_mutex_lock(&m_Lock);
+
+    while ( slot.file == index && ! slot.ready )
+      pthread_cond_wait(&m_Changed, &m_Lock);
+
+    if ( slot.file == index )
+      {
+	slot.file = NoFile;
+	slot.ready = false;
+	pthread_cond_broadcast(&m_Changed);
+      }
+
+    pthread_mutex_unlock(&m_Lock);
+  }
+};
+
+#endif // KM_WIN32
+
+// these are declared here instead of in the header file
+// because we have a mem_ptr that is managing a hidden class
+Kumu::FileReadAhead::FileReadAhead() {}
+Kumu::FileReadAhead::~FileReadAhead() {}
+
+//
+Kumu::Result_t
+Kumu::FileReadAhead::Start(const std::list<std::string>& files, ui32_t first, ui32_t depth)
+{
+#ifdef KM_WIN32
+  return RESULT_NOTIMPL;
+#else
+  if ( depth == 0 )
+    return RESULT_PARAM;
+
+  m_ReadAhead = new h__ReadAhead(files, first, depth);
+  Result_t result = m_ReadAhead->Start();
+
+  if ( KM_FAILURE(result) )
+    m_ReadAhead.set(0);
+
+  return result;
+#endif
+}
+
+//
+void
+Kumu::FileReadAhead::Stop()
+{
+  m_ReadAhead.set(0);
+}
+
+//
+Kumu::Result_t
+Kumu::FileReadAhead::Acquire(ui32_t index, ByteString*& buffer)
+{
+#ifdef KM_WIN32
+  return RESULT_NOTIMPL;
+#else
+  if ( m_ReadAhead.empty() )
+    return RESULT_INIT;
+
+  return m_ReadAhead->Acquire(index, buffer);
+#endif
+}
+
+//
+void
+Kumu::FileReadAhead::Release(ui32_t index)
+{
+#ifndef KM_WIN32
+  if ( ! m_ReadAhead.empty() )
+    m_ReadAhead->Release(index);
+#endif
+}
+
 //------------------------------------------------------------------------------------------
 //
 
@@ -163,6 +163,7 @@ namespace Kumu
   bool        PathIsFile(const std::string& Path); // true if the path exists in the filesystem and is a file
   bool        PathIsDirectory(const std::string& Path); // true if the path exists in the filesystem and is a directory
   fsize_t     FileSize(const std::string& Path); // returns the size of a regular file, 0 for a directory or device
+  ui64_t      PathModificationTime(const std::string& Path); // returns an opaque modification stamp (finer than seconds where supported), 0 on error
   std::string PathCwd();
   bool        PathsAreEquivalent(const std::string& lhs, const std::string& rhs); // true if paths point to the same filesystem entry
 
@@ -358,6 +359,8 @@ namespace Kumu
     protected:
       std::string m_Filename;
       FileHandle  m_Handle;
+
+      friend class FileWriter;
   };
 
   //
@@ -378,7 +381,9 @@ namespace Kumu
   class FileWriter : public FileReader
     {
       class h__iovec;
+      class h__WriteBehind;
       mem_ptr<h__iovec>  m_IOVec;
+      mem_ptr<h__WriteBehind> m_WriteBehind;
       KM_NO_COPY_CONSTRUCT(FileWriter);
 
     public:
@@ -387,6 +392,22 @@ namespace Kumu
 
       Result_t OpenWrite(const std::string&);                               // open a new file, overwrites existing
       Result_t OpenModify(const std::string&);                              // open a file for read/write
+      virtual Result_t Close() const;                                       // close the file
+      virtual Result_t Seek(Kumu::fpos_t = 0, SeekPos_t = SP_BEGIN) const;  // move the file pointer
+      virtual Result_t Tell(Kumu::fpos_t* pos) const;                       // report the file pointer's location
+
+      // Write-behind mode: from the current file position on, the data given to
+      // Write() and Writev() is copied into regions of up to region_size bytes,
+      // which thread_count background threads write at their offsets in the file.
+      // Tell() reports the position of the data written so far; Seek(), Close()
+      // and StopWriteBehind() wait until every region is on disk and return to
+      // direct writes. A failed background write is reported by the next call to
+      // Write(), Writev(), EndRegion(), StopWriteBehind(), Seek() or Close(). Not
+      // available on Win32.
+      Result_t StartWriteBehind(ui32_t thread_count, ui32_t region_size);
+      Result_t EndRegion();        // hand the data copied so far to the background threads
+      Result_t StopWriteBehind();  // wait for the pending regions and return to direct writes
+      inline bool WriteBehind() const { return ! m_WriteBehind.empty(); }
 
       // this part of the interface takes advantage of the iovec structure on
       // platforms that support it. For each call to Writev(const byte_t*, ui32_t, ui32_t*),
@@ -399,8 +420,64 @@ namespace Kumu
       // the iovec list will be written to disk before the given buffer,as though
       // you had called Writev() first.
       Result_t Write(const byte_t*, ui32_t, ui32_t* = 0);            // write buffer to disk
+
+      // Copies length bytes from the reader's file position to this file's
+      // position, without holding more than a bounded buffer in memory. Between
+      // two FileReader-based files on Linux the copy is done by copy_file_range().
+      // Returns RESULT_READFAIL if the reader ends before length bytes.
+      Result_t WriteFromFile(const IFileReader& reader, ui64_t length);
    };
 
+  // A read-only view of the entire contents of a file, mapped into memory. The
+  // view is valid from a successful call to OpenRead() until Close() is called
+  // or the object is destroyed. Read() and Seek() remain available.
+  class FileMap : public FileReader
+    {
+      const byte_t* m_MapData;
+      ui64_t        m_MapSize;
+#ifdef KM_WIN32
+      HANDLE        m_MapHandle;
+#endif
+      KM_NO_COPY_CONSTRUCT(FileMap);
+
+    public:
+      FileMap();
+      virtual ~FileMap();
+
+      virtual Result_t OpenRead(const std::string&) const;  // open and map the file
+      virtual Result_t Close() const;                       // unmap and close the file
+
+      inline const byte_t* MapData() const { return m_MapData; }  // start of the mapping
+      inline ui64_t        MapSize() const { return m_MapSize; }  // size of the mapping
+    };
+
+  // Reads the files of a list into memory on background threads, ahead of a
+  // consumer that takes them in list order. At most depth files are held at once:
+  // a file's buffer is reused once the consumer has released it. Not available
+  // on Win32.
+  class FileReadAhead
+    {
+      class h__ReadAhead;
+      mem_ptr<h__ReadAhead> m_ReadAhead;
+      KM_NO_COPY_CONSTRUCT(FileReadAhead);
+
+    public:
+      FileReadAhead();
+      virtual ~FileReadAhead();
+
+      // Starts depth threads reading the files from index first onward.
+      Result_t Start(const std::list<std::string>& files, ui32_t first, ui32_t depth);
+      void     Stop();  // wait for the threads and drop the buffers
+      inline bool Running() const { return ! m_ReadAhead.empty(); }
+
+      // Waits until the file at index has been read and returns the result of
+      // reading it. The buffer is held until Release() is called with the same
+      // index. Files must be acquired and released in list order; a file that
+      // has already been released is not read again and yields RESULT_STATE.
+      Result_t Acquire(ui32_t index, ByteString*& buffer);
+      void     Release(ui32_t index);
+    };
+
   Result_t CreateDirectoriesInPath(const std::string& Path);
   Result_t FreeSpaceForPath(const std::string& path, Kumu::fsize_t& free_space, Kumu::fsize_t& total_space);
   Result_t DeleteFile(const std::string& filename);
@@ -39,6 +39,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <list>
 #include <map>
 #include <string>
+#include <vector>
 
 const char*
 Kumu::Version()
@@ -1250,6 +1251,75 @@ Kumu::km_token_split(const std::string& str, const std::string& separator)
   return components;
 }
 
+//------------------------------------------------------------------------------------------
+//
+
+// Shared by the threads started in RunWorkQueue().
+struct WorkQueueState
+{
+  Kumu::Mutex lock;
+  Kumu::IWorkItemHandler& handler;
+  ui32_t item_count;
+  ui32_t next_item;
+
+  WorkQueueState(Kumu::IWorkItemHandler& h, ui32_t c) : handler(h), item_count(c), next_item(0) {}
+
+  void Run()
+  {
+    for (;;)
+      {
+	ui32_t i;
+
+	{
+	  Kumu::AutoMutex l(lock);
+	  if ( next_item == item_count )
+	    break;
+
+	  i = next_item++;
+	}
+
+	handler.HandleItem(i);
+      }
+  }
+
+#ifndef KM_WIN32
+  static void* ThreadMain(void* arg)
+  {
+    static_cast<WorkQueueState*>(arg)->Run();
+    return 0;
+  }
+#endif
+};
+
+//
+void
+Kumu::RunWorkQueue(ui32_t item_count, ui32_t thread_count, IWorkItemHandler& handler)
+{
+  WorkQueueState queue(handler, item_count);
+
+#ifndef KM_WIN32
+  std::vector<pthread_t> threads;
+  ui32_t extra_threads = xmin<ui32_t>(thread_count, item_count);
+
+  for ( ui32_t i = 1; i < extra_threads; ++i )
+    {
+      pthread_t thread;
+
+      if ( pthread_create(&thread, 0, &WorkQueueState::ThreadMain, &queue) != 0 )
+	break;
+
+      threads.push_back(thread);
+    }
+#endif
+
+  queue.Run();
+
+#ifndef KM_WIN32
+  for ( ui32_t i = 0; i < threads.size(); ++i )
+    pthread_join(threads[i], 0);
+#endif
+}
+
 //
 // end KM_util.cpp
 //
@@ -615,6 +615,20 @@ namespace Kumu
       return result;
     }
 
+  // Receives the items handed out by RunWorkQueue().
+  class IWorkItemHandler
+  {
+  public:
+    virtual ~IWorkItemHandler() {}
+    virtual void HandleItem(ui32_t index) = 0; // may be called on several threads at once
+  };
+
+  // Calls handler.HandleItem() once for each index in [0, item_count), using up to
+  // thread_count threads including the caller, each of which claims the next unclaimed
+  // index. Returns when every item has been handled. Zero or one thread, a failure to
+  // start a thread, or a Win32 build leaves the remaining work to the calling thread.
+  void RunWorkQueue(ui32_t item_count, ui32_t thread_count, IWorkItemHandler& handler);
+
 } // namespace Kumu
 
 
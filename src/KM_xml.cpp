@@ -34,6 +34,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <KM_mutex.h>
 #include <stack>
 #include <map>
+#include <vector>
 
 #ifdef HAVE_EXPAT
 # ifdef HAVE_XERCES_C
@@ -415,6 +416,57 @@ Kumu::XMLElement::ParseFirstFromString(const std::string& document)
 }
 
 
+//
+bool
+Kumu::ParseXMLStream(const std::string& document, IXMLStreamHandler& handler)
+{
+  return ParseXMLStream(document.c_str(), document.size(), handler);
+}
+
+// open element stack for ParseXMLStream(); only the bodies the handler asked
+// for are accumulated
+class XMLStreamContext
+{
+  struct ScopeEntry
+  {
+    std::string name;
+    std::string body;
+    bool        want_body;
+  };
+
+  std::vector<ScopeEntry> m_Scope;
+  IXMLStreamHandler&      m_Handler;
+
+  KM_NO_COPY_CONSTRUCT(XMLStreamContext);
+  XMLStreamContext();
+
+public:
+  XMLStreamContext(IXMLStreamHandler& handler) : m_Handler(handler) {}
+  ~XMLStreamContext() {}
+
+  void Start(const std::string& ns_name, const std::string& name, const AttributeList& attrs)
+  {
+    ui32_t depth = m_Scope.size();
+    m_Scope.push_back(ScopeEntry());
+    m_Scope.back().name = name;
+    m_Scope.back().want_body = m_Handler.StartElement(ns_name, name, attrs, depth);
+  }
+
+  void End()
+  {
+    assert(!m_Scope.empty());
+    ScopeEntry& entry = m_Scope.back();
+    m_Handler.EndElement(entry.name, entry.body, m_Scope.size() - 1);
+    m_Scope.pop_back();
+  }
+
+  void Characters(const char* data, ui32_t len)
+  {
+    if ( ! m_Scope.empty() && m_Scope.back().want_body )
+      m_Scope.back().body.append(data, len);
+  }
+};
+
 //----------------------------------------------------------------------------------------------------
 
 #ifdef HAVE_EXPAT
@@ -630,6 +682,94 @@ Kumu::XMLElement::ParseFirstFromString(const char* document, ui32_t doc_len)
   return true;
 }
 
+// expat wrapper functions for ParseXMLStream()
+//
+static void
+xph_stream_start(void* p, const XML_Char* name, const XML_Char** attrs)
+{
+  assert(p);  assert(name);  assert(attrs);
+  XMLStreamContext* Ctx = (XMLStreamContext*)p;
+  std::string ns_name;
+
+  const char* local_name = strchr(name, '|');
+  if ( local_name != 0 )
+    {
+      ns_name.assign(name, local_name - name);
+      name = local_name + 1;
+    }
+
+  AttributeList attr_list;
+
+  for ( int i = 0; attrs[i] != 0; i += 2 )
+    {
+      if ( ( local_name = strchr(attrs[i], '|') ) == 0 )
+	local_name = attrs[i];
+      else
+	local_name++;
+
+      NVPair TmpVal;
+      TmpVal.name = local_name;
+      TmpVal.value = attrs[i+1];
+      attr_list.push_back(TmpVal);
+    }
+
+  Ctx->Start(ns_name, name, attr_list);
+}
+
+//
+static void
+xph_stream_end(void* p, const XML_Char* name)
+{
+  assert(p);  assert(name);
+  XMLStreamContext* Ctx = (XMLStreamContext*)p;
+  Ctx->End();
+}
+
+//
+static void
+xph_stream_char(void* p, const XML_Char* data, int len)
+{
+  assert(p);  assert(data);
+  XMLStreamContext* Ctx = (XMLStreamContext*)p;
+
+  if ( len > 0 )
+    Ctx->Characters(data, len);
+}
+
+//
+bool
+Kumu::ParseXMLStream(const char* document, ui32_t doc_len, IXMLStreamHandler& handler)
+{
+  if ( doc_len == 0 )
+    {
+      return false;
+    }
+
+  XML_Parser Parser = XML_ParserCreateNS("UTF-8", '|');
+
+  if ( Parser == 0 )
+    {
+      DefaultLogSink().Error("Error allocating memory for XML parser.\n");
+      return false;
+    }
+
+  XMLStreamContext Ctx(handler);
+  XML_SetUserData(Parser, (void*)&Ctx);
+  XML_SetElementHandler(Parser, xph_stream_start, xph_stream_end);
+  XML_SetCharacterDataHandler(Parser, xph_stream_char);
+
+  if ( ! XML_Parse(Parser, document, doc_len, 1) )
+    {
+      DefaultLogSink().Error("XML Parse error on line %d: %s\n",
+			     XML_GetCurrentLineNumber(Parser),
+			     XML_ErrorString(XML_GetErrorCode(Parser)));
+      XML_ParserFree(Parser);
+      return false;
+    }
+
+  XML_ParserFree(Parser);
+  return true;
+}
 
 
 #endif
@@ -978,7 +1118,13 @@ Kumu::XMLElement::ParseString(const char* document, ui32_t doc_len)
       DefaultLogSink().Error("Unexpected XML parser error\n");
       errorCount++;
     }
-  
+
+  if ( errorCount == 0 && docHandler->HasEncodeErrors() )
+    {
+      DefaultLogSink().Error("XML document contains text that could not be converted to UTF-8.\n");
+      errorCount++;
+    }
+
   if ( errorCount == 0 )
     m_NamespaceOwner = (void*)docHandler->TakeNamespaceMap();
 
@@ -1070,6 +1216,161 @@ Kumu::XMLElement::ParseFirstFromString(const char* document, ui32_t doc_len)
   return errorCount > 0 ? false : true;
 }
 
+//
+class MyStreamHandler : public HandlerBase
+{
+  std::map<std::string, std::string> m_Namespaces; // prefix -> name
+  XMLStreamContext m_Context;
+  bool             m_HasEncodeErrors;
+
+public:
+  MyStreamHandler(IXMLStreamHandler& handler) : m_Context(handler), m_HasEncodeErrors(false) {}
+  ~MyStreamHandler() {}
+
+  bool HasEncodeErrors() const { return m_HasEncodeErrors; }
+
+  //
+  void startElement(const XMLCh* const x_name,
+		    XERCES_CPP_NAMESPACE::AttributeList& attributes)
+  {
+    assert(x_name);
+    std::string tx_name;
+
+    if ( ! kumu_XercesString_to_UTF_8(x_name, tx_name) )
+      m_HasEncodeErrors = true;
+
+    const char* name = tx_name.c_str();
+    const char* ns_root = name;
+    const char* local_name = strchr(name, ':');
+
+    if ( local_name != 0 )
+      name = local_name + 1;
+
+    AttributeList attr_list;
+    ui32_t a_len = attributes.getLength();
+
+    for ( ui32_t i = 0; i < a_len; i++)
+      {
+	NVPair TmpVal;
+	std::string aname;
+
+	if ( ! kumu_XercesString_to_UTF_8(attributes.getName(i), aname) )
+	  m_HasEncodeErrors = true;
+
+	if ( ! kumu_XercesString_to_UTF_8(attributes.getValue(i), TmpVal.value) )
+	  m_HasEncodeErrors = true;
+
+	const char* x_aname = aname.c_str();
+
+	if ( strncmp(x_aname, "xmlns", 5) == 0 )
+	  {
+	    const char* ns_prefix = ( x_aname[5] == ':' ) ? x_aname + 6 : "";
+	    m_Namespaces.insert(std::map<std::string, std::string>::value_type(ns_prefix, TmpVal.value));
+	  }
+
+	if ( ( local_name = strchr(x_aname, ':') ) == 0 )
+	  local_name = x_aname;
+	else
+	  local_name++;
+
+	TmpVal.name = local_name;
+	attr_list.push_back(TmpVal);
+      }
+
+    // map the namespace
+    std::string key, ns_name;
+    if ( ns_root != name )
+      key.assign(ns_root, name - ns_root - 1);
+
+    std::map<std::string, std::string>::const_iterator ni = m_Namespaces.find(key);
+    if ( ni != m_Namespaces.end() )
+      ns_name = ni->second;
+
+    m_Context.Start(ns_name, name, attr_list);
+  }
+
+  void endElement(const XMLCh *const name) {
+    m_Context.End();
+  }
+
+#if XERCES_VERSION_MAJOR < 3
+  void characters(const XMLCh *const chars, const unsigned int length)
+#else
+  void characters(const XMLCh* const chars, const XMLSize_t length)
+#endif
+  {
+    if ( length > 0 )
+      {
+	std::string tmp;
+	if ( ! kumu_XercesString_to_UTF_8(chars, tmp) )
+	  m_HasEncodeErrors = true;
+
+	m_Context.Characters(tmp.c_str(), tmp.size());
+      }
+  }
+};
+
+//
+bool
+Kumu::ParseXMLStream(const char* document, ui32_t doc_len, IXMLStreamHandler& handler)
+{
+  if ( doc_len == 0 )
+    {
+      return false;
+    }
+
+  kumu_init_xml_dom();
+
+  int errorCount = 0;
+  SAXParser* parser = new SAXParser();
+
+  parser->setValidationScheme(SAXParser::Val_Always);
+  parser->setDoNamespaces(true);    // optional
+
+  MyStreamHandler* docHandler = new MyStreamHandler(handler);
+  parser->setDocumentHandler(docHandler);
+  parser->setErrorHandler(docHandler);
+
+  try
+    {
+      MemBufInputSource xmlSource(reinterpret_cast<const XMLByte*>(document),
+				  static_cast<const unsigned int>(doc_len),
+				  "pidc_rules_file");
+
+      parser->parse(xmlSource);
+    }
+  catch (const XMLException& e)
+    {
+      char* message = XMLString::transcode(e.getMessage());
+      DefaultLogSink().Error("Parser error: %s\n", message);
+      XMLString::release(&message);
+      errorCount++;
+    }
+  catch (const SAXParseException& e)
+    {
+      char* message = XMLString::transcode(e.getMessage());
+      DefaultLogSink().Error("Parser error: %s at line %d\n", message, e.getLineNumber());
+      XMLString::release(&message);
+      errorCount++;
+    }
+  catch (...)
+    {
+      DefaultLogSink().Error("Unexpected XML parser error\n");
+      errorCount++;
+    }
+
+  if ( errorCount == 0 && docHandler->HasEncodeErrors() )
+    {
+      DefaultLogSink().Error("XML document contains text that could not be converted to UTF-8.\n");
+      errorCount++;
+    }
+
+  delete parser;
+  delete docHandler;
+
+  return errorCount > 0 ? false : true;
+}
+
 
 #endif
 
@@ -1092,6 +1393,13 @@ Kumu::XMLElement::ParseFirstFromString(const char*, ui32_t)
   return false;
 }
 
+bool
+Kumu::ParseXMLStream(const char*, ui32_t, IXMLStreamHandler&)
+{
+  DefaultLogSink().Error("Kumu compiled without XML parser support.\n");
+  return false;
+}
+
 #endif
 
 
@@ -145,6 +145,28 @@ namespace Kumu
       void        ForgetChild(const XMLElement* element);
     };
 
+  // Receives events from ParseXMLStream(). Element and attribute names are
+  // local names (prefixes removed), as they are stored by XMLElement.
+  class IXMLStreamHandler
+  {
+  public:
+    virtual ~IXMLStreamHandler() {}
+
+    // Called for each start tag; depth is zero for the document element. Return
+    // true to have the element's character data delivered to EndElement().
+    virtual bool StartElement(const std::string& ns_name, const std::string& name,
+			      const AttributeList& attrs, ui32_t depth) = 0;
+
+    // Called for each end tag. body is empty unless StartElement() asked for it.
+    virtual void EndElement(const std::string& name, const std::string& body, ui32_t depth) = 0;
+  };
+
+  // Parses a document without building an element tree. The document itself must
+  // be held in memory by the caller; beyond that, the parser keeps only the open
+  // element names and the bodies requested by the handler.
+  bool ParseXMLStream(const char* document, ui32_t doc_len, IXMLStreamHandler& handler);
+  bool ParseXMLStream(const std::string& document, IXMLStreamHandler& handler);
+
   //
   template <class VisitorType>
     bool
@@ -206,7 +228,7 @@ namespace Kumu
 
     bool Element(const XMLElement& e)
     {
-      if ( e.GetBody() == element_name )
+      if ( e.GetName() == element_name )
 	{
 	  value_list.insert(e.GetBody());
 	}
@@ -33,6 +33,10 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Metadata.h"
 #include <KM_log.h>
 
+#ifndef KM_WIN32
+#include <pthread.h>
+#endif
+
 using Kumu::DefaultLogSink;
 using Kumu::GenRandomValue;
 
@@ -185,6 +189,16 @@ ASDCP::MXF::RIP::Dump(FILE* stream)
 //------------------------------------------------------------------------------------------
 //
 
+// Set types are compared without the version byte, as UL::operator== does.
+static ASDCP::UL
+s_set_type_key(const byte_t* ul)
+{
+  byte_t key_buf[ASDCP::SMPTE_UL_LENGTH];
+  memcpy(key_buf, ul, ASDCP::SMPTE_UL_LENGTH);
+  key_buf[7] = 0;
+  return ASDCP::UL(key_buf);
+}
+
 //
 ASDCP::MXF::Partition::PacketList::~PacketList() {
   while ( ! m_List.empty() )
@@ -197,10 +211,42 @@ ASDCP::MXF::Partition::PacketList::~PacketList() {
 //
 void
 ASDCP::MXF::Partition::PacketList::AddPacket(InterchangeObject* ThePacket) // takes ownership
+{
+  InsertPacket(m_List.end(), ThePacket);
+}
+
+//
+std::list<ASDCP::MXF::InterchangeObject*>::iterator
+ASDCP::MXF::Partition::PacketList::InsertPacket(std::list<InterchangeObject*>::iterator pos,
+						InterchangeObject* ThePacket) // takes ownership
 {
   assert(ThePacket);
   m_Map.insert(std::map<UUID, InterchangeObject*>::value_type(ThePacket->InstanceUID, ThePacket));
-  m_List.push_back(ThePacket);
+  bool at_end = ( pos == m_List.end() );
+  pos = m_List.insert(pos, ThePacket);
+
+  UL packet_ul = ThePacket->GetUL();
+
+  if ( packet_ul.HasValue() )
+    {
+      TypeBucket& bucket = m_TypeMap[s_set_type_key(packet_ul.Value())];
+
+      if ( ! at_end && ! bucket.Objects.empty() )
+	bucket.InListOrder = false;
+
+      bucket.Objects.push_back(ThePacket);
+    }
+
+  return pos;
+}
+
+//
+void
+ASDCP::MXF::Partition::PacketList::Clear()
+{
+  m_List.clear();
+  m_Map.clear();
+  m_TypeMap.clear();
 }
 
 //
@@ -232,30 +278,75 @@ ASDCP::MXF::Partition::PacketList::DeleteMDObjectByID(const UUID& ObjectID)
        return RESULT_FAIL;
     }
 
-  delete (*mi).second;
+  InterchangeObject* object = (*mi).second;
+  UL packet_ul = object->GetUL();
+
+  if ( packet_ul.HasValue() )
+    {
+      std::map<UL, TypeBucket>::iterator ti = m_TypeMap.find(s_set_type_key(packet_ul.Value()));
+
+      if ( ti != m_TypeMap.end() )
+	{
+	  ti->second.Objects.remove(object);
+
+	  if ( ti->second.Objects.empty() )
+	    m_TypeMap.erase(ti);
+	}
+    }
+
+  m_List.remove(object);
   m_Map.erase(mi);
+  delete object;
   return RESULT_OK;
 }
 
+// Returns the bucket for the given type with its objects in m_List order,
+// or 0 if there are no objects of that type.
+ASDCP::MXF::Partition::PacketList::TypeBucket*
+ASDCP::MXF::Partition::PacketList::FindTypeBucket(const byte_t* ObjectID)
+{
+  UL key = s_set_type_key(ObjectID);
+  std::map<UL, TypeBucket>::iterator ti = m_TypeMap.find(key);
+
+  if ( ti == m_TypeMap.end() )
+    return 0;
+
+  TypeBucket& bucket = ti->second;
+
+  if ( ! bucket.InListOrder )
+    {
+      bucket.Objects.clear();
+      std::list<InterchangeObject*>::iterator li;
+
+      for ( li = m_List.begin(); li != m_List.end(); li++ )
+	{
+	  UL packet_ul = (*li)->GetUL();
+
+	  if ( packet_ul.HasValue() && s_set_type_key(packet_ul.Value()) == key )
+	    bucket.Objects.push_back(*li);
+	}
+
+      bucket.InListOrder = true;
+    }
+
+  return &bucket;
+}
+
 //
 ASDCP::Result_t
 ASDCP::MXF::Partition::PacketList::GetMDObjectByType(const byte_t* ObjectID, InterchangeObject** Object)
 {
   ASDCP_TEST_NULL(ObjectID);
   ASDCP_TEST_NULL(Object);
-  std::list<InterchangeObject*>::iterator li;
   *Object = 0;
 
-  for ( li = m_List.begin(); li != m_List.end(); li++ )
-    {
-      if ( (*li)->HasUL(ObjectID) )
-	{
-	  *Object = *li;
-	  return RESULT_OK;
-	}
-    }
+  TypeBucket* bucket = FindTypeBucket(ObjectID);
 
-  return RESULT_FAIL;
+  if ( bucket == 0 )
+    return RESULT_FAIL;
+
+  *Object = bucket->Objects.front();
+  return RESULT_OK;
 }
 
 //
@@ -263,13 +354,10 @@ ASDCP::Result_t
 ASDCP::MXF::Partition::PacketList::GetMDObjectsByType(const byte_t* ObjectID, std::list<InterchangeObject*>& ObjectList)
 {
   ASDCP_TEST_NULL(ObjectID);
-  std::list<InterchangeObject*>::iterator li;
+  TypeBucket* bucket = FindTypeBucket(ObjectID);
 
-  for ( li = m_List.begin(); li != m_List.end(); li++ )
-    {
-      if ( (*li)->HasUL(ObjectID) )
-	ObjectList.push_back(*li);
-    }
+  if ( bucket != 0 )
+    ObjectList.insert(ObjectList.end(), bucket->Objects.begin(), bucket->Objects.end());
 
   return ObjectList.empty() ? RESULT_FAIL : RESULT_OK;
 }
@@ -432,15 +520,101 @@ ASDCP::MXF::Partition::Dump(FILE* stream)
 //------------------------------------------------------------------------------------------
 //
 
-class ASDCP::MXF::Primer::h__PrimerLookup : public std::map<UL, TagValue>
+// Open-addressed hash of primer ULs to local tags. Primers carry at most a few
+// hundred entries, so the table is kept at or below half full by doubling.
+class ASDCP::MXF::Primer::h__PrimerLookup
 {
+  struct Slot
+  {
+    byte_t   ul[SMPTE_UL_LENGTH];
+    TagValue tag;
+    bool     used;
+  };
+
+  std::vector<Slot> m_Slots;
+  ui32_t            m_Count;
+
+  Slot& find_slot(const byte_t* ul)
+  {
+    ui32_t mask = (ui32_t)m_Slots.size() - 1;
+    ui32_t i = HashUL(ul) & mask;
+
+    while ( m_Slots[i].used && memcmp(m_Slots[i].ul, ul, SMPTE_UL_LENGTH) != 0 )
+      i = ( i + 1 ) & mask;
+
+    return m_Slots[i];
+  }
+
+  void grow()
+  {
+    std::vector<Slot> old_slots(m_Slots.size() * 2);
+    old_slots.swap(m_Slots);
+
+    for ( ui32_t i = 0; i < m_Slots.size(); ++i )
+      m_Slots[i].used = false;
+
+    for ( ui32_t i = 0; i < old_slots.size(); ++i )
+      {
+	if ( old_slots[i].used )
+	  find_slot(old_slots[i].ul) = old_slots[i];
+      }
+  }
+
 public:
+  // TagForEntry() results, indexed by position in the primer's dictionary
+  enum CacheState_t { CS_UNKNOWN = 0, CS_FOUND, CS_MISSING };
+  std::vector<ui8_t>    TagCacheState;
+  std::vector<TagValue> TagCache;
+
+  h__PrimerLookup() : m_Slots(64), m_Count(0)
+  {
+    for ( ui32_t i = 0; i < m_Slots.size(); ++i )
+      m_Slots[i].used = false;
+  }
+
+  inline bool empty() const { return m_Count == 0; }
+
+  // returns false if the UL is not present
+  bool Find(const UL& ul, TagValue& tag)
+  {
+    const Slot& slot = find_slot(ul.Value());
+
+    if ( ! slot.used )
+      return false;
+
+    tag = slot.tag;
+    return true;
+  }
+
+  // the first tag inserted for a UL is kept
+  void Insert(const UL& ul, const TagValue& tag)
+  {
+    if ( ( m_Count + 1 ) * 2 > m_Slots.size() )
+      grow();
+
+    Slot& slot = find_slot(ul.Value());
+
+    if ( ! slot.used )
+      {
+	memcpy(slot.ul, ul.Value(), SMPTE_UL_LENGTH);
+	slot.tag = tag;
+	slot.used = true;
+	++m_Count;
+      }
+  }
+
+  void ClearTagCache()
+  {
+    TagCacheState.clear();
+    TagCache.clear();
+  }
+
   void InitWithBatch(ASDCP::MXF::Batch<ASDCP::MXF::Primer::LocalTagEntry>& Batch)
   {
     ASDCP::MXF::Batch<ASDCP::MXF::Primer::LocalTagEntry>::iterator i = Batch.begin();
 
     for ( ; i != Batch.end(); i++ )
-      insert(std::map<UL, TagValue>::value_type((*i).UL, (*i).Tag));
+      Insert((*i).UL, (*i).Tag);
   }
 };
 
@@ -534,9 +708,8 @@ ASDCP::MXF::Primer::InsertTag(const MDDEntry& Entry, ASDCP::TagValue& Tag)
 {
   assert(m_Lookup);
   UL TestUL(Entry.ul);
-  std::map<UL, TagValue>::iterator i = m_Lookup->find(TestUL);
 
-  if ( i == m_Lookup->end() )
+  if ( ! m_Lookup->Find(TestUL, Tag) )
     {
       if ( Entry.tag.a == 0 && Entry.tag.b == 0 )
 	{
@@ -554,11 +727,8 @@ ASDCP::MXF::Primer::InsertTag(const MDDEntry& Entry, ASDCP::TagValue& Tag)
       TmpEntry.Tag = Tag;
 
       LocalTagEntryBatch.insert(TmpEntry);
-      m_Lookup->insert(std::map<UL, TagValue>::value_type(TmpEntry.UL, TmpEntry.Tag));
-    }
-  else
-    {
-      Tag = (*i).second;
+      m_Lookup->Insert(TmpEntry.UL, TmpEntry.Tag);
+      m_Lookup->ClearTagCache();
     }
    
   return RESULT_OK;
@@ -575,15 +745,56 @@ ASDCP::MXF::Primer::TagForKey(const ASDCP::UL& Key, ASDCP::TagValue& Tag)
       return RESULT_FAIL;
     }
 
-  std::map<UL, TagValue>::iterator i = m_Lookup->find(Key);
-
-  if ( i == m_Lookup->end() )
+  if ( ! m_Lookup->Find(Key, Tag) )
     return RESULT_FALSE;
 
-  Tag = (*i).second;
   return RESULT_OK;
 }
 
+// Entries from the primer's own dictionary are resolved once; the answer is
+// then served from a table indexed by the entry's position in the dictionary.
+ASDCP::Result_t
+ASDCP::MXF::Primer::TagForEntry(const MDDEntry& Entry, ASDCP::TagValue& Tag)
+{
+  assert(m_Dict);
+  const MDDEntry* table = m_Dict->m_MDD_Table;
+
+  if ( m_Lookup.empty() || &Entry < table || &Entry >= table + (ui32_t)MDD_Max )
+    return TagForKey(UL(Entry.ul), Tag);
+
+  ui32_t index = (ui32_t)(&Entry - table);
+
+  if ( m_Lookup->TagCacheState.empty() )
+    {
+      m_Lookup->TagCacheState.resize((ui32_t)MDD_Max, h__PrimerLookup::CS_UNKNOWN);
+      m_Lookup->TagCache.resize((ui32_t)MDD_Max);
+    }
+
+  switch ( m_Lookup->TagCacheState[index] )
+    {
+    case h__PrimerLookup::CS_FOUND:
+      Tag = m_Lookup->TagCache[index];
+      return RESULT_OK;
+
+    case h__PrimerLookup::CS_MISSING:
+      return RESULT_FALSE;
+    }
+
+  Result_t result = TagForKey(UL(Entry.ul), Tag);
+
+  if ( result == RESULT_OK )
+    {
+      m_Lookup->TagCache[index] = Tag;
+      m_Lookup->TagCacheState[index] = h__PrimerLookup::CS_FOUND;
+    }
+  else if ( result == RESULT_FALSE )
+    {
+      m_Lookup->TagCacheState[index] = h__PrimerLookup::CS_MISSING;
+    }
+
+  return result;
+}
+
 //
 void
 ASDCP::MXF::Primer::Dump(FILE* stream)
@@ -756,14 +967,136 @@ ASDCP::MXF::Preface::Dump(FILE* stream)
 //------------------------------------------------------------------------------------------
 //
 
+// Raw sets of a header read in lazy mode, in file order. Decoded sets keep
+// their position in the packet list so that it stays in file order.
+class ASDCP::MXF::OP1aHeader::h__LazySetIndex
+{
+public:
+  struct SetEntry
+  {
+    const byte_t*      p;
+    ui32_t             length;
+    InterchangeObject* object;   // 0 until decoded
+    bool               dropped;  // deleted, or failed to decode
+    std::list<InterchangeObject*>::iterator pos;
+
+    SetEntry(const byte_t* buf, ui32_t len) : p(buf), length(len), object(0), dropped(false) {}
+  };
+
+  std::vector<SetEntry>  Sets;
+  std::map<UUID, ui32_t> IDIndex;
+  std::map<UL, std::vector<ui32_t> > TypeIndex; // set positions by version-masked set UL, in file order
+};
+
+//
 ASDCP::MXF::OP1aHeader::OP1aHeader(const Dictionary* d) :
-  Partition(d), m_Primer(d), m_Preface(0)
+  Partition(d), m_ArenaMode(false), m_LazyMode(false), m_Primer(d), m_Preface(0)
 {
   assert(m_Dict);
 }
 
 ASDCP::MXF::OP1aHeader::~OP1aHeader() {}
 
+// Reads the header metadata that follows the partition pack into Buffer, which
+// must have a capacity of at least header_length bytes. The packets are walked
+// as they arrive and reading stops at a fill item that runs to the end of the
+// header metadata, so the padding that writers reserve for later header updates
+// is never fetched. Buffer's length is set to the number of bytes to be parsed,
+// and the file is left positioned at the end of the header metadata.
+static ASDCP::Result_t
+s_ReadHeaderMetadata(const Kumu::IFileReader& Reader, const ASDCP::Dictionary& Dict,
+		     ui32_t header_length, Kumu::ByteString& Buffer)
+{
+  const ui32_t ReadChunkSize = 64 * Kumu::Kilobyte;
+  const ASDCP::UL fill_ul(Dict.ul(ASDCP::MDD_KLVFill));
+  Kumu::fpos_t start_pos = 0;
+  ui32_t have = 0;                  // bytes read so far
+  ui32_t parsed = 0;                // offset of the first packet not yet walked
+  ui32_t length = header_length;    // bytes of header metadata preceding the trailing fill
+  ui32_t wanted = Kumu::xmin(header_length, ReadChunkSize);
+  bool walking = true;              // cleared at the trailing fill or on a malformed packet
+
+  ASDCP::Result_t result = Reader.Tell(&start_pos);
+
+  while ( ASDCP_SUCCESS(result) )
+    {
+      if ( wanted > have )
+	{
+	  ui32_t read_count = 0;
+	  result = Reader.Read(Buffer.Data() + have, wanted - have, &read_count);
+
+	  if ( ASDCP_FAILURE(result) )
+	    {
+	      DefaultLogSink().Error("OP1aHeader::InitFromFile, read failed.\n");
+	      return result;
+	    }
+
+	  if ( read_count != wanted - have )
+	    {
+	      DefaultLogSink().Error("Short read of OP-Atom header metadata; wanted %u, got %u.\n",
+				     header_length, have + read_count);
+	      return ASDCP::RESULT_KLV_CODING(__LINE__, __FILE__);
+	    }
+
+	  have = wanted;
+	}
+
+      ui64_t needed = have; // the number of bytes required to walk the next packet
+
+      while ( walking && parsed < have )
+	{
+	  const byte_t* p = Buffer.RoData() + parsed;
+	  ui32_t ber_len = ( have - parsed > ASDCP::SMPTE_UL_LENGTH ) ? Kumu::BER_length(p + ASDCP::SMPTE_UL_LENGTH) : 0;
+	  ui64_t value_len = 0;
+
+	  if ( have - parsed <= ASDCP::SMPTE_UL_LENGTH || ( ber_len > 0 && have - parsed < ASDCP::SMPTE_UL_LENGTH + ber_len ) )
+	    {
+	      needed = parsed + ASDCP::SMPTE_UL_LENGTH + ASDCP::MXF_BER_LENGTH;
+	      break;
+	    }
+
+	  if ( ber_len == 0 || ! Kumu::read_BER(p + ASDCP::SMPTE_UL_LENGTH, &value_len) )
+	    {
+	      walking = false; // leave the error reporting to the parser
+	      break;
+	    }
+
+	  ui64_t packet_end = parsed + ASDCP::SMPTE_UL_LENGTH + ber_len + value_len;
+
+	  if ( packet_end >= header_length && ASDCP::UL(p) == fill_ul )
+	    {
+	      length = parsed;
+	      walking = false;
+	      break;
+	    }
+
+	  if ( packet_end > have )
+	    {
+	      needed = packet_end;
+	      break;
+	    }
+
+	  parsed = (ui32_t)packet_end;
+	}
+
+      if ( length < header_length || have == header_length )
+	break;
+
+      // read at least the next packet, doubling the amount read to bound the number of reads
+      wanted = walking ? (ui32_t)Kumu::xmin<ui64_t>(header_length, Kumu::xmax<ui64_t>(needed, have * 2)) : header_length;
+    }
+
+  if ( ASDCP_SUCCESS(result) )
+    {
+      Buffer.Length(length);
+
+      if ( have < header_length )
+	result = Reader.Seek(start_pos + header_length);
+    }
+
+  return result;
+}
+
 //
 ASDCP::Result_t
 ASDCP::MXF::OP1aHeader::InitFromFile(const Kumu::IFileReader& Reader)
@@ -801,29 +1134,18 @@ ASDCP::MXF::OP1aHeader::InitFromFile(const Kumu::IFileReader& Reader)
       DefaultLogSink().Warn("Improbably huge HeaderByteCount value: %llu\n", HeaderByteCount);
     }
   
-  result = m_HeaderData.Capacity(Kumu::xmin(4*Kumu::Megabyte, static_cast<ui32_t>(HeaderByteCount)));
+  ui32_t header_length = Kumu::xmin(4*Kumu::Megabyte, static_cast<ui32_t>(HeaderByteCount));
+  result = m_HeaderData.Capacity(header_length);
 
   if ( ASDCP_SUCCESS(result) )
-    {
-      ui32_t read_count;
-      result = Reader.Read(m_HeaderData.Data(), m_HeaderData.Capacity(), &read_count);
-
-      if ( ASDCP_FAILURE(result) )
-        {
-	  DefaultLogSink().Error("OP1aHeader::InitFromFile, read failed.\n");
-	  return result;
-        }
-
-      if ( read_count != m_HeaderData.Capacity() )
-	{
-	  DefaultLogSink().Error("Short read of OP-Atom header metadata; wanted %u, got %u.\n",
-				 m_HeaderData.Capacity(), read_count);
-	  return RESULT_KLV_CODING(__LINE__, __FILE__);
-	}
-    }
+    result = s_ReadHeaderMetadata(Reader, *m_Dict, header_length, m_HeaderData);
 
   if ( ASDCP_SUCCESS(result) )
-    result = InitFromBuffer(m_HeaderData.RoData(), m_HeaderData.Capacity());
+    result = InitFromBuffer(m_HeaderData.RoData(), m_HeaderData.Length());
+
+  // the trailing fill item was not read; report what parsing it would have
+  if ( ASDCP_SUCCESS(result) && m_HeaderData.Length() < header_length )
+    result = RESULT_OK;
 
   return result;
 }
@@ -852,10 +1174,63 @@ ASDCP::MXF::OP1aHeader::InitFromBuffer(const byte_t* p, ui32_t l)
 {
   assert(m_Dict);
   Result_t result = RESULT_OK;
+
+  if ( m_LazyMode )
+    {
+      // sets are decoded later, so the raw header must stay available
+      if ( m_HeaderData.Capacity() == 0
+	   || p < m_HeaderData.RoData() || p + l > m_HeaderData.RoData() + m_HeaderData.Capacity() )
+	{
+	  result = m_HeaderData.Capacity(l);
+
+	  if ( ASDCP_SUCCESS(result) )
+	    result = m_HeaderData.Set(p, l);
+
+	  if ( ASDCP_FAILURE(result) )
+	    return result;
+
+	  p = m_HeaderData.RoData();
+	}
+
+      if ( m_LazySets.empty() )
+	m_LazySets = new h__LazySetIndex;
+    }
+
   const byte_t* end_p = p + l;
 
+  if ( m_ArenaMode && m_Arena.empty() )
+    m_Arena = new ObjectArena(ObjectArena::DefaultBlockSize);
+
+  mem_ptr<ObjectArena::Scope> arena_scope;
+
+  if ( ! m_Arena.empty() )
+    arena_scope = new ObjectArena::Scope(*m_Arena);
+
   while ( ASDCP_SUCCESS(result) && p < end_p )
     {
+      if ( ! m_LazySets.empty() )
+	{
+	  // index the set; fill items, the primer and the preface are handled below
+	  KLVPacket tmp_packet;
+	  result = tmp_packet.InitFromBuffer(p, end_p - p);
+
+	  if ( ASDCP_SUCCESS(result)
+	       && ! ( UL(p) == UL(m_Dict->ul(MDD_KLVFill)) )
+	       && ! ( UL(p) == UL(m_Dict->ul(MDD_Primer)) )
+	       && ! ( UL(p) == UL(m_Dict->ul(MDD_Preface)) && m_Preface == 0 ) )
+	    {
+	      if ( p + tmp_packet.PacketLength() > end_p )
+		{
+		  DefaultLogSink().Error("Interchange Object value extends past buffer length.\n");
+		  return RESULT_KLV_CODING(__LINE__, __FILE__);
+		}
+
+	      m_LazySets->Sets.push_back(h__LazySetIndex::SetEntry(p, tmp_packet.PacketLength()));
+	      p += tmp_packet.PacketLength();
+	      continue;
+	    }
+	}
+
       // parse the packets and index them by uid, discard KLVFill items
       InterchangeObject* object = CreateObject(m_Dict, p);
       assert(object);
@@ -868,7 +1243,10 @@ ASDCP::MXF::OP1aHeader::InitFromBuffer(const byte_t* p, ui32_t l)
 
       if ( ASDCP_SUCCESS(result) )
 	{
-	  if ( object->IsA(m_Dict->ul(MDD_KLVFill)) )
+	  // the version byte is ignored, as in lookups by UL
+	  const UL set_ul(redo_p);
+
+	  if ( set_ul == UL(m_Dict->ul(MDD_KLVFill)) )
 	    {
 	      delete object;
 
@@ -877,7 +1255,7 @@ ASDCP::MXF::OP1aHeader::InitFromBuffer(const byte_t* p, ui32_t l)
 		  DefaultLogSink().Error("Fill item short read: %d.\n", p - end_p);
 		}
 	    }
-	  else if ( object->IsA(m_Dict->ul(MDD_Primer)) ) // TODO: only one primer should be found
+	  else if ( set_ul == UL(m_Dict->ul(MDD_Primer)) ) // TODO: only one primer should be found
 	    {
 	      delete object;
 	      result = m_Primer.InitFromBuffer(redo_p, end_p - redo_p);
@@ -886,8 +1264,17 @@ ASDCP::MXF::OP1aHeader::InitFromBuffer(const byte_t* p, ui32_t l)
 	    {
 	      m_PacketList->AddPacket(object); // takes ownership
 
-	      if ( object->IsA(m_Dict->ul(MDD_Preface)) && m_Preface == 0 )
+	      if ( set_ul == UL(m_Dict->ul(MDD_Preface)) && m_Preface == 0 )
 		m_Preface = (Preface*)object;
+
+	      if ( ! m_LazySets.empty() )
+		{
+		  m_LazySets->Sets.push_back(h__LazySetIndex::SetEntry(redo_p, object->PacketLength()));
+		  m_LazySets->Sets.back().object = object;
+		  m_LazySets->Sets.back().pos = --m_PacketList->m_List.end();
+		  m_LazySets->IDIndex.insert(std::map<UUID, ui32_t>::value_type(object->InstanceUID,
+										 m_LazySets->Sets.size() - 1));
+		}
 	    }
 	}
       else
@@ -898,13 +1285,162 @@ ASDCP::MXF::OP1aHeader::InitFromBuffer(const byte_t* p, ui32_t l)
 	}
     }
 
+  if ( ASDCP_SUCCESS(result) && ! m_LazySets.empty() )
+    {
+      // the primer is complete now; index the pending sets by InstanceUID
+      const MDDEntry& uid_entry = m_Dict->Type(MDD_InterchangeObject_InstanceUID);
+      TagValue uid_tag;
+
+      if ( m_Primer.TagForKey(uid_entry.ul, uid_tag) != RESULT_OK )
+	uid_tag = uid_entry.tag;
+
+      for ( ui32_t i = 0; i < m_LazySets->Sets.size(); ++i )
+	{
+	  h__LazySetIndex::SetEntry& entry = m_LazySets->Sets[i];
+	  m_LazySets->TypeIndex[s_set_type_key(entry.p)].push_back(i);
+
+	  if ( entry.object != 0 )
+	    continue;
+
+	  KLVPacket tmp_packet;
+	  if ( ASDCP_FAILURE(tmp_packet.InitFromBuffer(entry.p, entry.length)) )
+	    continue;
+
+	  const byte_t* tlv_p = entry.p + tmp_packet.KLLength();
+	  const byte_t* tlv_end = tlv_p + tmp_packet.ValueLength();
+
+	  while ( tlv_p + 4 <= tlv_end )
+	    {
+	      ui16_t item_len = KM_i16_BE(Kumu::cp2i<ui16_t>(tlv_p + 2));
+
+	      if ( tlv_p[0] == uid_tag.a && tlv_p[1] == uid_tag.b )
+		{
+		  if ( item_len == UUIDlen && tlv_p + 4 + UUIDlen <= tlv_end )
+		    m_LazySets->IDIndex.insert(std::map<UUID, ui32_t>::value_type(UUID(tlv_p + 4), i));
+
+		  break;
+		}
+
+	      tlv_p += 4 + item_len;
+	    }
+	}
+    }
+
   return result;
 }
 
+//
+ASDCP::Result_t
+ASDCP::MXF::OP1aHeader::DecodeLazySet(ui32_t index)
+{
+  assert(! m_LazySets.empty());
+  assert(index < m_LazySets->Sets.size());
+  h__LazySetIndex::SetEntry& entry = m_LazySets->Sets[index];
+
+  if ( entry.object != 0 )
+    return RESULT_OK;
+
+  if ( entry.dropped )
+    return RESULT_FAIL;
+
+  mem_ptr<ObjectArena::Scope> arena_scope;
+
+  if ( ! m_Arena.empty() )
+    arena_scope = new ObjectArena::Scope(*m_Arena);
+
+  InterchangeObject* object = CreateObject(m_Dict, entry.p);
+  assert(object);
+
+  object->m_Lookup = &m_Primer;
+  Result_t result = object->InitFromBuffer(entry.p, entry.length);
+
+  if ( ASDCP_FAILURE(result) )
+    {
+      DefaultLogSink().Error("Error initializing OP1a header packet.\n");
+      delete object;
+      entry.dropped = true;
+      return result;
+    }
+
+  // place the object before the next decoded set, or after the previous one
+  std::list<InterchangeObject*>::iterator insert_pos = m_PacketList->m_List.begin();
+  ui32_t i;
+
+  for ( i = index + 1; i < m_LazySets->Sets.size(); ++i )
+    {
+      if ( m_LazySets->Sets[i].object != 0 )
+	{
+	  insert_pos = m_LazySets->Sets[i].pos;
+	  break;
+	}
+    }
+
+  if ( i == m_LazySets->Sets.size() )
+    {
+      for ( i = index; i > 0; --i )
+	{
+	  if ( m_LazySets->Sets[i-1].object != 0 )
+	    {
+	      insert_pos = m_LazySets->Sets[i-1].pos;
+	      ++insert_pos;
+	      break;
+	    }
+	}
+    }
+
+  entry.pos = m_PacketList->InsertPacket(insert_pos, object);
+  entry.object = object;
+  return RESULT_OK;
+}
+
+//
+void
+ASDCP::MXF::OP1aHeader::DecodeLazySets(const byte_t* ObjectID)
+{
+  if ( m_LazySets.empty() )
+    return;
+
+  if ( ObjectID != 0 )
+    {
+      std::map<UL, std::vector<ui32_t> >::iterator ti = m_LazySets->TypeIndex.find(s_set_type_key(ObjectID));
+
+      if ( ti != m_LazySets->TypeIndex.end() )
+	{
+	  std::vector<ui32_t>::iterator i;
+
+	  for ( i = ti->second.begin(); i != ti->second.end(); ++i )
+	    {
+	      h__LazySetIndex::SetEntry& entry = m_LazySets->Sets[*i];
+
+	      if ( entry.object == 0 && ! entry.dropped )
+		DecodeLazySet(*i);
+	    }
+	}
+
+      return;
+    }
+
+  for ( ui32_t i = 0; i < m_LazySets->Sets.size(); ++i )
+    {
+      h__LazySetIndex::SetEntry& entry = m_LazySets->Sets[i];
+
+      if ( entry.object == 0 && ! entry.dropped )
+	DecodeLazySet(i);
+    }
+}
+
 //
 ASDCP::Result_t
 ASDCP::MXF::OP1aHeader::GetMDObjectByID(const UUID& ObjectID, InterchangeObject** Object)
 {
+  if ( ! m_LazySets.empty() )
+    {
+      std::map<UUID, ui32_t>::const_iterator i = m_LazySets->IDIndex.find(ObjectID);
+
+      if ( i != m_LazySets->IDIndex.end() )
+	DecodeLazySet(i->second);
+    }
+
   return m_PacketList->GetMDObjectByID(ObjectID, Object);
 }
 
@@ -912,6 +1448,27 @@ ASDCP::MXF::OP1aHeader::GetMDObjectByID(const UUID& ObjectID, InterchangeObject*
 ASDCP::Result_t
 ASDCP::MXF::OP1aHeader::DeleteMDObjectByID(const UUID& ObjectID)
 {
+  if ( ! m_LazySets.empty() )
+    {
+      std::map<UUID, ui32_t>::iterator i = m_LazySets->IDIndex.find(ObjectID);
+
+      if ( i != m_LazySets->IDIndex.end() )
+	{
+	  h__LazySetIndex::SetEntry& entry = m_LazySets->Sets[i->second];
+	  m_LazySets->IDIndex.erase(i);
+
+	  if ( entry.object == 0 )
+	    {
+	      bool was_pending = ! entry.dropped;
+	      entry.dropped = true;
+	      return was_pending ? RESULT_OK : RESULT_FAIL;
+	    }
+
+	  entry.object = 0;
+	  entry.dropped = true;
+	}
+    }
+
   return m_PacketList->DeleteMDObjectByID(ObjectID);
 }
 
@@ -924,6 +1481,23 @@ ASDCP::MXF::OP1aHeader::GetMDObjectByType(const byte_t* ObjectID, InterchangeObj
   if ( Object == 0 )
     Object = &TmpObject;
 
+  if ( ! m_LazySets.empty() && ObjectID != 0 )
+    {
+      // the first matching set in file order
+      std::map<UL, std::vector<ui32_t> >::iterator ti = m_LazySets->TypeIndex.find(s_set_type_key(ObjectID));
+
+      if ( ti != m_LazySets->TypeIndex.end() )
+	{
+	  std::vector<ui32_t>::iterator i;
+
+	  for ( i = ti->second.begin(); i != ti->second.end(); ++i )
+	    {
+	      if ( ! m_LazySets->Sets[*i].dropped && ASDCP_SUCCESS(DecodeLazySet(*i)) )
+		break;
+	    }
+	}
+    }
+
   return m_PacketList->GetMDObjectByType(ObjectID, Object);
 }
 
@@ -931,6 +1505,9 @@ ASDCP::MXF::OP1aHeader::GetMDObjectByType(const byte_t* ObjectID, InterchangeObj
 ASDCP::Result_t
 ASDCP::MXF::OP1aHeader::GetMDObjectsByType(const byte_t* ObjectID, std::list<InterchangeObject*>& ObjectList)
 {
+  if ( ObjectID != 0 )
+    DecodeLazySets(ObjectID);
+
   return m_PacketList->GetMDObjectsByType(ObjectID, ObjectList);
 }
 
@@ -966,6 +1543,8 @@ ASDCP::MXF::OP1aHeader::WriteToFile(Kumu::FileWriter& Writer, ui32_t HeaderSize)
   if ( m_Preface == 0 )
     return RESULT_STATE;
 
+  DecodeLazySets(0);
+
   if ( HeaderSize < 4096 ) 
     {
       DefaultLogSink().Error("HeaderSize %u is too small. Must be >= 4096\n", HeaderSize);
@@ -1061,6 +1640,7 @@ ASDCP::MXF::OP1aHeader::Dump(FILE* stream)
   if ( m_Preface == 0 )
     fputs("No Preface loaded\n", stream);
 
+  DecodeLazySets(0);
   std::list<InterchangeObject*>::iterator i = m_PacketList->m_List.begin();
   for ( ; i != m_PacketList->m_List.end(); i++ )
     (*i)->Dump(stream);
@@ -1071,7 +1651,7 @@ ASDCP::MXF::OP1aHeader::Dump(FILE* stream)
 
 ASDCP::MXF::OPAtomIndexFooter::OPAtomIndexFooter(const Dictionary* d) :
   Partition(d),
-  m_CurrentSegment(0), m_BytesPerEditUnit(0), m_BodySID(0),
+  m_CurrentSegment(0), m_BytesPerEditUnit(0), m_BodySID(0), m_ExpectedDuration(0),
   m_ECOffset(0), m_Lookup(0)
 {
   BodySID = 0;
@@ -1413,12 +1993,212 @@ ASDCP::MXF::OPAtomIndexFooter::PushIndexEntry(const IndexTableSegment::IndexEntr
       m_CurrentSegment->IndexStartPosition = StartPosition;
     }
 
+  // size a new segment for the entries expected to fall in it
+  if ( m_CurrentSegment->IndexEntryArray.empty() && m_ExpectedDuration > m_CurrentSegment->IndexStartPosition )
+    {
+      ui64_t remaining = m_ExpectedDuration - m_CurrentSegment->IndexStartPosition;
+      m_CurrentSegment->IndexEntryArray.reserve(Kumu::xmin<ui64_t>(remaining, CBRIndexEntriesPerSegment));
+    }
+
   m_CurrentSegment->IndexEntryArray.push_back(Entry);
 }
 
+//
+void
+ASDCP::MXF::OPAtomIndexFooter::ReserveIndexEntries(ui64_t duration)
+{
+  m_ExpectedDuration = duration;
+}
+
+//------------------------------------------------------------------------------------------
+//
+
+//------------------------------------------------------------------------------------------
+//
+
+// Each InterchangeObject allocation is preceded by a prefix that records the
+// owning arena (or 0 for the free store). The prefix size keeps the object
+// aligned as operator new would.
+static const size_t s_ArenaPrefixSize = 16;
+
+// Holds the arena selected by the innermost ObjectArena::Scope on each thread.
+// The slot is created during static initialization; until then (m_Ready is
+// zero-initialized) no arena is selected.
+class h__ArenaSlot
+{
+#ifdef KM_WIN32
+  DWORD         m_Index;
+#else
+  pthread_key_t m_Key;
+#endif
+  bool          m_Ready;
+
+  ASDCP_NO_COPY_CONSTRUCT(h__ArenaSlot);
+
+public:
+  h__ArenaSlot() : m_Ready(false)
+  {
+#ifdef KM_WIN32
+    m_Index = ::TlsAlloc();
+    m_Ready = ( m_Index != TLS_OUT_OF_INDEXES );
+#else
+    m_Ready = ( pthread_key_create(&m_Key, 0) == 0 );
+#endif
+  }
+
+  ~h__ArenaSlot()
+  {
+    if ( ! m_Ready )
+      return;
+
+    m_Ready = false;
+#ifdef KM_WIN32
+    ::TlsFree(m_Index);
+#else
+    pthread_key_delete(m_Key);
+#endif
+  }
+
+  //
+  ASDCP::MXF::ObjectArena* Get() const
+  {
+    if ( ! m_Ready )
+      return 0;
+
+#ifdef KM_WIN32
+    return (ASDCP::MXF::ObjectArena*)::TlsGetValue(m_Index);
+#else
+    return (ASDCP::MXF::ObjectArena*)pthread_getspecific(m_Key);
+#endif
+  }
+
+  // returns false if no slot is available, in which case nothing is selected
+  bool Set(ASDCP::MXF::ObjectArena* arena)
+  {
+    if ( ! m_Ready )
+      return false;
+
+#ifdef KM_WIN32
+    return ::TlsSetValue(m_Index, arena) != 0;
+#else
+    return pthread_setspecific(m_Key, arena) == 0;
+#endif
+  }
+};
+
+static h__ArenaSlot s_CurrentArena;
+
+//
+ASDCP::MXF::ObjectArena::ObjectArena(ui32_t block_size) :
+  m_Next(0), m_Remaining(0), m_BlockSize(block_size), m_BytesAllocated(0)
+{
+  assert(m_BlockSize >= s_ArenaPrefixSize);
+}
+
+//
+ASDCP::MXF::ObjectArena::~ObjectArena()
+{
+  while ( ! m_Blocks.empty() )
+    {
+      free(m_Blocks.back());
+      m_Blocks.pop_back();
+    }
+}
+
+//
+void*
+ASDCP::MXF::ObjectArena::Allocate(size_t size)
+{
+  size = ( size + 15 ) & ~(size_t)15;
+
+  if ( size > m_Remaining )
+    {
+      // oversized requests get a block of their own so the current block stays usable
+      if ( size > m_BlockSize / 4 )
+	{
+	  byte_t* tmp_block = (byte_t*)malloc(size);
+
+	  if ( tmp_block == 0 )
+	    return 0;
+
+	  m_Blocks.push_front(tmp_block);
+	  m_BytesAllocated += size;
+	  return tmp_block;
+	}
+
+      byte_t* tmp_block = (byte_t*)malloc(m_BlockSize);
+
+      if ( tmp_block == 0 )
+	return 0;
+
+      m_Blocks.push_back(tmp_block);
+      m_Next = tmp_block;
+      m_Remaining = m_BlockSize;
+    }
+
+  void* tmp_p = m_Next;
+  m_Next += size;
+  m_Remaining -= size;
+  m_BytesAllocated += size;
+  return tmp_p;
+}
+
+//
+ASDCP::MXF::ObjectArena*
+ASDCP::MXF::ObjectArena::Current()
+{
+  return s_CurrentArena.Get();
+}
+
+//
+ASDCP::MXF::ObjectArena::Scope::Scope(ObjectArena& arena) : m_Prev(s_CurrentArena.Get())
+{
+  s_CurrentArena.Set(&arena);
+}
+
+//
+ASDCP::MXF::ObjectArena::Scope::~Scope()
+{
+  s_CurrentArena.Set(m_Prev);
+}
+
 //------------------------------------------------------------------------------------------
 //
 
+//
+void*
+ASDCP::MXF::InterchangeObject::operator new(size_t size)
+{
+  ObjectArena* arena = s_CurrentArena.Get();
+  byte_t* p = 0;
+
+  if ( arena != 0 )
+    p = (byte_t*)arena->Allocate(size + s_ArenaPrefixSize);
+
+  if ( p == 0 )
+    {
+      arena = 0;
+      p = (byte_t*)::operator new(size + s_ArenaPrefixSize);
+    }
+
+  *(ObjectArena**)p = arena;
+  return p + s_ArenaPrefixSize;
+}
+
+//
+void
+ASDCP::MXF::InterchangeObject::operator delete(void* p)
+{
+  if ( p == 0 )
+    return;
+
+  byte_t* base = (byte_t*)p - s_ArenaPrefixSize;
+
+  if ( *(ObjectArena**)base == 0 )
+    ::operator delete(base);
+}
+
+//
 ASDCP::MXF::InterchangeObject::InterchangeObject(const Dictionary* d) :
   KLVPacket(), m_Dict(d), m_Lookup(0) {}
 
@@ -1603,10 +2383,9 @@ public:
 } // namespace MXF
 } // namespace asdcp
 
-//
+// Factories registered through SetObjectFactory(). The built-in types are
+// resolved from the constant table in Metadata.cpp and are not loaded here.
 static ASDCP::MXF::FactoryList s_FactoryList;
-static Kumu::Mutex s_InitLock;
-static bool        s_TypesInit = false;
 
 
 //
@@ -1620,23 +2399,25 @@ ASDCP::MXF::SetObjectFactory(const ASDCP::UL& label, ASDCP::MXF::MXFObjectFactor
 ASDCP::MXF::InterchangeObject*
 ASDCP::MXF::CreateObject(const Dictionary* Dict, const UL& label)
 {
-  if ( ! s_TypesInit )
+  if ( ! s_FactoryList.Empty() )
     {
-      Kumu::AutoMutex BlockLock(s_InitLock);
+      FLi_t i = s_FactoryList.Find(label.Value());
 
-      if ( ! s_TypesInit )
-	{
-	  MXF::Metadata_InitTypes(Dict);
-	  s_TypesInit = true;
-	}
+      if ( i != s_FactoryList.End() )
+	return i->second(Dict);
     }
 
-  FLi_t i = s_FactoryList.find(label);
+  MDD_t type_id;
 
-  if ( i == s_FactoryList.end() )
-    return new InterchangeObject(Dict);
+  if ( Dict->TypeForUL(label.Value(), type_id) )
+    {
+      MXFObjectFactory_t factory = Metadata_FactoryForType(type_id);
+
+      if ( factory != 0 )
+	return factory(Dict);
+    }
 
-  return i->second(Dict);
+  return new InterchangeObject(Dict);
 }
 
 
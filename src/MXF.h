@@ -53,6 +53,48 @@ namespace ASDCP
       InterchangeObject* CreateObject(const Dictionary* Dict, const UL& label);
 
 
+      // Monotonic allocation region for the sets of a parsed header. Memory is handed
+      // out from large blocks and released all at once when the arena is destroyed.
+      // While an ObjectArena::Scope is alive, InterchangeObject instances created on
+      // the calling thread are placed in the arena; deleting such an object runs its
+      // destructor but leaves the storage to the arena.
+      class ObjectArena
+	{
+	  std::list<byte_t*> m_Blocks;
+	  byte_t*            m_Next;
+	  ui32_t             m_Remaining;
+	  ui32_t             m_BlockSize;
+	  ui64_t             m_BytesAllocated;
+
+	  ASDCP_NO_COPY_CONSTRUCT(ObjectArena);
+	  ObjectArena();
+
+	public:
+	  static const ui32_t DefaultBlockSize = 64 * Kumu::Kilobyte;
+
+	  //
+	  class Scope
+	    {
+	      ObjectArena* m_Prev;
+	      ASDCP_NO_COPY_CONSTRUCT(Scope);
+	      Scope();
+
+	    public:
+	      Scope(ObjectArena& arena);
+	      ~Scope();
+	    };
+
+	  ObjectArena(ui32_t block_size);
+	  ~ObjectArena();
+
+	  // returns 16-byte aligned storage, or 0 on allocation failure
+	  void*  Allocate(size_t size);
+	  ui64_t BytesAllocated() const { return m_BytesAllocated; }
+
+	  // the arena selected by the innermost Scope on this thread, if any
+	  static ObjectArena* Current();
+	};
+
       // seek an open file handle to the start of the RIP KLV packet
       Result_t SeekToRIP(const Kumu::IFileReader &);
       
@@ -127,14 +169,31 @@ namespace ASDCP
 	    std::list<InterchangeObject*> m_List;
 	    std::map<UUID, InterchangeObject*> m_Map;
 
+	    // Objects by set type, keyed on the set UL with the version byte cleared.
+	    // A packet's type is taken when it is added. Buckets filled out of
+	    // m_List order are re-sorted from m_List on the next query.
+	    struct TypeBucket
+	    {
+	      std::list<InterchangeObject*> Objects;
+	      bool InListOrder;
+	      TypeBucket() : InListOrder(true) {}
+	    };
+
+	    std::map<UL, TypeBucket> m_TypeMap;
+	    TypeBucket* FindTypeBucket(const byte_t* ObjectID);
+
 	    ~PacketList();
 	    void AddPacket(InterchangeObject* ThePacket); // takes ownership
+	    std::list<InterchangeObject*>::iterator InsertPacket(std::list<InterchangeObject*>::iterator pos,
+								  InterchangeObject* ThePacket); // takes ownership
+	    void Clear(); // forgets all packets without deleting them
 	    Result_t GetMDObjectByID(const UUID& ObjectID, InterchangeObject** Object);
 	    Result_t DeleteMDObjectByID(const UUID& ObjectID);
 	    Result_t GetMDObjectByType(const byte_t* ObjectID, InterchangeObject** Object);
 	    Result_t GetMDObjectsByType(const byte_t* ObjectID, std::list<InterchangeObject*>& ObjectList);
 	  };
 
+	  mem_ptr<ObjectArena> m_Arena; // must outlive m_PacketList
 	  mem_ptr<PacketList> m_PacketList;
 
 	public:
@@ -230,6 +289,7 @@ namespace ASDCP
 	  virtual void     ClearTagList();
 	  virtual Result_t InsertTag(const MDDEntry& Entry, ASDCP::TagValue& Tag);
 	  virtual Result_t TagForKey(const ASDCP::UL& Key, ASDCP::TagValue& Tag);
+	  virtual Result_t TagForEntry(const MDDEntry& Entry, ASDCP::TagValue& Tag);
 
           virtual Result_t InitFromBuffer(const byte_t* p, ui32_t l);
           virtual Result_t WriteToBuffer(ASDCP::FrameBuffer&);
@@ -288,6 +348,10 @@ namespace ASDCP
 	  virtual bool     IsA(const byte_t* label);
 	  virtual const char* ObjectName() { return "InterchangeObject"; }
 	  virtual void     Dump(FILE* stream = 0);
+
+	  // see ObjectArena
+	  static void* operator new(size_t size);
+	  static void  operator delete(void* p);
 	};
 
       //
@@ -410,10 +474,18 @@ namespace ASDCP
       //
       class OP1aHeader : public Partition
 	{
+	  class h__LazySetIndex;
+
 	  Kumu::ByteString m_HeaderData;
+	  bool             m_ArenaMode;
+	  bool             m_LazyMode;
+	  mem_ptr<h__LazySetIndex> m_LazySets;
 	  ASDCP_NO_COPY_CONSTRUCT(OP1aHeader);
 	  OP1aHeader();
 
+	  Result_t DecodeLazySet(ui32_t index);
+	  void     DecodeLazySets(const byte_t* ObjectID); // 0 decodes all pending sets
+
 	public:
 	  ASDCP::MXF::Primer  m_Primer;
 	  Preface*            m_Preface;
@@ -431,6 +503,19 @@ namespace ASDCP
 	  virtual Result_t GetMDObjectsByType(const byte_t* ObjectID, std::list<InterchangeObject*>& ObjectList);
 	  Identification*  GetIdentification();
 	  SourcePackage*   GetSourcePackage();
+
+	  // When enabled, the sets created by InitFromBuffer() are allocated from an
+	  // ObjectArena owned by this header and released together when it is destroyed.
+	  // Must be set before the header is read.
+	  void SetArenaMode(bool enable) { m_ArenaMode = enable; }
+	  bool ArenaMode() const { return m_ArenaMode; }
+
+	  // When enabled, InitFromBuffer() only indexes the raw sets by key and
+	  // InstanceUID; each set is decoded on first access through GetMDObjectByID(),
+	  // GetMDObjectByType() or GetMDObjectsByType(). The Preface is always decoded.
+	  // Must be set before the header is read.
+	  void SetLazyMode(bool enable) { m_LazyMode = enable; }
+	  bool LazyMode() const { return m_LazyMode; }
 	};
 
       // Searches the header object and returns the edit rate based on the contents of the
@@ -445,6 +530,7 @@ namespace ASDCP
 	  ui32_t              m_BytesPerEditUnit;
 	  Rational            m_EditRate;
 	  ui32_t              m_BodySID;
+	  ui64_t              m_ExpectedDuration; // VBR entries expected, zero if unknown
 	  IndexTableSegment::DeltaEntry m_DefaultDeltaEntry;
 
 	  ASDCP_NO_COPY_CONSTRUCT(OPAtomIndexFooter);
@@ -473,6 +559,10 @@ namespace ASDCP
 	  virtual void     SetDeltaParams(const IndexTableSegment::DeltaEntry&);
 	  virtual void     SetIndexParamsCBR(IPrimerLookup* lookup, ui32_t size, const Rational& Rate);
 	  virtual void     SetIndexParamsVBR(IPrimerLookup* lookup, const Rational& Rate, Kumu::fpos_t offset);
+
+	  // Sizes the entry array of each VBR index segment that PushIndexEntry() starts
+	  // after this call for a known or estimated duration, so the arrays are not regrown.
+	  virtual void     ReserveIndexEntries(ui64_t duration);
 	};
 
       //---------------------------------------------------------------------------------
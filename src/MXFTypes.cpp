@@ -453,7 +453,7 @@ ASDCP::MXF::ISO8String::Archive(Kumu::MemIOWriter* Writer) const
 //
 
 ASDCP::MXF::TLVReader::TLVReader(const byte_t* p, ui32_t c, IPrimerLookup* PrimerLookup) :
-  MemIOReader(p, c), m_Lookup(PrimerLookup)
+  MemIOReader(p, c), m_ItemCount(0), m_ItemHint(0), m_Lookup(PrimerLookup)
 {
   Result_t result = RESULT_OK;
 
@@ -466,17 +466,47 @@ ASDCP::MXF::TLVReader::TLVReader(const byte_t* p, ui32_t c, IPrimerLookup* Prime
 	if ( MemIOReader::ReadUi8(&Tag.b) )
 	  if ( MemIOReader::ReadUi16BE(&pkt_len) )
 	    {
-	      m_ElementMap.insert(TagMap::value_type(Tag, ItemInfo(m_size, pkt_len)));
+	      AddItem(Tag, m_size, pkt_len);
 	      if ( SkipOffset(pkt_len) )
 		continue;;
 	    }
 
       DefaultLogSink().Error("Malformed Set\n");
-      m_ElementMap.clear();
+      m_ItemCount = 0;
+      m_OverflowItems.clear();
       result = RESULT_KLV_CODING(__LINE__, __FILE__);
     }
 }
 
+//
+void
+ASDCP::MXF::TLVReader::AddItem(const TagValue& tag, ui32_t offset, ui16_t length)
+{
+  ItemEntry* items = Items();
+
+  // the first instance of a repeated tag wins
+  for ( ui32_t i = 0; i < m_ItemCount; ++i )
+    {
+      if ( items[i].tag == tag )
+	return;
+    }
+
+  if ( m_ItemCount == InlineItemCount )
+    m_OverflowItems.assign(m_InlineItems, m_InlineItems + InlineItemCount);
+
+  ItemEntry TmpItem;
+  TmpItem.tag = tag;
+  TmpItem.length = length;
+  TmpItem.offset = offset;
+
+  if ( m_ItemCount < InlineItemCount )
+    m_InlineItems[m_ItemCount] = TmpItem;
+  else
+    m_OverflowItems.push_back(TmpItem);
+
+  ++m_ItemCount;
+}
+
 //
 bool
 ASDCP::MXF::TLVReader::FindTL(const MDDEntry& Entry)
@@ -489,7 +519,7 @@ ASDCP::MXF::TLVReader::FindTL(const MDDEntry& Entry)
   
   TagValue TmpTag;
 
-  if ( m_Lookup->TagForKey(Entry.ul, TmpTag) != RESULT_OK )
+  if ( m_Lookup->TagForEntry(Entry, TmpTag) != RESULT_OK )
     {
       if ( Entry.tag.a == 0 )
 	{
@@ -501,13 +531,22 @@ ASDCP::MXF::TLVReader::FindTL(const MDDEntry& Entry)
       TmpTag = Entry.tag;
     }
 
-  TagMap::iterator e_i = m_ElementMap.find(TmpTag);
+  ItemEntry* items = Items();
 
-  if ( e_i != m_ElementMap.end() )
+  for ( ui32_t n = 0; n < m_ItemCount; ++n )
     {
-      m_size = (*e_i).second.first;
-      m_capacity = m_size + (*e_i).second.second;
-      return true;
+      ui32_t i = m_ItemHint + n;
+
+      if ( i >= m_ItemCount )
+	i -= m_ItemCount;
+
+      if ( items[i].tag == TmpTag )
+	{
+	  m_size = items[i].offset;
+	  m_capacity = m_size + items[i].length;
+	  m_ItemHint = i + 1;
+	  return true;
+	}
     }
 
   //  DefaultLogSink().Debug("Not Found (%02x %02x): %s\n", TmpTag.a, TmpTag.b, Entry.name);
@@ -60,13 +60,32 @@ namespace ASDCP
       //      
       class TLVReader : public Kumu::MemIOReader
 	{
-
-	  TagMap         m_ElementMap;
+	  // location of one local set item; items are kept in set order and
+	  // searched from the last hit, since sets are mostly read in that order
+	  struct ItemEntry
+	  {
+	    TagValue tag;
+	    ui16_t   length;
+	    ui32_t   offset;
+	  };
+
+	  static const ui32_t InlineItemCount = 48;
+
+	  ItemEntry      m_InlineItems[InlineItemCount];
+	  std::vector<ItemEntry> m_OverflowItems; // all items, once there are more than InlineItemCount
+	  ui32_t         m_ItemCount;
+	  ui32_t         m_ItemHint;
 	  IPrimerLookup* m_Lookup;
 
 	  TLVReader();
 	  ASDCP_NO_COPY_CONSTRUCT(TLVReader);
 
+	  inline ItemEntry* Items() {
+	    return ( m_ItemCount > InlineItemCount ) ? &m_OverflowItems[0] : m_InlineItems;
+	  }
+
+	  void AddItem(const TagValue& tag, ui32_t offset, ui16_t length);
+
 	public:
 	  TLVReader(const byte_t* p, ui32_t c, IPrimerLookup* = 0);
 	  bool FindTL(const MDDEntry&);
@@ -92,60 +92,97 @@ static InterchangeObject* IABSoundfieldLabelSubDescriptor_Factory(const Dictiona
 static InterchangeObject* JPEGXSPictureSubDescriptor_Factory(const Dictionary* Dict) { return new JPEGXSPictureSubDescriptor(Dict); }
 
 
+// Built-in set types, in MDD_t order. This table is constant-initialized and
+// searched directly by CreateObject(); it is not loaded into a map at startup.
+static const struct
+{
+  MDD_t type;
+  MXFObjectFactory_t factory;
+} s_FactoryTable[] = {
+  { MDD_IndexTableSegment,                         IndexTableSegment_Factory },
+  { MDD_Preface,                                   Preface_Factory },
+  { MDD_Identification,                            Identification_Factory },
+  { MDD_ContentStorage,                            ContentStorage_Factory },
+  { MDD_EssenceContainerData,                      EssenceContainerData_Factory },
+  { MDD_NetworkLocator,                            NetworkLocator_Factory },
+  { MDD_StaticTrack,                               StaticTrack_Factory },
+  { MDD_Track,                                     Track_Factory },
+  { MDD_Sequence,                                  Sequence_Factory },
+  { MDD_TimecodeComponent,                         TimecodeComponent_Factory },
+  { MDD_SourceClip,                                SourceClip_Factory },
+  { MDD_DMSegment,                                 DMSegment_Factory },
+  { MDD_MaterialPackage,                           MaterialPackage_Factory },
+  { MDD_SourcePackage,                             SourcePackage_Factory },
+  { MDD_FileDescriptor,                            FileDescriptor_Factory },
+  { MDD_GenericPictureEssenceDescriptor,           GenericPictureEssenceDescriptor_Factory },
+  { MDD_CDCIEssenceDescriptor,                     CDCIEssenceDescriptor_Factory },
+  { MDD_RGBAEssenceDescriptor,                     RGBAEssenceDescriptor_Factory },
+  { MDD_GenericSoundEssenceDescriptor,             GenericSoundEssenceDescriptor_Factory },
+  { MDD_GenericDataEssenceDescriptor,              GenericDataEssenceDescriptor_Factory },
+  { MDD_MPEG2VideoDescriptor,                      MPEG2VideoDescriptor_Factory },
+  { MDD_WaveAudioDescriptor,                       WaveAudioDescriptor_Factory },
+  { MDD_JPEG2000PictureSubDescriptor,              JPEG2000PictureSubDescriptor_Factory },
+  { MDD_DescriptiveFramework,                      DescriptiveFramework_Factory },
+  { MDD_CryptographicFramework,                    CryptographicFramework_Factory },
+  { MDD_CryptographicContext,                      CryptographicContext_Factory },
+  { MDD_TimedTextDescriptor,                       TimedTextDescriptor_Factory },
+  { MDD_TimedTextResourceSubDescriptor,            TimedTextResourceSubDescriptor_Factory },
+  { MDD_StereoscopicPictureSubDescriptor,          StereoscopicPictureSubDescriptor_Factory },
+  { MDD_MCALabelSubDescriptor,                     MCALabelSubDescriptor_Factory },
+  { MDD_AudioChannelLabelSubDescriptor,            AudioChannelLabelSubDescriptor_Factory },
+  { MDD_SoundfieldGroupLabelSubDescriptor,         SoundfieldGroupLabelSubDescriptor_Factory },
+  { MDD_GroupOfSoundfieldGroupsLabelSubDescriptor, GroupOfSoundfieldGroupsLabelSubDescriptor_Factory },
+  { MDD_DCDataDescriptor,                          DCDataDescriptor_Factory },
+  { MDD_DolbyAtmosSubDescriptor,                   DolbyAtmosSubDescriptor_Factory },
+  { MDD_ContainerConstraintsSubDescriptor,         ContainerConstraintsSubDescriptor_Factory },
+  { MDD_PHDRMetadataTrackSubDescriptor,            PHDRMetadataTrackSubDescriptor_Factory },
+  { MDD_PrivateDCDataDescriptor,                   PrivateDCDataDescriptor_Factory },
+  { MDD_PIMFDynamicMetadataDescriptor,             PIMFDynamicMetadataDescriptor_Factory },
+  { MDD_ACESPictureSubDescriptor,                  ACESPictureSubDescriptor_Factory },
+  { MDD_TargetFrameSubDescriptor,                  TargetFrameSubDescriptor_Factory },
+  { MDD_ISXDDataEssenceDescriptor,                 ISXDDataEssenceDescriptor_Factory },
+  { MDD_TextBasedDMFramework,                      TextBasedDMFramework_Factory },
+  { MDD_TextBasedObject,                           TextBasedObject_Factory },
+  { MDD_GenericStreamTextBasedSet,                 GenericStreamTextBasedSet_Factory },
+  { MDD_DescriptiveObject,                         DescriptiveObject_Factory },
+  { MDD_IABEssenceDescriptor,                      IABEssenceDescriptor_Factory },
+  { MDD_IABSoundfieldLabelSubDescriptor,           IABSoundfieldLabelSubDescriptor_Factory },
+  { MDD_JPEGXSPictureSubDescriptor,                JPEGXSPictureSubDescriptor_Factory },
+};
+
+static const ui32_t s_FactoryTableSize = sizeof(s_FactoryTable) / sizeof(s_FactoryTable[0]);
+
+//
+MXFObjectFactory_t
+ASDCP::MXF::Metadata_FactoryForType(MDD_t type_id)
+{
+  ui32_t lo = 0, hi = s_FactoryTableSize;
+
+  while ( lo < hi )
+    {
+      ui32_t mid = ( lo + hi ) / 2;
+
+      if ( s_FactoryTable[mid].type < type_id )
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  if ( lo < s_FactoryTableSize && s_FactoryTable[lo].type == type_id )
+    return s_FactoryTable[lo].factory;
+
+  return 0;
+}
+
+// Registers the built-in types with SetObjectFactory(). CreateObject() does not
+// need this; it remains for callers that want the types in the factory list.
 void
 ASDCP::MXF::Metadata_InitTypes(const Dictionary* Dict)
 {
   assert(Dict);
-  SetObjectFactory(Dict->ul(MDD_Preface), Preface_Factory);
-  SetObjectFactory(Dict->ul(MDD_IndexTableSegment), IndexTableSegment_Factory);
-
-  SetObjectFactory(Dict->ul(MDD_Identification), Identification_Factory);
-  SetObjectFactory(Dict->ul(MDD_ContentStorage), ContentStorage_Factory);
-  SetObjectFactory(Dict->ul(MDD_EssenceContainerData), EssenceContainerData_Factory);
-  SetObjectFactory(Dict->ul(MDD_MaterialPackage), MaterialPackage_Factory);
-  SetObjectFactory(Dict->ul(MDD_SourcePackage), SourcePackage_Factory);
-  SetObjectFactory(Dict->ul(MDD_StaticTrack), StaticTrack_Factory);
-  SetObjectFactory(Dict->ul(MDD_Track), Track_Factory);
-  SetObjectFactory(Dict->ul(MDD_Sequence), Sequence_Factory);
-  SetObjectFactory(Dict->ul(MDD_SourceClip), SourceClip_Factory);
-  SetObjectFactory(Dict->ul(MDD_TimecodeComponent), TimecodeComponent_Factory);
-  SetObjectFactory(Dict->ul(MDD_FileDescriptor), FileDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_GenericSoundEssenceDescriptor), GenericSoundEssenceDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_WaveAudioDescriptor), WaveAudioDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_GenericPictureEssenceDescriptor), GenericPictureEssenceDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_RGBAEssenceDescriptor), RGBAEssenceDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_JPEG2000PictureSubDescriptor), JPEG2000PictureSubDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_CDCIEssenceDescriptor), CDCIEssenceDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_MPEG2VideoDescriptor), MPEG2VideoDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_DMSegment), DMSegment_Factory);
-  SetObjectFactory(Dict->ul(MDD_CryptographicFramework), CryptographicFramework_Factory);
-  SetObjectFactory(Dict->ul(MDD_CryptographicContext), CryptographicContext_Factory);
-  SetObjectFactory(Dict->ul(MDD_DescriptiveFramework), DescriptiveFramework_Factory);
-  SetObjectFactory(Dict->ul(MDD_DescriptiveObject), DescriptiveObject_Factory);
-  SetObjectFactory(Dict->ul(MDD_GenericDataEssenceDescriptor), GenericDataEssenceDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_TimedTextDescriptor), TimedTextDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_TimedTextResourceSubDescriptor), TimedTextResourceSubDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_StereoscopicPictureSubDescriptor), StereoscopicPictureSubDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_ContainerConstraintsSubDescriptor), ContainerConstraintsSubDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_NetworkLocator), NetworkLocator_Factory);
-  SetObjectFactory(Dict->ul(MDD_MCALabelSubDescriptor), MCALabelSubDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_AudioChannelLabelSubDescriptor), AudioChannelLabelSubDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_SoundfieldGroupLabelSubDescriptor), SoundfieldGroupLabelSubDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_GroupOfSoundfieldGroupsLabelSubDescriptor), GroupOfSoundfieldGroupsLabelSubDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_DCDataDescriptor), DCDataDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_PrivateDCDataDescriptor), PrivateDCDataDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_DolbyAtmosSubDescriptor), DolbyAtmosSubDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_ACESPictureSubDescriptor), ACESPictureSubDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_TargetFrameSubDescriptor), TargetFrameSubDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_TextBasedDMFramework), TextBasedDMFramework_Factory);
-  SetObjectFactory(Dict->ul(MDD_TextBasedObject), TextBasedObject_Factory);
-  SetObjectFactory(Dict->ul(MDD_GenericStreamTextBasedSet), GenericStreamTextBasedSet_Factory);
-  SetObjectFactory(Dict->ul(MDD_ISXDDataEssenceDescriptor), ISXDDataEssenceDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_PHDRMetadataTrackSubDescriptor), PHDRMetadataTrackSubDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_PIMFDynamicMetadataDescriptor), PIMFDynamicMetadataDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_IABEssenceDescriptor), IABEssenceDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_IABSoundfieldLabelSubDescriptor), IABSoundfieldLabelSubDescriptor_Factory);
-  SetObjectFactory(Dict->ul(MDD_JPEGXSPictureSubDescriptor), JPEGXSPictureSubDescriptor_Factory);
+
+  for ( ui32_t i = 0; i < s_FactoryTableSize; ++i )
+    SetObjectFactory(Dict->ul(s_FactoryTable[i].type), s_FactoryTable[i].factory);
 }
 
 //------------------------------------------------------------------------------------------
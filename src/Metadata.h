@@ -40,6 +40,9 @@ namespace ASDCP
     {
       void Metadata_InitTypes(const Dictionary* Dict);
 
+      // returns the factory for a built-in set type, or 0 if there is none
+      MXFObjectFactory_t Metadata_FactoryForType(MDD_t type_id);
+
       //
 
       //
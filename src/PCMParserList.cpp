@@ -48,9 +48,11 @@ ASDCP::ParserInstance::~ParserInstance()
 
 // PCM::CalcSampleSize(ADesc);
 Result_t
-ASDCP::ParserInstance::OpenRead(const std::string& filename, const Rational& PictureRate)
+ASDCP::ParserInstance::OpenRead(const std::string& filename, const Rational& PictureRate,
+				PCM::SampleConversion_t Conversion, bool Mapped)
 {
-  Result_t result = Parser.OpenRead(filename, PictureRate);
+  Result_t result = Mapped ? Parser.OpenReadMapped(filename, PictureRate, Conversion)
+    : Parser.OpenRead(filename, PictureRate, Conversion);
 
   if ( ASDCP_SUCCESS(result) )
     result = Parser.FillAudioDescriptor(ADesc);
@@ -89,7 +91,7 @@ ASDCP::ParserInstance::PutSample(byte_t* p)
 Result_t
 ASDCP::ParserInstance::ReadFrame()
 {
-  Result_t result = Parser.ReadFrame(FB);
+  Result_t result = Parser.IsMapped() ? Parser.ReadFrameView(FB) : Parser.ReadFrame(FB);
   m_p = ASDCP_SUCCESS(result) ? FB.RoData() : 0;
   return result;
 }
@@ -98,6 +100,38 @@ ASDCP::ParserInstance::ReadFrame()
 //------------------------------------------------------------------------------------------
 //
 
+// Copies frame_count samples of sample_size bytes from src into every
+// out_stride bytes of dst.
+template <ui32_t SampleSize>
+static void
+interleave_fixed(const byte_t* src, ui32_t frame_count, byte_t* dst, ui32_t out_stride)
+{
+  for ( ui32_t i = 0; i < frame_count; i++ )
+    {
+      memcpy(dst, src, SampleSize);
+      src += SampleSize;
+      dst += out_stride;
+    }
+}
+
+//
+static void
+interleave_samples(const byte_t* src, ui32_t frame_count, ui32_t sample_size, byte_t* dst, ui32_t out_stride)
+{
+  switch ( sample_size )
+    {
+    case 3: interleave_fixed<3>(src, frame_count, dst, out_stride); break;
+    case 6: interleave_fixed<6>(src, frame_count, dst, out_stride); break;
+
+    default:
+      for ( ui32_t i = 0; i < frame_count; i++ )
+	{
+	  memcpy(dst, src, sample_size);
+	  src += sample_size;
+	  dst += out_stride;
+	}
+    }
+}
 
 //
 ASDCP::PCMParserList::PCMParserList() : m_ChannelCount(0)
@@ -115,7 +149,8 @@ ASDCP::PCMParserList::~PCMParserList()
 
 //
 Result_t
-ASDCP::PCMParserList::OpenRead(ui32_t argc, const char** argv, const Rational& PictureRate)
+ASDCP::PCMParserList::OpenRead(ui32_t argc, const char** argv, const Rational& PictureRate,
+			       PCM::SampleConversion_t Conversion, bool Mapped)
 {
   ASDCP_TEST_NULL(argv);
   PathList_t TmpFileList;
@@ -126,12 +161,13 @@ ASDCP::PCMParserList::OpenRead(ui32_t argc, const char** argv, const Rational& P
       TmpFileList.push_back(argv[i]);
     }
 
-  return OpenRead(TmpFileList, PictureRate);
+  return OpenRead(TmpFileList, PictureRate, Conversion, Mapped);
 }
 
 //
 Result_t
-ASDCP::PCMParserList::OpenRead(const Kumu::PathList_t& argv, const Rational& PictureRate)
+ASDCP::PCMParserList::OpenRead(const Kumu::PathList_t& argv, const Rational& PictureRate,
+			       PCM::SampleConversion_t Conversion, bool Mapped)
 {
   Result_t result = RESULT_OK;
   PathList_t::iterator fi;
@@ -171,7 +207,7 @@ ASDCP::PCMParserList::OpenRead(const Kumu::PathList_t& argv, const Rational& Pic
   for ( fi = file_list.begin(); KM_SUCCESS(result) && fi != file_list.end(); ++fi )
     {
       mem_ptr<ParserInstance> I = new ParserInstance;
-      result = I->OpenRead(fi->c_str(), PictureRate);
+      result = I->OpenRead(fi->c_str(), PictureRate, Conversion, Mapped);
 
       if ( ASDCP_SUCCESS(result) )
 	{
@@ -268,38 +304,43 @@ ASDCP::PCMParserList::ReadFrame(PCM::FrameBuffer& OutFB)
 
   if ( ASDCP_SUCCESS(result) )
     {
-      byte_t* Out_p = OutFB.Data();
-      byte_t* End_p = Out_p + OutFB.Capacity();
-      ui64_t total_sample_bytes = 0;
+      // interleave only as many sample frames as every input can supply
+      ui32_t out_sample_size = 0;
+      ui32_t frame_count = 0xffffffff;
 
-      while ( Out_p < End_p && ASDCP_SUCCESS(result) )
+      for ( self_i = begin(); self_i != end(); self_i++ )
 	{
-	  self_i = begin();
-
-	  while ( self_i != end() && ASDCP_SUCCESS(result) )
-	    {
-	      result = (*self_i)->PutSample(Out_p);
-
-	      if ( ASDCP_SUCCESS(result) )
-		{
-		  Out_p += (*self_i)->SampleSize();
-		  total_sample_bytes += (*self_i)->SampleSize();
-		  self_i++;
-		}
-	    }
+	  out_sample_size += (*self_i)->SampleSize();
+	  frame_count = Kumu::xmin(frame_count, (*self_i)->FB.Size() / (*self_i)->SampleSize());
 	}
 
-      OutFB.Size(total_sample_bytes);
+      frame_count = Kumu::xmin(frame_count, OutFB.Capacity() / out_sample_size);
+      byte_t* Out_p = OutFB.Data();
 
-      if ( result == RESULT_ENDOFFILE )
+      for ( self_i = begin(); self_i != end(); self_i++ )
 	{
-	  result = RESULT_OK;
+	  interleave_samples((*self_i)->FB.RoData(), frame_count, (*self_i)->SampleSize(), Out_p, out_sample_size);
+	  Out_p += (*self_i)->SampleSize();
 	}
+
+      OutFB.Size(frame_count * out_sample_size);
     }
 
   return result;
 }
 
+//
+Result_t
+ASDCP::PCMParserList::ReadFrameView(PCM::FrameBuffer& OutFB)
+{
+  if ( size() == 1 && front()->Parser.IsMapped() )
+    {
+      return front()->Parser.ReadFrameView(OutFB);
+    }
+
+  return ReadFrame(OutFB);
+}
+
 //
 ASDCP::Result_t ASDCP::PCMParserList::Seek(ui32_t frame_number)
 {
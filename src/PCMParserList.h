@@ -54,8 +54,12 @@ namespace ASDCP
       ParserInstance();
       virtual ~ParserInstance();
 
-      Result_t OpenRead(const std::string& filename, const Rational& PictureRate);
+      Result_t OpenRead(const std::string& filename, const Rational& PictureRate,
+			PCM::SampleConversion_t Conversion = PCM::SC_NONE, bool Mapped = false);
       Result_t PutSample(byte_t* p);
+
+      // Reads the next frame into FB. A mapped parser leaves FB referencing the
+      // frame in place (see PCM::WAVParser::ReadFrameView()).
       Result_t ReadFrame();
       inline ui32_t SampleSize()  { return m_SampleSize; }
     };
@@ -73,11 +77,20 @@ namespace ASDCP
       PCMParserList();
       virtual ~PCMParserList();
 
-      Result_t OpenRead(ui32_t argc, const char** argv, const Rational& PictureRate);
-      Result_t OpenRead(const Kumu::PathList_t& argv, const Rational& PictureRate);
+      // Conversion is passed to each WAVParser, see PCM::SampleConversion_t. If Mapped
+      // is true, the input files are opened with PCM::WAVParser::OpenReadMapped() and
+      // interleaving reads directly from the mappings.
+      Result_t OpenRead(ui32_t argc, const char** argv, const Rational& PictureRate,
+			PCM::SampleConversion_t Conversion = PCM::SC_NONE, bool Mapped = false);
+      Result_t OpenRead(const Kumu::PathList_t& argv, const Rational& PictureRate,
+			PCM::SampleConversion_t Conversion = PCM::SC_NONE, bool Mapped = false);
       Result_t FillAudioDescriptor(PCM::AudioDescriptor& ADesc) const;
       Result_t Reset();
       Result_t ReadFrame(PCM::FrameBuffer& OutFB);
+
+      // As ReadFrame(), except that when the list holds a single mapped file OutFB is
+      // left referencing the frame in place, as by PCM::WAVParser::ReadFrameView().
+      Result_t ReadFrameView(PCM::FrameBuffer& OutFB);
       Result_t Seek(ui32_t frame_number);
     };
 }
@@ -30,8 +30,15 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include <Wav.h>
+#include "AS_DCP_internal.h"
 #include <assert.h>
 #include <KM_log.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+# define ASDCP_PCM_SSE2
+# include <emmintrin.h>
+#endif
+
 using Kumu::DefaultLogSink;
 
 using namespace ASDCP;
@@ -40,12 +47,186 @@ using namespace ASDCP::Wav;
 using namespace ASDCP::RF64;
 
 
+//------------------------------------------------------------------------------------------
+// sample conversion
+
+const i32_t Max24 = 0x007fffff;
+const i32_t Min24 = -0x00800000;
+const float FloatScale24 = 8388608.0f;
+
+//
+static inline void
+put_24(i32_t v, byte_t* p)
+{
+  p[0] = (byte_t)v;
+  p[1] = (byte_t)(v >> 8);
+  p[2] = (byte_t)(v >> 16);
+}
+
+// xorshift32, used only to drive the dither generator
+static inline ui32_t
+next_random(ui32_t& state)
+{
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+// Triangular (TPDF) noise spanning +/- 1 LSB of the 24-bit output, expressed in
+// 1/256 LSB units, which are the discarded bits of a 32-bit source word.
+static inline i32_t
+tpdf_noise_256(ui32_t& state)
+{
+  ui32_t r = next_random(state);
+  return (i32_t)( r & 0xff ) - (i32_t)( ( r >> 8 ) & 0xff );
+}
+
+// TPDF noise in units of one 24-bit LSB.
+static inline float
+tpdf_noise_float(ui32_t& state)
+{
+  ui32_t r = next_random(state);
+  return ( (float)( r & 0xffff ) - (float)( r >> 16 ) ) * ( 1.0f / 65536.0f );
+}
+
+//
+static void
+convert_16_to_24(const byte_t* src, ui32_t sample_count, byte_t* dst)
+{
+  for ( ui32_t i = 0; i < sample_count; i++ )
+    {
+      dst[0] = 0;
+      dst[1] = src[0];
+      dst[2] = src[1];
+      src += 2;
+      dst += 3;
+    }
+}
+
+// rounds to nearest, or adds TPDF dither if dither_state is not NULL
+static void
+convert_32_to_24(const byte_t* src, ui32_t sample_count, byte_t* dst, ui32_t* dither_state)
+{
+  for ( ui32_t i = 0; i < sample_count; i++ )
+    {
+      i64_t v = (i32_t)KM_i32_LE(Kumu::cp2i<ui32_t>(src));
+      v += 128 + ( ( dither_state == 0 ) ? 0 : tpdf_noise_256(*dither_state) );
+      v >>= 8;
+      put_24((i32_t)( v > Max24 ? Max24 : ( v < Min24 ? Min24 : v ) ), dst);
+      src += 4;
+      dst += 3;
+    }
+}
+
+// Rounds a value already clipped to the 24-bit range to nearest, ties to even.
+// With SSE2 the conversion instruction is the one used by the vector kernel
+// below, so both honor the same rounding mode.
+static inline i32_t
+round_24(float f)
+{
+#ifdef ASDCP_PCM_SSE2
+  return _mm_cvtss_si32(_mm_set_ss(f));
+#else
+  i32_t i = (i32_t)f;
+  float r = f - (float)i; // exact, |f| < 2^24
+
+  if ( r > 0.5f || ( r == 0.5f && ( i & 1 ) ) )
+    i++;
+  else if ( r < -0.5f || ( r == -0.5f && ( i & 1 ) ) )
+    i--;
+
+  return i;
+#endif
+}
+
+//
+static inline i32_t
+float_to_24(float f, ui32_t* dither_state)
+{
+  if ( f != f ) // NaN
+    f = 0.0f;
+
+  f *= FloatScale24;
+
+  if ( dither_state != 0 )
+    f += tpdf_noise_float(*dither_state);
+
+  if ( f >= (float)Max24 )
+    return Max24;
+
+  if ( f <= (float)Min24 )
+    return Min24;
+
+  return round_24(f);
+}
+
+//
+void
+ASDCP::PCM_Float_to_24_Scalar(const byte_t* src, ui32_t sample_count, byte_t* dst, ui32_t* dither_state)
+{
+  for ( ui32_t i = 0; i < sample_count; i++ )
+    {
+      ui32_t u = KM_i32_LE(Kumu::cp2i<ui32_t>(src));
+      float f;
+      memcpy(&f, &u, sizeof(f));
+      put_24(float_to_24(f, dither_state), dst);
+      src += 4;
+      dst += 3;
+    }
+}
+
+//
+void
+ASDCP::PCM_Float_to_24(const byte_t* src, ui32_t sample_count, byte_t* dst, ui32_t* dither_state)
+{
+  ui32_t i = 0;
+
+#ifdef ASDCP_PCM_SSE2
+  const __m128 scale = _mm_set1_ps(FloatScale24);
+  const __m128 max_v = _mm_set1_ps((float)Max24);
+  const __m128 min_v = _mm_set1_ps((float)Min24);
+  i32_t out[4];
+  float noise[4];
+
+  for ( ; i + 4 <= sample_count; i += 4 )
+    {
+      __m128 v = _mm_loadu_ps((const float*)src);
+      v = _mm_and_ps(v, _mm_cmpord_ps(v, v)); // NaN -> 0
+      v = _mm_mul_ps(v, scale);
+
+      if ( dither_state != 0 )
+	{
+	  for ( ui32_t j = 0; j < 4; j++ )
+	    noise[j] = tpdf_noise_float(*dither_state);
+
+	  v = _mm_add_ps(v, _mm_loadu_ps(noise));
+	}
+
+      v = _mm_min_ps(_mm_max_ps(v, min_v), max_v);
+      _mm_storeu_si128((__m128i*)out, _mm_cvtps_epi32(v));
+
+      put_24(out[0], dst);
+      put_24(out[1], dst + 3);
+      put_24(out[2], dst + 6);
+      put_24(out[3], dst + 9);
+      src += 16;
+      dst += 12;
+    }
+#endif
+
+  PCM_Float_to_24_Scalar(src, sample_count - i, dst, dither_state);
+}
+
+
 //------------------------------------------------------------------------------------------
 
 //
 class ASDCP::PCM::WAVParser::h__WAVParser
 {
   Kumu::FileReader   m_FileReader;
+  Kumu::FileMap      m_FileMap;
+  bool               m_Mapped;
   bool               m_EOF;
   ui32_t             m_DataStart;
   ui64_t             m_DataLength;
@@ -53,27 +234,47 @@ class ASDCP::PCM::WAVParser::h__WAVParser
   ui32_t             m_FrameBufferSize;
   ui32_t             m_FramesRead;
   Rational           m_PictureRate;
+  SampleConversion_t m_Conversion;
+  ui16_t             m_SourceFormat;    // WAVE format tag of the samples in the file
+  ui32_t             m_SourceBits;      // bits per sample in the file
+  ui32_t             m_SourceFrameSize; // size in bytes of one frame as stored in the file
+  FrameBuffer        m_SourceBuf;       // holds file samples awaiting conversion
+  FrameBuffer        m_ViewBuf;         // frame storage for views that cannot point into the map
+  ui32_t             m_DitherState;
 
   ASDCP_NO_COPY_CONSTRUCT(h__WAVParser);
 
+  Result_t ParseHeader(const byte_t* buf, ui32_t buf_len, const Rational& PictureRate);
+  Result_t InitConversion(bool big_endian);
+  void     ConvertFrame(const byte_t* src, ui32_t src_len, byte_t* dst);
+  Result_t NextSourceFrame(const byte_t** src, ui32_t* src_len, byte_t* read_buf);
+
 public:
   AudioDescriptor  m_ADesc;
 
 
   h__WAVParser() :
-    m_EOF(false), m_DataStart(0), m_DataLength(0), m_ReadCount(0),
-    m_FrameBufferSize(0), m_FramesRead(0) {}
+    m_Mapped(false), m_EOF(false), m_DataStart(0), m_DataLength(0), m_ReadCount(0),
+    m_FrameBufferSize(0), m_FramesRead(0), m_Conversion(SC_NONE),
+    m_SourceFormat(ASDCP_WAVE_FORMAT_PCM), m_SourceBits(0), m_SourceFrameSize(0),
+    m_DitherState(0x2545f491) {}
 
   ~h__WAVParser()
   {
     Close();
    }
 
-  Result_t OpenRead(const std::string& filename, const Rational& PictureRate);
+  Result_t OpenRead(const std::string& filename, const Rational& PictureRate,
+		    SampleConversion_t Conversion, bool Mapped);
   void     Close();
   void     Reset();
   Result_t ReadFrame(FrameBuffer&);
+  Result_t ReadFrameView(FrameBuffer&);
   Result_t Seek(ui32_t frame_number);
+
+  // true if samples are converted on the way from the file to the caller
+  inline bool Converting() const { return m_SourceBuf.Capacity() > 0; }
+  inline bool Mapped() const { return m_Mapped; }
 };
 
 
@@ -82,72 +283,223 @@ void
 ASDCP::PCM::WAVParser::h__WAVParser::Close()
 {
   m_FileReader.Close();
+  m_FileMap.Close();
 }
 
 //
 void
 ASDCP::PCM::WAVParser::h__WAVParser::Reset()
 {
-  m_FileReader.Seek(m_DataStart);
+  if ( ! m_Mapped )
+    m_FileReader.Seek(m_DataStart);
+
   m_FramesRead = 0;
   m_ReadCount = 0;
+  m_EOF = false;
+}
+
+// Called once the source header has been parsed into m_ADesc. Decides whether
+// samples will be converted and, if so, adjusts m_ADesc to describe the output.
+ASDCP::Result_t
+ASDCP::PCM::WAVParser::h__WAVParser::InitConversion(bool big_endian)
+{
+  m_SourceBits = m_ADesc.QuantizationBits;
+  m_SourceFrameSize = ASDCP::PCM::CalcFrameBufferSize(m_ADesc);
+
+  if ( m_SourceFrameSize == 0 )
+    {
+      DefaultLogSink().Error("Unable to determine PCM frame size.\n");
+      return RESULT_FORMAT;
+    }
+
+  if ( m_SourceFormat == ASDCP_WAVE_FORMAT_IEEE_FLOAT )
+    {
+      if ( m_Conversion == SC_NONE )
+	{
+	  DefaultLogSink().Error("Floating point input requires sample conversion.\n");
+	  return RESULT_FORMAT;
+	}
+
+      if ( m_SourceBits != 32 )
+	{
+	  DefaultLogSink().Error("Unsupported floating point sample size: %u bits.\n", m_SourceBits);
+	  return RESULT_FORMAT;
+	}
+    }
+
+  if ( m_Conversion != SC_NONE
+       && ( m_SourceBits != 24 || m_SourceFormat == ASDCP_WAVE_FORMAT_IEEE_FLOAT ) )
+    {
+      if ( big_endian )
+	{
+	  DefaultLogSink().Error("Sample conversion is not supported for AIFF input.\n");
+	  return RESULT_FORMAT;
+	}
+
+      if ( m_SourceBits != 16 && m_SourceBits != 32 )
+	{
+	  DefaultLogSink().Error("Unsupported sample size for conversion: %u bits.\n", m_SourceBits);
+	  return RESULT_FORMAT;
+	}
+
+      m_ADesc.QuantizationBits = 24;
+      m_ADesc.BlockAlign = 3 * m_ADesc.ChannelCount;
+      m_ADesc.AvgBps = (ui32_t)ceil(m_ADesc.AudioSamplingRate.Quotient()) * m_ADesc.BlockAlign;
+
+      Result_t result = m_SourceBuf.Capacity(m_SourceFrameSize);
+
+      if ( ASDCP_FAILURE(result) )
+	return result;
+    }
+
+  m_FrameBufferSize = ASDCP::PCM::CalcFrameBufferSize(m_ADesc);
+  m_ADesc.ContainerDuration = m_DataLength / m_SourceFrameSize;
+  m_ADesc.ChannelFormat = PCM::CF_NONE;
+  return RESULT_OK;
 }
 
 //
+void
+ASDCP::PCM::WAVParser::h__WAVParser::ConvertFrame(const byte_t* src, ui32_t src_len, byte_t* dst)
+{
+  ui32_t* dither_state = ( m_Conversion == SC_24BIT_DITHER ) ? &m_DitherState : 0;
+
+  if ( m_SourceFormat == ASDCP_WAVE_FORMAT_IEEE_FLOAT )
+    PCM_Float_to_24(src, src_len / 4, dst, dither_state);
+
+  else if ( m_SourceBits == 32 )
+    convert_32_to_24(src, src_len / 4, dst, dither_state);
+
+  else
+    convert_16_to_24(src, src_len / 2, dst);
+}
+
+// Tries each of the supported header types in turn.
 ASDCP::Result_t
-ASDCP::PCM::WAVParser::h__WAVParser::OpenRead(const std::string& filename, const Rational& PictureRate)
+ASDCP::PCM::WAVParser::h__WAVParser::ParseHeader(const byte_t* buf, ui32_t buf_len, const Rational& PictureRate)
 {
-  Result_t result = m_FileReader.OpenRead(filename);
+  SimpleWaveHeader WavHeader;
+  Result_t result = WavHeader.ReadFromBuffer(buf, buf_len, &m_DataStart);
+
+  if ( ASDCP_SUCCESS(result) )
+    {
+      WavHeader.FillADesc(m_ADesc, PictureRate);
+      m_DataLength = WavHeader.data_len;
+      m_SourceFormat = WavHeader.format;
+      return InitConversion(false);
+    }
+
+  ASDCP::AIFF::SimpleAIFFHeader AIFFHeader;
+  result = AIFFHeader.ReadFromBuffer(buf, buf_len, &m_DataStart);
+
+  if ( ASDCP_SUCCESS(result) )
+    {
+      AIFFHeader.FillADesc(m_ADesc, PictureRate);
+      m_DataLength = AIFFHeader.data_len;
+      return InitConversion(true);
+    }
+
+  SimpleRF64Header RF64Header;
+  result = RF64Header.ReadFromBuffer(buf, buf_len, &m_DataStart);
 
   if ( ASDCP_SUCCESS(result) )
     {
-      SimpleWaveHeader WavHeader;
-      result = WavHeader.ReadFromFile(m_FileReader, &m_DataStart);
-  
+      RF64Header.FillADesc(m_ADesc, PictureRate);
+      m_DataLength = RF64Header.data_len;
+      m_SourceFormat = RF64Header.format;
+      return InitConversion(false);
+    }
+
+  return result;
+}
+
+//
+ASDCP::Result_t
+ASDCP::PCM::WAVParser::h__WAVParser::OpenRead(const std::string& filename, const Rational& PictureRate,
+					       SampleConversion_t Conversion, bool Mapped)
+{
+  m_Conversion = Conversion;
+  m_Mapped = Mapped;
+  Result_t result = RESULT_OK;
+
+  if ( m_Mapped )
+    {
+      result = m_FileMap.OpenRead(filename);
+
       if ( ASDCP_SUCCESS(result) )
 	{
-	  WavHeader.FillADesc(m_ADesc, PictureRate);
-	  m_FrameBufferSize = ASDCP::PCM::CalcFrameBufferSize(m_ADesc);
-	  m_DataLength = WavHeader.data_len;
-	  m_ADesc.ContainerDuration = m_DataLength / m_FrameBufferSize;
-	  m_ADesc.ChannelFormat = PCM::CF_NONE;
-	  Reset();
+	  ui32_t header_len = (ui32_t)Kumu::xmin(m_FileMap.MapSize(), (ui64_t)MaxWavHeader);
+	  result = ParseHeader(m_FileMap.MapData(), header_len, PictureRate);
 	}
-      else
+
+      if ( ASDCP_SUCCESS(result) )
 	{
-	  ASDCP::AIFF::SimpleAIFFHeader AIFFHeader;
-	  m_FileReader.Seek(0);
+	  // a truncated file cannot supply more than is mapped
+	  m_DataLength = Kumu::xmin(m_DataLength, m_FileMap.MapSize() - Kumu::xmin((ui64_t)m_DataStart, m_FileMap.MapSize()));
+	  m_ADesc.ContainerDuration = m_DataLength / m_SourceFrameSize;
+	  result = m_ViewBuf.Capacity(m_FrameBufferSize);
+	}
+    }
+  else
+    {
+      result = m_FileReader.OpenRead(filename);
 
-      result = AIFFHeader.ReadFromFile(m_FileReader, &m_DataStart);
+      if ( ASDCP_SUCCESS(result) )
+	{
+	  ui32_t read_count = 0;
+	  FrameBuffer HeaderBuf(MaxWavHeader);
+	  result = m_FileReader.Read(HeaderBuf.Data(), HeaderBuf.Capacity(), &read_count);
 
 	  if ( ASDCP_SUCCESS(result) )
-	    {
-	      AIFFHeader.FillADesc(m_ADesc, PictureRate);
-	      m_FrameBufferSize = ASDCP::PCM::CalcFrameBufferSize(m_ADesc);
-	      m_DataLength = AIFFHeader.data_len;
-	      m_ADesc.ContainerDuration = m_DataLength / m_FrameBufferSize;
-	      m_ADesc.ChannelFormat = PCM::CF_NONE;
-	      Reset();
-	    }
-	  else
-	    {
-	      SimpleRF64Header RF64Header;
-	      m_FileReader.Seek(0);
-          result = RF64Header.ReadFromFile(m_FileReader, &m_DataStart);
-
-	      if ( ASDCP_SUCCESS(result) )
-		{
-		  RF64Header.FillADesc(m_ADesc, PictureRate);
-		  m_FrameBufferSize = ASDCP::PCM::CalcFrameBufferSize(m_ADesc);
-		  m_DataLength = RF64Header.data_len;
-		  m_ADesc.ContainerDuration = m_DataLength / m_FrameBufferSize;
-		  m_ADesc.ChannelFormat = PCM::CF_NONE;
-		  Reset();
-		}
-	    }
+	    result = ParseHeader(HeaderBuf.RoData(), read_count, PictureRate);
+	}
+    }
+
+  if ( ASDCP_SUCCESS(result) )
+    Reset();
+
+  return result;
+}
+
+// Locates the next frame of file samples. In mapped mode src points into the
+// mapping, otherwise the samples are read into read_buf.
+ASDCP::Result_t
+ASDCP::PCM::WAVParser::h__WAVParser::NextSourceFrame(const byte_t** src, ui32_t* src_len, byte_t* read_buf)
+{
+  assert(src && src_len);
+  ui32_t read_len = (m_DataLength - m_ReadCount >= m_SourceFrameSize) ? m_SourceFrameSize : m_DataLength - m_ReadCount;
+  ui32_t read_count = 0;
+  Result_t result = RESULT_OK;
+
+  if ( m_Mapped )
+    {
+      *src = m_FileMap.MapData() + m_DataStart + m_ReadCount;
+      read_count = read_len;
+
+      if ( read_count == 0 )
+	result = RESULT_ENDOFFILE;
+    }
+  else
+    {
+      assert(read_buf);
+      *src = read_buf;
+      result = m_FileReader.Read(read_buf, read_len, &read_count);
+    }
+
+  if ( result == RESULT_ENDOFFILE || (m_DataLength == m_ReadCount + read_count) )
+    {
+      m_EOF = true;
+
+      if ( read_count > 0 )
+	{
+	  result = RESULT_OK;
 	}
     }
 
+  if ( ASDCP_SUCCESS(result) )
+    m_ReadCount += read_count;
+
+  *src_len = read_count;
   return result;
 }
 
@@ -169,22 +521,24 @@ ASDCP::PCM::WAVParser::h__WAVParser::ReadFrame(FrameBuffer& FB)
       return RESULT_SMALLBUF;
     }
 
+  const byte_t* src = 0;
   ui32_t read_count = 0;
-  Result_t result = m_FileReader.Read(FB.Data(), (m_DataLength - m_ReadCount >= m_FrameBufferSize) ? m_FrameBufferSize : m_DataLength - m_ReadCount, &read_count);
+  Result_t result = NextSourceFrame(&src, &read_count, Converting() ? m_SourceBuf.Data() : FB.Data());
 
-  if ( result == RESULT_ENDOFFILE || (m_DataLength == m_ReadCount + read_count) )
+  if ( ASDCP_SUCCESS(result) )
     {
-      m_EOF = true;
-
-      if ( read_count > 0 )
+      if ( Converting() )
 	{
-	  result = RESULT_OK;
+	  ui32_t source_sample_size = m_SourceBits / 8;
+	  read_count -= read_count % source_sample_size;
+	  ConvertFrame(src, read_count, FB.Data());
+	  read_count = ( read_count / source_sample_size ) * 3;
+	}
+      else if ( src != FB.RoData() )
+	{
+	  memcpy(FB.Data(), src, read_count);
 	}
-    }
 
-  if ( ASDCP_SUCCESS(result) )
-    {
-      m_ReadCount += read_count;
       FB.Size(read_count);
       FB.FrameNumber(m_FramesRead++);
 
@@ -197,12 +551,66 @@ ASDCP::PCM::WAVParser::h__WAVParser::ReadFrame(FrameBuffer& FB)
   return result;
 }
 
+// Whole unconverted frames are exposed in place. Converted frames and a short
+// final frame are built in m_ViewBuf, which is zero-padded as ReadFrame() does.
+ASDCP::Result_t
+ASDCP::PCM::WAVParser::h__WAVParser::ReadFrameView(FrameBuffer& FB)
+{
+  if ( ! m_Mapped )
+    return RESULT_STATE;
+
+  if ( m_EOF )
+    {
+      FB.Size(0);
+      return RESULT_ENDOFFILE;
+    }
+
+  const byte_t* src = 0;
+  ui32_t read_count = 0;
+  Result_t result = NextSourceFrame(&src, &read_count, 0);
+
+  if ( ASDCP_SUCCESS(result) )
+    {
+      if ( ! Converting() && read_count == m_FrameBufferSize )
+	{
+	  FB.SetData(const_cast<byte_t*>(src), read_count);
+	}
+      else
+	{
+	  if ( Converting() )
+	    {
+	      ui32_t source_sample_size = m_SourceBits / 8;
+	      read_count -= read_count % source_sample_size;
+	      ConvertFrame(src, read_count, m_ViewBuf.Data());
+	      read_count = ( read_count / source_sample_size ) * 3;
+	    }
+	  else
+	    {
+	      memcpy(m_ViewBuf.Data(), src, read_count);
+	    }
+
+	  memset(m_ViewBuf.Data() + read_count, 0, m_ViewBuf.Capacity() - read_count);
+	  FB.SetData(m_ViewBuf.Data(), m_FrameBufferSize);
+	}
+
+      FB.Size(read_count);
+      FB.FrameNumber(m_FramesRead++);
+    }
+
+  return result;
+}
+
 //
 ASDCP::Result_t ASDCP::PCM::WAVParser::h__WAVParser::Seek(ui32_t frame_number)
 {
   m_FramesRead = frame_number - 1;
-  m_ReadCount = 0;
-  return m_FileReader.Seek(m_DataStart + m_FrameBufferSize * frame_number);
+  m_ReadCount = Kumu::xmin((ui64_t)m_SourceFrameSize * frame_number, m_DataLength);
+  m_EOF = false;
+
+  if ( m_Mapped )
+    return RESULT_OK;
+
+  return m_FileReader.Seek(m_DataStart + (Kumu::fpos_t)m_ReadCount);
 }
 
 
@@ -219,11 +627,27 @@ ASDCP::PCM::WAVParser::~WAVParser()
 // Opens the stream for reading, parses enough data to provide a complete
 // set of stream metadata for the MXFWriter below.
 ASDCP::Result_t
-ASDCP::PCM::WAVParser::OpenRead(const std::string& filename, const Rational& PictureRate) const
+ASDCP::PCM::WAVParser::OpenRead(const std::string& filename, const Rational& PictureRate,
+				SampleConversion_t Conversion) const
+{
+  const_cast<ASDCP::PCM::WAVParser*>(this)->m_Parser = new h__WAVParser;
+
+  Result_t result = m_Parser->OpenRead(filename, PictureRate, Conversion, false);
+
+  if ( ASDCP_FAILURE(result) )
+    const_cast<ASDCP::PCM::WAVParser*>(this)->m_Parser.release();
+
+  return result;
+}
+
+// Opens the stream as OpenRead() does, but maps the file into memory.
+ASDCP::Result_t
+ASDCP::PCM::WAVParser::OpenReadMapped(const std::string& filename, const Rational& PictureRate,
+				      SampleConversion_t Conversion) const
 {
   const_cast<ASDCP::PCM::WAVParser*>(this)->m_Parser = new h__WAVParser;
 
-  Result_t result = m_Parser->OpenRead(filename, PictureRate);
+  Result_t result = m_Parser->OpenRead(filename, PictureRate, Conversion, true);
 
   if ( ASDCP_FAILURE(result) )
     const_cast<ASDCP::PCM::WAVParser*>(this)->m_Parser.release();
@@ -253,6 +677,23 @@ ASDCP::PCM::WAVParser::ReadFrame(FrameBuffer& FB) const
   return m_Parser->ReadFrame(FB);
 }
 
+// Points the frame buffer at the next frame in the mapped file.
+ASDCP::Result_t
+ASDCP::PCM::WAVParser::ReadFrameView(FrameBuffer& FB) const
+{
+  if ( m_Parser.empty() )
+    return RESULT_INIT;
+
+  return m_Parser->ReadFrameView(FB);
+}
+
+//
+bool
+ASDCP::PCM::WAVParser::IsMapped() const
+{
+  return ! m_Parser.empty() && m_Parser->Mapped();
+}
+
 ASDCP::Result_t
 ASDCP::PCM::WAVParser::FillAudioDescriptor(AudioDescriptor& ADesc) const
 {
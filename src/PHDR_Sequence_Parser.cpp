@@ -99,15 +99,18 @@ class AS_02::PHDR::SequenceParser::h__SequenceParser
   FileList::iterator m_CurrentFile;
   ASDCP::JP2K::CodestreamParser   m_Parser;
   bool               m_Pedantic;
+  ui32_t             m_ReadAhead;      // frames to read ahead, 0 to read on demand
+  Kumu::FileReadAhead m_ReadAheadFiles; // each frame's codestream followed by its metadata
 
   Result_t OpenRead();
+  Result_t ReadFrameAhead(FrameBuffer&);
 
   ASDCP_NO_COPY_CONSTRUCT(h__SequenceParser);
 
 public:
   ASDCP::JP2K::PictureDescriptor  m_PDesc;
 
-  h__SequenceParser() : m_FramesRead(0), m_Pedantic(false)
+  h__SequenceParser() : m_FramesRead(0), m_Pedantic(false), m_ReadAhead(0)
   {
     memset(&m_PDesc, 0, sizeof(m_PDesc));
     m_PDesc.EditRate = Rational(24,1); 
@@ -120,15 +123,20 @@ public:
 
   Result_t OpenRead(const std::string& filename, bool pedantic);
   Result_t OpenRead(const std::list<std::string>& file_list, bool pedantic);
-  void     Close() {}
+  void     Close()
+  {
+    m_ReadAheadFiles.Stop();
+  }
 
   Result_t Reset()
   {
+    Close();
     m_FramesRead = 0;
     m_CurrentFile = m_FileList.begin();
     return RESULT_OK;
   }
 
+  Result_t SetReadAhead(ui32_t frame_count);
   Result_t ReadFrame(FrameBuffer&);
 };
 
@@ -280,6 +288,116 @@ operator==(const ASDCP::JP2K::PictureDescriptor& lhs, const ASDCP::JP2K::Picture
   return true;
 }
 
+//
+static std::string
+MetadataPath(const std::string& codestream_path)
+{
+  return PathJoin(PathDirname(codestream_path), PathSetExtension(codestream_path, "xml"));
+}
+
+//
+ASDCP::Result_t
+AS_02::PHDR::SequenceParser::h__SequenceParser::SetReadAhead(ui32_t frame_count)
+{
+#ifdef KM_WIN32
+  return frame_count == 0 ? RESULT_OK : RESULT_NOTIMPL;
+#else
+  Close();
+  m_ReadAhead = frame_count;
+  return RESULT_OK;
+#endif
+}
+
+// Copies the current frame and its metadata out of the read-ahead buffers and
+// parses the codestream in memory, as CodestreamParser::OpenReadFrame() does
+// when reading the file. Frame n's codestream is file 2n of the read-ahead list
+// and its metadata is file 2n + 1.
+ASDCP::Result_t
+AS_02::PHDR::SequenceParser::h__SequenceParser::ReadFrameAhead(FrameBuffer& FB)
+{
+  Result_t result = RESULT_OK;
+
+  if ( ! m_ReadAheadFiles.Running() )
+    {
+      std::list<std::string> read_list;
+      FileList::const_iterator i;
+
+      for ( i = m_FileList.begin(); i != m_FileList.end(); ++i )
+	{
+	  read_list.push_back(*i);
+	  read_list.push_back(MetadataPath(*i));
+	}
+
+      result = m_ReadAheadFiles.Start(read_list, m_FramesRead * 2, m_ReadAhead * 2);
+    }
+
+  ByteString* ReadBuf = 0;
+  std::string metadata_path = MetadataPath(*m_CurrentFile);
+
+  if ( KM_SUCCESS(result) )
+    result = m_ReadAheadFiles.Acquire(m_FramesRead * 2, ReadBuf);
+
+  if ( KM_SUCCESS(result) && FB.Capacity() < ReadBuf->Length() )
+    {
+      DefaultLogSink().Error("FrameBuf.Capacity: %u frame length: %u\n", FB.Capacity(), ReadBuf->Length());
+      result = RESULT_SMALLBUF;
+    }
+
+  if ( KM_SUCCESS(result) )
+    {
+      memcpy(FB.Data(), ReadBuf->RoData(), ReadBuf->Length());
+      FB.Size(ReadBuf->Length());
+
+      byte_t start_of_data = 0; // out param
+      ASDCP::JP2K::PictureDescriptor PDesc;
+      memset(&PDesc, 0, sizeof(PDesc));
+      PDesc.EditRate = Rational(24,1);
+      PDesc.SampleRate = PDesc.EditRate;
+      result = ASDCP::JP2K::ParseMetadataIntoDesc(FB, PDesc, &start_of_data);
+
+      if ( KM_SUCCESS(result) )
+	FB.PlaintextOffset(start_of_data);
+
+      if ( KM_SUCCESS(result) && m_Pedantic && ! ( m_PDesc == PDesc ) )
+	{
+	  Kumu::DefaultLogSink().Error("JPEG-2000 codestream parameters do not match at frame %d\n", m_FramesRead + 1);
+	  result = RESULT_RAW_FORMAT;
+	}
+    }
+  else
+    {
+      DefaultLogSink().Error("%s: %s\n", m_CurrentFile->c_str(), result.Label());
+    }
+
+  m_ReadAheadFiles.Release(m_FramesRead * 2);
+
+  if ( KM_SUCCESS(result) )
+    {
+      result = m_ReadAheadFiles.Acquire(m_FramesRead * 2 + 1, ReadBuf);
+
+      if ( KM_SUCCESS(result) && ReadBuf->Length() > 8 * Megabyte )
+	{
+	  DefaultLogSink().Error("%s: exceeds available buffer size (%u)\n", metadata_path.c_str(), 8 * Megabyte);
+	  result = RESULT_ALLOC;
+	}
+      else if ( KM_SUCCESS(result) )
+	{
+	  FB.OpaqueMetadata.assign((const char*)ReadBuf->RoData(), ReadBuf->Length());
+	}
+      else
+	{
+	  DefaultLogSink().Error("%s: %s\n", metadata_path.c_str(), result.Label());
+	}
+    }
+
+  m_ReadAheadFiles.Release(m_FramesRead * 2 + 1);
+
+  if ( KM_FAILURE(result) )
+    Close(); // the frame is read again if ReadFrame() is retried
+
+  return result;
+}
+
 //
 ASDCP::Result_t
 AS_02::PHDR::SequenceParser::h__SequenceParser::ReadFrame(FrameBuffer& FB)
@@ -287,9 +405,22 @@ AS_02::PHDR::SequenceParser::h__SequenceParser::ReadFrame(FrameBuffer& FB)
   if ( m_CurrentFile == m_FileList.end() )
     return RESULT_ENDOFFILE;
 
+  if ( m_ReadAhead > 0 )
+    {
+      Result_t result = ReadFrameAhead(FB);
+
+      if ( KM_SUCCESS(result) )
+	{
+	  FB.FrameNumber(m_FramesRead++);
+	  m_CurrentFile++;
+	}
+
+      return result;
+    }
+
   // open the file
   Result_t result = m_Parser.OpenReadFrame(*m_CurrentFile, FB);
-  std::string metadata_path = PathJoin(PathDirname(*m_CurrentFile), PathSetExtension(*m_CurrentFile, "xml"));
+  std::string metadata_path = MetadataPath(*m_CurrentFile);
 
   if ( KM_SUCCESS(result) )
     {
@@ -388,6 +519,16 @@ AS_02::PHDR::SequenceParser::ReadFrame(AS_02::PHDR::FrameBuffer& FB) const
   return m_Parser->ReadFrame(FB);
 }
 
+//
+ASDCP::Result_t
+AS_02::PHDR::SequenceParser::SetReadAhead(ui32_t frame_count) const
+{
+  if ( m_Parser.empty() )
+    return RESULT_INIT;
+
+  return m_Parser->SetReadAhead(frame_count);
+}
+
 //
 ASDCP::Result_t
 AS_02::PHDR::SequenceParser::FillPictureDescriptor(ASDCP::JP2K::PictureDescriptor& PDesc) const
@@ -121,13 +121,82 @@ setup_default_font_family_list()
 //------------------------------------------------------------------------------------------
 
 
-AS_02::TimedText::Type5UUIDFilenameResolver::Type5UUIDFilenameResolver() {}
+static const ui32_t DefaultResourceProbeThreads = 8;
+static const char* c_resource_cache_tag = "Type5UUIDFilenameResolver/1";
+
+AS_02::TimedText::Type5UUIDFilenameResolver::Type5UUIDFilenameResolver() : m_ProbeThreads(DefaultResourceProbeThreads) {}
 AS_02::TimedText::Type5UUIDFilenameResolver::~Type5UUIDFilenameResolver() {}
 
 const byte_t PNGMagic[8] = { 0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a };
 const byte_t OpenTypeMagic[5] = { 0x4f, 0x54, 0x54, 0x4f, 0x00 };
 const byte_t TrueTypeMagic[5] = { 0x00, 0x01, 0x00, 0x00, 0x00 };
 
+// One directory entry to be sniffed. The results are kept in directory order
+// so that the first of several files having the same UUID wins, as it always has.
+struct ResourceProbe
+{
+  std::string name;
+  UUID asset_id;
+  bool is_resource;
+
+  ResourceProbe(const std::string& n) : name(n), is_resource(false) {}
+};
+
+typedef std::vector<ResourceProbe> ResourceProbeList;
+
+//
+static void
+probe_resource_file(const std::string& abs_dirname, ResourceProbe& probe)
+{
+  byte_t read_buffer[16];
+  FileReader reader;
+  Result_t read_result = reader.OpenRead(PathJoin(abs_dirname, probe.name));
+
+  if ( KM_SUCCESS(read_result) )
+    {
+      read_result = reader.Read(read_buffer, 16);
+    }
+
+  if ( KM_SUCCESS(read_result) )
+    {
+      // is it PNG?
+      if ( memcmp(read_buffer, PNGMagic, sizeof(PNGMagic)) == 0 )
+	{
+	  probe.asset_id.Set(AS_02::TimedText::CreatePNGNameId(PathBasename(probe.name)).Value());
+	  probe.is_resource = true;
+	}
+      // is it a font?
+      else if ( memcmp(read_buffer, OpenTypeMagic, sizeof(OpenTypeMagic)) == 0
+		|| memcmp(read_buffer, TrueTypeMagic, sizeof(TrueTypeMagic)) == 0 )
+	{
+	  std::string font_root_name = PathSetExtension(probe.name, "");
+	  probe.asset_id.Set(AS_02::TimedText::CreateFontNameId(PathBasename(font_root_name)).Value());
+	  probe.is_resource = true;
+	}
+    }
+}
+
+// Sniffs one entry of the list per work item.
+class ResourceProbeHandler : public Kumu::IWorkItemHandler
+{
+  const std::string& m_AbsDirname;
+  ResourceProbeList& m_Probes;
+
+  KM_NO_COPY_CONSTRUCT(ResourceProbeHandler);
+  ResourceProbeHandler();
+
+public:
+  ResourceProbeHandler(const std::string& d, ResourceProbeList& p) : m_AbsDirname(d), m_Probes(p) {}
+  void HandleItem(ui32_t index) { probe_resource_file(m_AbsDirname, m_Probes[index]); }
+};
+
+//
+void
+AS_02::TimedText::Type5UUIDFilenameResolver::SetProbeThreads(ui32_t thread_count)
+{
+  m_ProbeThreads = thread_count;
+}
+
 //
 Result_t
 AS_02::TimedText::Type5UUIDFilenameResolver::OpenRead(const std::string& dirname)
@@ -136,7 +205,7 @@ AS_02::TimedText::Type5UUIDFilenameResolver::OpenRead(const std::string& dirname
   DirectoryEntryType_t ft;
   std::string next_item;
   std::string abs_dirname = PathMakeCanonical(dirname);
-  byte_t read_buffer[16];
+  ResourceProbeList probes;
 
   if ( abs_dirname.empty() )
     {
@@ -150,35 +219,21 @@ AS_02::TimedText::Type5UUIDFilenameResolver::OpenRead(const std::string& dirname
       while ( KM_SUCCESS(dir_reader.GetNext(next_item, ft)) )
         {
           if ( next_item[0] == '.' ) continue; // no hidden files
-	  std::string tmp_path = PathJoin(abs_dirname, next_item);
 
 	  if ( ft == DET_FILE )
 	    {
-	      FileReader reader;
-	      Result_t read_result = reader.OpenRead(tmp_path);
-
-	      if ( KM_SUCCESS(read_result) )
-		{
-		  read_result = reader.Read(read_buffer, 16);
-		}
-
-	      if ( KM_SUCCESS(read_result) )
-		{
-		  // is it PNG?
-		  if ( memcmp(read_buffer, PNGMagic, sizeof(PNGMagic)) == 0 )
-		    {
-		      UUID asset_id = CreatePNGNameId(PathBasename(next_item));
-		      m_ResourceMap.insert(ResourceMap::value_type(asset_id, next_item));
-		    }
-		  // is it a font?
-		  else if ( memcmp(read_buffer, OpenTypeMagic, sizeof(OpenTypeMagic)) == 0
-			    || memcmp(read_buffer, TrueTypeMagic, sizeof(TrueTypeMagic)) == 0 )
-		    {
-		      std::string font_root_name = PathSetExtension(next_item, "");
-		      UUID asset_id = CreateFontNameId(PathBasename(font_root_name));
-		      m_ResourceMap.insert(ResourceMap::value_type(asset_id, next_item));
-		    }
-		}
+	      probes.push_back(ResourceProbe(next_item));
+	    }
+	}
+
+      ResourceProbeHandler handler(abs_dirname, probes);
+      RunWorkQueue(probes.size(), m_ProbeThreads, handler);
+
+      for ( ResourceProbeList::const_iterator i = probes.begin(); i != probes.end(); ++i )
+	{
+	  if ( i->is_resource )
+	    {
+	      m_ResourceMap.insert(ResourceMap::value_type(i->asset_id, i->name));
 	    }
 	}
     }
@@ -186,6 +241,112 @@ AS_02::TimedText::Type5UUIDFilenameResolver::OpenRead(const std::string& dirname
   return result;
 }
 
+//
+Result_t
+AS_02::TimedText::Type5UUIDFilenameResolver::OpenRead(const std::string& dirname, const std::string& cache_filename)
+{
+  std::string abs_dirname = PathMakeCanonical(dirname);
+
+  if ( abs_dirname.empty() )
+    {
+      abs_dirname = ".";
+    }
+
+  // take the stamp before scanning, so that a change made during the scan
+  // leaves a cache that will be found stale next time
+  ui64_t dir_stamp = PathModificationTime(abs_dirname);
+
+  std::string cache_key = PathMakeAbsolute(abs_dirname);
+
+  if ( dir_stamp != 0 && KM_SUCCESS(ReadCache(cache_filename, cache_key, dir_stamp)) )
+    {
+      return RESULT_OK;
+    }
+
+  Result_t result = OpenRead(dirname);
+
+  if ( KM_SUCCESS(result) && dir_stamp != 0 )
+    {
+      if ( KM_FAILURE(WriteCache(cache_filename, cache_key, dir_stamp)) )
+	{
+	  DefaultLogSink().Warn("Unable to write resource cache file %s.\n", cache_filename.c_str());
+	}
+    }
+
+  return result;
+}
+
+// The cache is a text file: a header line holding the format tag, the directory
+// stamp and the directory name, then one line per resource holding the UUID in
+// hex and the file name.
+Result_t
+AS_02::TimedText::Type5UUIDFilenameResolver::ReadCache(const std::string& cache_filename,
+						       const std::string& abs_dirname, ui64_t dir_stamp)
+{
+  std::string cache_doc;
+  char identbuf[IdentBufferLen];
+
+  if ( ! PathIsFile(cache_filename) || KM_FAILURE(ReadFileIntoString(cache_filename, cache_doc, 64 * Megabyte)) )
+    {
+      return RESULT_NOT_FOUND;
+    }
+
+  std::string header = std::string(c_resource_cache_tag) + " " + ui64sz(dir_stamp, identbuf) + " " + abs_dirname + "\n";
+
+  if ( cache_doc.compare(0, header.size(), header) != 0 )
+    {
+      return RESULT_NOT_FOUND;
+    }
+
+  ResourceMap cache_map;
+  std::string::size_type pos = header.size();
+
+  while ( pos < cache_doc.size() )
+    {
+      std::string::size_type eol = cache_doc.find('\n', pos);
+      UUID asset_id;
+
+      if ( eol == std::string::npos || eol < pos + 34 || cache_doc[pos + 32] != ' '
+	   || ! asset_id.DecodeHex(cache_doc.substr(pos, 32).c_str()) )
+	{
+	  return RESULT_NOT_FOUND;
+	}
+
+      cache_map.insert(ResourceMap::value_type(asset_id, cache_doc.substr(pos + 33, eol - pos - 33)));
+      pos = eol + 1;
+    }
+
+  m_ResourceMap.insert(cache_map.begin(), cache_map.end());
+  return RESULT_OK;
+}
+
+//
+Result_t
+AS_02::TimedText::Type5UUIDFilenameResolver::WriteCache(const std::string& cache_filename,
+							const std::string& abs_dirname, ui64_t dir_stamp) const
+{
+  char identbuf[IdentBufferLen];
+  char hexbuf[64];
+  std::string cache_doc = std::string(c_resource_cache_tag) + " " + ui64sz(dir_stamp, identbuf) + " " + abs_dirname + "\n";
+
+  if ( abs_dirname.find('\n') != std::string::npos )
+    {
+      return RESULT_PARAM;
+    }
+
+  for ( ResourceMap::const_iterator i = m_ResourceMap.begin(); i != m_ResourceMap.end(); ++i )
+    {
+      if ( i->second.find('\n') != std::string::npos )
+	{
+	  return RESULT_PARAM;
+	}
+
+      cache_doc += std::string(bin2hex(i->first.Value(), UUID_Length, hexbuf, 64)) + " " + i->second + "\n";
+    }
+
+  return WriteStringIntoFile(cache_filename, cache_doc);
+}
+
 //
 Result_t
 AS_02::TimedText::Type5UUIDFilenameResolver::ResolveRID(const byte_t* uuid, ASDCP::TimedText::FrameBuffer& FrameBuf) const
@@ -228,7 +389,6 @@ typedef std::map<Kumu::UUID, ASDCP::TimedText::MIMEType_t> ResourceTypeMap_t;
 
 class AS_02::TimedText::ST2052_TextParser::h__TextParser
 {
-  XMLElement  m_Root;
   ResourceTypeMap_t m_ResourceTypes;
   Result_t OpenRead();
 
@@ -236,11 +396,11 @@ class AS_02::TimedText::ST2052_TextParser::h__TextParser
 
 public:
   std::string m_Filename;
-  std::string m_XMLDoc;
+  std::string m_XMLDoc; // the whole document; ReadTimedTextResource() returns it
   TimedTextDescriptor  m_TDesc;
   ASDCP::mem_ptr<ASDCP::TimedText::IResourceResolver> m_DefaultResolver;
 
-  h__TextParser() : m_Root("**ParserRoot**")
+  h__TextParser()
   {
     memset(&m_TDesc.AssetID, 0, UUIDlen);
   }
@@ -294,13 +454,52 @@ AS_02::TimedText::ST2052_TextParser::h__TextParser::OpenRead(const std::string&
 std::string const IMSC1_imageProfile = "http://www.w3.org/ns/ttml/profile/imsc1/image";
 std::string const IMSC1_textProfile = "http://www.w3.org/ns/ttml/profile/imsc1/text";
 
+// Collects the profile indicators and the image and font references of an
+// ST 2052-1 document in a single pass, without building an element tree.
+// The document element itself is not examined.
+class ST2052StreamHandler : public Kumu::IXMLStreamHandler
+{
+  KM_NO_COPY_CONSTRUCT(ST2052StreamHandler);
+
+public:
+  std::set<std::string> ConformsToStandard, Profiles, BackgroundImages, FontFamilies;
+
+  ST2052StreamHandler() {}
+
+  bool StartElement(const std::string&, const std::string& name, const AttributeList& attrs, ui32_t depth)
+  {
+    if ( depth == 0 )
+      return false;
+
+    for ( Attr_i i = attrs.begin(); i != attrs.end(); ++i )
+      {
+	if ( i->name == "profile" )
+	  Profiles.insert(i->value);
+	else if ( i->name == "backgroundImage" )
+	  BackgroundImages.insert(i->value);
+	else if ( i->name == "fontFamily" )
+	  FontFamilies.insert(i->value);
+      }
+
+    return name == "conformsToStandard";
+  }
+
+  void EndElement(const std::string& name, const std::string& body, ui32_t depth)
+  {
+    if ( depth > 0 && name == "conformsToStandard" )
+      ConformsToStandard.insert(body);
+  }
+};
+
 //
 Result_t
 AS_02::TimedText::ST2052_TextParser::h__TextParser::OpenRead()
 {
   setup_default_font_family_list();
 
-  if ( ! m_Root.ParseString(m_XMLDoc.c_str()) )
+  ST2052StreamHandler Doc;
+
+  if ( ! ParseXMLStream(m_XMLDoc, Doc) )
     {
       DefaultLogSink(). Error("ST 2052-1 document is not well-formed.\n");
       return RESULT_FORMAT;
@@ -314,10 +513,7 @@ AS_02::TimedText::ST2052_TextParser::h__TextParser::OpenRead()
   // Attempt to set the profile from <conformsToStandard>
   if ( m_TDesc.NamespaceName.empty() )
     {
-      ElementVisitor conforms_visitor("conformsToStandard");
-      apply_visitor(m_Root, conforms_visitor);
-
-      for ( i = conforms_visitor.value_list.begin(); i != conforms_visitor.value_list.end(); ++i )
+      for ( i = Doc.ConformsToStandard.begin(); i != Doc.ConformsToStandard.end(); ++i )
 	{
 	  if ( *i == IMSC1_imageProfile || *i == IMSC1_textProfile )
 	    {
@@ -330,10 +526,7 @@ AS_02::TimedText::ST2052_TextParser::h__TextParser::OpenRead()
   // Attempt to set the profile from the use of attribute "profile"
   if ( m_TDesc.NamespaceName.empty() )
     {
-      AttributeVisitor profile_visitor("profile");
-      apply_visitor(m_Root, profile_visitor);
-
-      for ( i = profile_visitor.value_list.begin(); i != profile_visitor.value_list.end(); ++i )
+      for ( i = Doc.Profiles.begin(); i != Doc.Profiles.end(); ++i )
 	{
 	  if ( *i == IMSC1_imageProfile || *i == IMSC1_textProfile )
 	    {
@@ -345,10 +538,7 @@ AS_02::TimedText::ST2052_TextParser::h__TextParser::OpenRead()
 
   // Find image resources for later packaging as GS partitions.
   // Attempt to set the profile; infer from use of images.
-  AttributeVisitor png_visitor("backgroundImage");
-  apply_visitor(m_Root, png_visitor);
-
-  for ( i = png_visitor.value_list.begin(); i != png_visitor.value_list.end(); ++i )
+  for ( i = Doc.BackgroundImages.begin(); i != Doc.BackgroundImages.end(); ++i )
     {
       UUID asset_id = CreatePNGNameId(PathBasename(*i));
       TimedTextResourceDescriptor png_resource;
@@ -378,11 +568,9 @@ AS_02::TimedText::ST2052_TextParser::h__TextParser::OpenRead()
     }
 
   // Find font resources for later packaging as GS partitions.
-  AttributeVisitor font_visitor("fontFamily");
-  apply_visitor(m_Root, font_visitor);
   char buf[64];
 
-  for ( i = font_visitor.value_list.begin(); i != font_visitor.value_list.end(); ++i )
+  for ( i = Doc.FontFamilies.begin(); i != Doc.FontFamilies.end(); ++i )
     {
       UUID font_id = CreateFontNameId(PathBasename(*i));
 
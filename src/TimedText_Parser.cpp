@@ -47,19 +47,94 @@ static const char* c_dcst_namespace_name = "http://www.smpte-ra.org/schemas/428-
 ASDCP::TimedText::LocalFilenameResolver::LocalFilenameResolver() {}
 ASDCP::TimedText::LocalFilenameResolver::~LocalFilenameResolver() {}
 
+namespace {
+  const ui32_t UUIDStringLength = 36; // xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
+  const ui32_t ResourceBufferGrowth = 64 * Kumu::Kilobyte; // see ResolveRID()
+
+  // true if the UUIDStringLength characters at p have the form produced
+  // by UUID::EncodeHex()
+  inline bool
+  is_uuid_string(const char* p)
+  {
+    for ( ui32_t i = 0; i < UUIDStringLength; ++i )
+      {
+	if ( i == 8 || i == 13 || i == 18 || i == 23 )
+	  {
+	    if ( p[i] != '-' )
+	      return false;
+	  }
+	else if ( ! ( ( p[i] >= '0' && p[i] <= '9' ) || ( p[i] >= 'a' && p[i] <= 'f' ) ) )
+	  {
+	    return false;
+	  }
+      }
+
+    return true;
+  }
+
+  // Walks the directory tree below dirname (as FindInPath() does) and indexes each
+  // non-hidden file under every UUID string that appears in its name.
+  void
+  index_resource_files(const std::string& dirname, std::map<Kumu::UUID, PathList_t>& resource_map)
+  {
+    char name_buf[MaxFilePath];
+    DirScanner Dir;
+
+    if ( KM_FAILURE(Dir.Open(dirname.c_str())) )
+      return;
+
+    while ( KM_SUCCESS(Dir.GetNext(name_buf)) )
+      {
+	if ( name_buf[0] == '.' ) continue; // no hidden files
+	std::string tmp_path = dirname + '/' + name_buf;
+
+	if ( PathIsDirectory(tmp_path) )
+	  {
+	    index_resource_files(tmp_path, resource_map);
+	    continue;
+	  }
+
+	ui32_t name_len = strlen(name_buf);
+
+	for ( ui32_t i = 0; i + UUIDStringLength <= name_len; ++i )
+	  {
+	    if ( ! is_uuid_string(name_buf + i) )
+	      continue;
+
+	    UUID tmp_id;
+
+	    if ( tmp_id.DecodeHex(std::string(name_buf + i, UUIDStringLength).c_str()) )
+	      {
+		PathList_t& path_list = resource_map[tmp_id];
+
+		if ( path_list.empty() || path_list.back() != tmp_path )
+		  path_list.push_back(tmp_path);
+	      }
+	  }
+      }
+  }
+}
+
 //
 Result_t
 ASDCP::TimedText::LocalFilenameResolver::OpenRead(const std::string& dirname)
 {
+  Result_t result = RESULT_OK;
+  m_ResourceMap.clear();
+
   if ( PathIsDirectory(dirname) )
     {
       m_Dirname = dirname;
-      return RESULT_OK;
+    }
+  else
+    {
+      DefaultLogSink().Error("Path '%s' is not a directory, defaulting to '.'\n", dirname.c_str());
+      m_Dirname = ".";
+      result = RESULT_FALSE;
     }
 
-  DefaultLogSink().Error("Path '%s' is not a directory, defaulting to '.'\n", dirname.c_str());
-  m_Dirname = ".";
-  return RESULT_FALSE;
+  index_resource_files(m_Dirname, m_ResourceMap);
+  return result;
 }
 
 //
@@ -69,12 +144,14 @@ ASDCP::TimedText::LocalFilenameResolver::ResolveRID(const byte_t* uuid, TimedTex
   Result_t result = RESULT_NOT_FOUND;
   char buf[64];
   UUID RID(uuid);
-  PathList_t found_list;
+  RID.EncodeHex(buf, 64);
+
+  ResourceMap::const_iterator i = m_ResourceMap.find(RID);
 
-#ifndef KM_WIN32
-  // TODO, fix this for win32 (needs regex)
-  FindInPath(PathMatchRegex(RID.EncodeHex(buf, 64)), m_Dirname, found_list);
-#endif
+  if ( i == m_ResourceMap.end() )
+    return result;
+
+  const PathList_t& found_list = i->second;
 
   if ( found_list.size() == 1 )
     {
@@ -86,8 +163,14 @@ ASDCP::TimedText::LocalFilenameResolver::ResolveRID(const byte_t* uuid, TimedTex
       if ( KM_SUCCESS(result) )
 	{
 	  ui32_t read_count, read_size = Reader.Size();
-	  result = FrameBuf.Capacity(read_size);
-      
+
+	  // The caller's buffer is reallocated only if the resource does not fit, and
+	  // then rounded up to a multiple of ResourceBufferGrowth. A caller that passes
+	  // the same buffer for every resource in a list (as asdcp-wrap does) therefore
+	  // reallocates rarely. No other buffers are kept between calls.
+	  if ( FrameBuf.Capacity() < read_size )
+	    result = FrameBuf.Capacity(( ( read_size / ResourceBufferGrowth ) + 1 ) * ResourceBufferGrowth);
+
 	  if ( KM_SUCCESS(result) )
 	    result = Reader.Read(FrameBuf.Data(), read_size, &read_count);
 
@@ -110,7 +193,6 @@ typedef std::map<Kumu::UUID, TimedText::MIMEType_t> ResourceTypeMap_t;
 
 class ASDCP::TimedText::DCSubtitleParser::h__SubtitleParser
 {
-  XMLElement  m_Root;
   ResourceTypeMap_t m_ResourceTypes;
   Result_t OpenRead();
 
@@ -118,15 +200,14 @@ class ASDCP::TimedText::DCSubtitleParser::h__SubtitleParser
 
 public:
   std::string m_Filename;
-  std::string m_XMLDoc;
+  std::string m_XMLDoc; // the whole document; ReadTimedTextResource() returns it
   TimedTextDescriptor  m_TDesc;
   mem_ptr<LocalFilenameResolver> m_DefaultResolver;
 
-  h__SubtitleParser() : m_Root("**ParserRoot**")
+  h__SubtitleParser()
   {
     memset(&m_TDesc.AssetID, 0, UUIDlen);
   }
-
   ~h__SubtitleParser() {}
 
   TimedText::IResourceResolver* GetDefaultResolver()
@@ -147,10 +228,9 @@ public:
 namespace {
     //
     bool
-    get_UUID_from_element(XMLElement* Element, UUID& ID)
+    get_UUID_from_body(const std::string& body, UUID& ID)
     {
-      assert(Element);
-      const char* p = Element->GetBody().c_str();
+      const char* p = body.c_str();
 
       if ( strncmp(p, "urn:uuid:", 9) == 0 )
         {
@@ -160,21 +240,142 @@ namespace {
       return ID.DecodeHex(p);
     }
 
-    //
-    bool
-    get_UUID_from_child_element(const char* name, XMLElement* Parent, UUID& outID)
+    // Collects the header fields, resource references and timeline extent of
+    // a DCSubtitle document in a single pass, without building an element tree.
+    class DCSubtitleStreamHandler : public Kumu::IXMLStreamHandler
     {
-      assert(name);
-      assert(Parent);
-      XMLElement* Child = Parent->GetChildWithName(name);
+      std::set<Kumu::UUID> m_VisitedImages;
+      std::list<std::string> m_PendingTimeOuts; // TimeOut values seen before EditRate
+      ui32_t m_TCFrameRate;
+
+      KM_NO_COPY_CONSTRUCT(DCSubtitleStreamHandler);
+
+    public:
+      std::string NamespaceName;
+      std::string Id, EditRate, Language, StartTime;
+      bool HasId, HasEditRate, HasLanguage, HasStartTime;
+      std::list<Kumu::UUID> FontList, ImageList;
+      bool BadFont, BadImage;
+      ui32_t SubtitleCount, EndCount;
+
+      DCSubtitleStreamHandler() :
+	m_TCFrameRate(0), HasId(false), HasEditRate(false), HasLanguage(false), HasStartTime(false),
+	BadFont(false), BadImage(false), SubtitleCount(0), EndCount(0) {}
+
+      //
+      void SetTimecodeRate(ui32_t tc_rate)
+      {
+	m_TCFrameRate = tc_rate;
 
-      if ( Child == 0 )
-        {
-          return false;
-        }
+	for ( std::list<std::string>::const_iterator i = m_PendingTimeOuts.begin(); i != m_PendingTimeOuts.end(); ++i )
+	  AddTimeOut(*i);
 
-      return get_UUID_from_element(Child, outID);
-    }
+	m_PendingTimeOuts.clear();
+      }
+
+      void AddTimeOut(const std::string& value)
+      {
+	if ( m_TCFrameRate == 0 )
+	  {
+	    m_PendingTimeOuts.push_back(value);
+	    return;
+	  }
+
+	S12MTimecode tmpTC(value, m_TCFrameRate);
+
+	if ( EndCount < tmpTC.GetFrames() )
+	  EndCount = tmpTC.GetFrames();
+      }
+
+      bool StartElement(const std::string& ns_name, const std::string& name,
+			const AttributeList& attrs, ui32_t depth)
+      {
+	if ( depth == 0 )
+	  {
+	    NamespaceName = ns_name;
+	    return false;
+	  }
+
+	if ( name == "Subtitle" )
+	  {
+	    ++SubtitleCount;
+	    std::string time_out;
+
+	    for ( Attr_i i = attrs.begin(); i != attrs.end(); ++i )
+	      {
+		if ( i->name == "TimeOut" )
+		  {
+		    time_out = i->value;
+		    break;
+		  }
+	      }
+
+	    AddTimeOut(time_out);
+	    return false;
+	  }
+
+	if ( name == "LoadFont" || name == "Image" )
+	  return true;
+
+	if ( depth == 1 )
+	  return ( name == "Id" && ! HasId ) || ( name == "EditRate" && ! HasEditRate )
+	    || ( name == "Language" && ! HasLanguage ) || ( name == "StartTime" && ! HasStartTime );
+
+	return false;
+      }
+
+      void EndElement(const std::string& name, const std::string& body, ui32_t depth)
+      {
+	if ( name == "LoadFont" || name == "Image" )
+	  {
+	    bool is_font = ( name == "LoadFont" );
+	    UUID AssetID;
+
+	    if ( ! get_UUID_from_body(body, AssetID) )
+	      {
+		( is_font ? BadFont : BadImage ) = true;
+	      }
+	    else if ( is_font )
+	      {
+		FontList.push_back(AssetID);
+	      }
+	    else if ( m_VisitedImages.find(AssetID) == m_VisitedImages.end() )
+	      {
+		ImageList.push_back(AssetID);
+		m_VisitedImages.insert(AssetID);
+	      }
+	  }
+
+	if ( depth != 1 )
+	  return;
+
+	if ( name == "Id" && ! HasId )
+	  {
+	    Id = body;
+	    HasId = true;
+	  }
+	else if ( name == "EditRate" && ! HasEditRate )
+	  {
+	    EditRate = body;
+	    HasEditRate = true;
+	    ASDCP::Rational edit_rate;
+
+	    // an unexpected rate is rejected by the caller
+	    if ( DecodeRational(EditRate.c_str(), edit_rate) )
+	      SetTimecodeRate(( edit_rate == EditRate_23_98 ) ? 24 : edit_rate.Numerator);
+	  }
+	else if ( name == "Language" && ! HasLanguage )
+	  {
+	    Language = body;
+	    HasLanguage = true;
+	  }
+	else if ( name == "StartTime" && ! HasStartTime )
+	  {
+	    StartTime = body;
+	    HasStartTime = true;
+	  }
+      }
+    };
 }
 
 //
@@ -212,43 +413,43 @@ ASDCP::TimedText::DCSubtitleParser::h__SubtitleParser::OpenRead(const std::strin
 Result_t
 ASDCP::TimedText::DCSubtitleParser::h__SubtitleParser::OpenRead()
 {
-  if ( ! m_Root.ParseString(m_XMLDoc) )
+  DCSubtitleStreamHandler Doc;
+
+  if ( ! ParseXMLStream(m_XMLDoc, Doc) )
     return RESULT_FORMAT;
 
   m_TDesc.EncodingName = "UTF-8"; // the XML parser demands UTF-8
   m_TDesc.ResourceList.clear();
   m_TDesc.ContainerDuration = 0;
-  const XMLNamespace* ns = m_Root.Namespace();
 
-  if ( ns == 0 )
+  if ( Doc.NamespaceName.empty() )
     {
       DefaultLogSink(). Warn("Document has no namespace name, assuming \"%s\".\n", c_dcst_namespace_name);
       m_TDesc.NamespaceName = c_dcst_namespace_name;
     }
   else
     {
-      m_TDesc.NamespaceName = ns->Name();
+      m_TDesc.NamespaceName = Doc.NamespaceName;
     }
 
   UUID DocID;
-  if ( ! get_UUID_from_child_element("Id", &m_Root, DocID) )
+  if ( ! Doc.HasId || ! get_UUID_from_body(Doc.Id, DocID) )
     {
       DefaultLogSink(). Error("Id element missing from input document.\n");
       return RESULT_FORMAT;
     }
 
   memcpy(m_TDesc.AssetID, DocID.Value(), DocID.Size());
-  XMLElement* EditRate = m_Root.GetChildWithName("EditRate");
 
-  if ( EditRate == 0 )
+  if ( ! Doc.HasEditRate )
     {
       DefaultLogSink().Error("EditRate element missing from input document.\n");
       return RESULT_FORMAT;
     }
 
-  if ( ! DecodeRational(EditRate->GetBody().c_str(), m_TDesc.EditRate) )
+  if ( ! DecodeRational(Doc.EditRate.c_str(), m_TDesc.EditRate) )
     {
-      DefaultLogSink().Error("Error decoding edit rate value: \"%s\"\n", EditRate->GetBody().c_str());
+      DefaultLogSink().Error("Error decoding edit rate value: \"%s\"\n", Doc.EditRate.c_str());
       return RESULT_FORMAT;
     }
 
@@ -272,74 +473,53 @@ ASDCP::TimedText::DCSubtitleParser::h__SubtitleParser::OpenRead()
     }
 
   // Language
-  XMLElement* Language = m_Root.GetChildWithName("Language");
-
-  if ( Language == 0 )
+  if ( ! Doc.HasLanguage )
     {
       DefaultLogSink().Alert("No Written Language detected in input document.\n");
     }
   else
     {
-      m_TDesc.RFC5646LanguageTagList = Language->GetBody().c_str();
+      m_TDesc.RFC5646LanguageTagList = Doc.Language;
     }
 
   // list of fonts
-  ElementList FontList;
-  m_Root.GetChildrenWithName("LoadFont", FontList);
-
-  for ( Elem_i i = FontList.begin(); i != FontList.end(); i++ )
+  if ( Doc.BadFont )
     {
-      UUID AssetID;
-      if ( ! get_UUID_from_element(*i, AssetID) )
-	{
-	  DefaultLogSink(). Error("LoadFont element does not contain a urn:uuid value as expected.\n");
-	  return RESULT_FORMAT;
-	}
+      DefaultLogSink(). Error("LoadFont element does not contain a urn:uuid value as expected.\n");
+      return RESULT_FORMAT;
+    }
 
+  std::list<UUID>::const_iterator i;
+
+  for ( i = Doc.FontList.begin(); i != Doc.FontList.end(); i++ )
+    {
       TimedTextResourceDescriptor TmpResource;
-      memcpy(TmpResource.ResourceID, AssetID.Value(), UUIDlen);
+      memcpy(TmpResource.ResourceID, i->Value(), UUIDlen);
       TmpResource.Type = MT_OPENTYPE;
       m_TDesc.ResourceList.push_back(TmpResource);
       m_ResourceTypes.insert(ResourceTypeMap_t::value_type(UUID(TmpResource.ResourceID), MT_OPENTYPE));
     }
 
-  // list of images
-  ElementList ImageList;
-  m_Root.GetChildrenWithName("Image", ImageList);
-  std::set<Kumu::UUID> visited_items;
-
-  for ( Elem_i i = ImageList.begin(); i != ImageList.end(); i++ )
+  // list of images, duplicates removed
+  if ( Doc.BadImage )
     {
-      UUID AssetID;
-      if ( ! get_UUID_from_element(*i, AssetID) )
-	{
-	  DefaultLogSink(). Error("Image element does not contain a urn:uuid value as expected.\n");
-	  return RESULT_FORMAT;
-	}
+      DefaultLogSink(). Error("Image element does not contain a urn:uuid value as expected.\n");
+      return RESULT_FORMAT;
+    }
 
-      if ( visited_items.find(AssetID) == visited_items.end() )
-	{
-	  TimedTextResourceDescriptor TmpResource;
-	  memcpy(TmpResource.ResourceID, AssetID.Value(), UUIDlen);
-	  TmpResource.Type = MT_PNG;
-	  m_TDesc.ResourceList.push_back(TmpResource);
-	  m_ResourceTypes.insert(ResourceTypeMap_t::value_type(UUID(TmpResource.ResourceID), MT_PNG));
-	  visited_items.insert(AssetID);
-	}
+  for ( i = Doc.ImageList.begin(); i != Doc.ImageList.end(); i++ )
+    {
+      TimedTextResourceDescriptor TmpResource;
+      memcpy(TmpResource.ResourceID, i->Value(), UUIDlen);
+      TmpResource.Type = MT_PNG;
+      m_TDesc.ResourceList.push_back(TmpResource);
+      m_ResourceTypes.insert(ResourceTypeMap_t::value_type(UUID(TmpResource.ResourceID), MT_PNG));
     }
 
-  // Calculate the timeline duration.
-  // This is a little ugly because the last element in the file is not necessarily
-  // the last instance to be displayed, e.g., element n and element n-1 may have the
-  // same start time but n-1 may have a greater duration making it the last to be seen.
-  // We must scan the list to accumulate the latest TimeOut value.
-  ElementList InstanceList;
-  ElementList::const_iterator ei;
-  ui32_t end_count = 0;
-  
-  m_Root.GetChildrenWithName("Subtitle", InstanceList);
-
-  if ( InstanceList.empty() )
+  // The timeline duration is the latest TimeOut value in the document, which
+  // is not necessarily that of the last Subtitle element; the stream handler
+  // accumulates it while parsing.
+  if ( Doc.SubtitleCount == 0 )
     {
       DefaultLogSink(). Error("XML document contains no Subtitle elements.\n");
       return RESULT_FORMAT;
@@ -350,25 +530,17 @@ ASDCP::TimedText::DCSubtitleParser::h__SubtitleParser::OpenRead()
 
   S12MTimecode beginTC;
   beginTC.SetFPS(TCFrameRate);
-  XMLElement* StartTime = m_Root.GetChildWithName("StartTime");
-
-  if ( StartTime != 0 )
-    beginTC.DecodeString(StartTime->GetBody());
 
-  for ( ei = InstanceList.begin(); ei != InstanceList.end(); ei++ )
-    {
-      S12MTimecode tmpTC((*ei)->GetAttrWithName("TimeOut"), TCFrameRate);
-      if ( end_count < tmpTC.GetFrames() )
-	end_count = tmpTC.GetFrames();
-    }
+  if ( Doc.HasStartTime )
+    beginTC.DecodeString(Doc.StartTime);
 
-  if ( end_count <= beginTC.GetFrames() )
+  if ( Doc.EndCount <= beginTC.GetFrames() )
     {
       DefaultLogSink(). Error("Timed Text file has zero-length timeline.\n");
       return RESULT_FORMAT;
     }
 
-  m_TDesc.ContainerDuration = end_count - beginTC.GetFrames();
+  m_TDesc.ContainerDuration = Doc.EndCount - beginTC.GetFrames();
 
   return RESULT_OK;
 }
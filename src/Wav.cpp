@@ -33,11 +33,33 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assert.h>
 #include <KM_log.h>
 #include <KM_platform.h>
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+# define ASDCP_WAV_SSSE3_DISPATCH
+# include <tmmintrin.h>
+#endif
+
 using Kumu::DefaultLogSink;
 
 
 const ui32_t SimpleWavHeaderLength = 46;
 
+//
+ui16_t
+ASDCP::Wav::ReadFormatTag(const byte_t* fmt_chunk, ui32_t chunk_size)
+{
+  assert(fmt_chunk);
+  ui16_t format = KM_i16_LE(Kumu::cp2i<ui16_t>(fmt_chunk));
+
+  // WAVEFORMATEXTENSIBLE: 16 bytes of WAVEFORMAT, cbSize, wValidBitsPerSample,
+  // dwChannelMask, then the SubFormat GUID which begins with the format code.
+  // A chunk too short to hold the GUID is taken to be integer PCM.
+  if ( format == ASDCP_WAVE_FORMAT_EXTENSIBLE )
+    format = ( chunk_size >= 40 ) ? KM_i16_LE(Kumu::cp2i<ui16_t>(fmt_chunk + 24)) : ASDCP_WAVE_FORMAT_PCM;
+
+  return format;
+}
+
 //
 ASDCP::Wav::SimpleWaveHeader::SimpleWaveHeader(ASDCP::PCM::AudioDescriptor& ADesc)
 {
@@ -174,9 +196,9 @@ ASDCP::Wav::SimpleWaveHeader::ReadFromBuffer(const byte_t* buf, ui32_t buf_len,
 
       if ( test_fcc == FCC_fmt_ )
 	{
-	  ui16_t format = KM_i16_LE(*(ui16_t*)p); p += 2;
+	  format = ReadFormatTag(p, chunk_size); p += 2;
 
-	  if ( format != ASDCP_WAVE_FORMAT_PCM && format != ASDCP_WAVE_FORMAT_EXTENSIBLE )
+	  if ( format != ASDCP_WAVE_FORMAT_PCM && format != ASDCP_WAVE_FORMAT_IEEE_FLOAT )
 	    {
 	      DefaultLogSink().Error("Expecting uncompressed PCM data, got format type %hd\n", format);
 	      return RESULT_RAW_FORMAT;
@@ -571,9 +593,9 @@ ASDCP::RF64::SimpleRF64Header::ReadFromBuffer(const byte_t* buf, ui32_t buf_len,
 
         if ( test_fcc == Wav::FCC_fmt_ )
         {
-            ui16_t format = KM_i16_LE(Kumu::cp2i<ui16_t>(p)); p += sizeof(ui16_t);
+            format = Wav::ReadFormatTag(p, chunk_size); p += sizeof(ui16_t);
 
-            if ( format != Wav::ASDCP_WAVE_FORMAT_PCM && format != Wav::ASDCP_WAVE_FORMAT_EXTENSIBLE )
+            if ( format != Wav::ASDCP_WAVE_FORMAT_PCM && format != Wav::ASDCP_WAVE_FORMAT_IEEE_FLOAT )
             {
                 DefaultLogSink().Error("Expecting uncompressed PCM data, got format type %hd\n", format);
                 return RESULT_RAW_FORMAT;
@@ -601,6 +623,159 @@ ASDCP::RF64::SimpleRF64Header::ReadFromBuffer(const byte_t* buf, ui32_t buf_len,
   return RESULT_OK;
 }
 
+//------------------------------------------------------------------------------------------
+// channel de-interleave
+
+// Copies one channel of 24-bit samples out of an interleaved buffer using unaligned
+// 32-bit loads and stores. Each store writes one byte past the sample, which the
+// next store overwrites, so the main loop stops early enough that neither the
+// source nor the destination is overrun. The remainder is copied bytewise.
+static void
+deinterleave_24_mono_swar(const byte_t* src, ui32_t frame_count, ui32_t stride, byte_t* dst)
+{
+  ui32_t i = 0;
+  ui32_t word = 0;
+
+  for ( ; i + 2 <= frame_count; i++ )
+    {
+      memcpy(&word, src, 4);
+      memcpy(dst, &word, 4);
+      src += stride;
+      dst += 3;
+    }
+
+  for ( ; i < frame_count; i++ )
+    {
+      dst[0] = src[0]; dst[1] = src[1]; dst[2] = src[2];
+      src += stride;
+      dst += 3;
+    }
+}
+
+#ifdef ASDCP_WAV_SSSE3_DISPATCH
+
+// Gathers four 24-bit samples into one vector and packs them into 12 contiguous bytes
+// with a single byte shuffle. Each store writes 16 bytes; the trailing 4 bytes are
+// overwritten by the next iteration, and the last six frames are left to the scalar
+// kernel so that neither buffer is overrun.
+__attribute__((target("ssse3")))
+static void
+deinterleave_24_mono_ssse3(const byte_t* src, ui32_t frame_count, ui32_t stride, byte_t* dst)
+{
+  const __m128i pack_mask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+  ui32_t i = 0;
+  i32_t w0, w1, w2, w3;
+
+  for ( ; i + 6 <= frame_count; i += 4 )
+    {
+      memcpy(&w0, src, 4);
+      memcpy(&w1, src + stride, 4);
+      memcpy(&w2, src + stride * 2, 4);
+      memcpy(&w3, src + stride * 3, 4);
+      __m128i v = _mm_shuffle_epi8(_mm_setr_epi32(w0, w1, w2, w3), pack_mask);
+      _mm_storeu_si128((__m128i*)dst, v);
+      src += stride * 4;
+      dst += 12;
+    }
+
+  deinterleave_24_mono_swar(src, frame_count - i, stride, dst);
+}
+
+//
+static bool
+host_has_ssse3()
+{
+  static int s_has_ssse3 = -1;
+
+  if ( s_has_ssse3 < 0 )
+    {
+      __builtin_cpu_init();
+      s_has_ssse3 = __builtin_cpu_supports("ssse3") ? 1 : 0;
+    }
+
+  return s_has_ssse3 == 1;
+}
+
+#endif // ASDCP_WAV_SSSE3_DISPATCH
+
+//
+template <ui32_t SampleSize>
+static void
+deinterleave_mono_fixed(const byte_t* src, ui32_t frame_count, ui32_t stride, byte_t* dst)
+{
+  for ( ui32_t i = 0; i < frame_count; i++ )
+    {
+      memcpy(dst, src, SampleSize);
+      src += stride;
+      dst += SampleSize;
+    }
+}
+
+//
+void
+ASDCP::Wav::DeinterleaveSamples(const byte_t* src, ui32_t frame_count, ui32_t channel_count,
+				ui32_t sample_size, ui32_t channels_per_dst, byte_t* const* dst_list)
+{
+  assert(src && dst_list);
+  assert(channels_per_dst > 0 && ( channel_count % channels_per_dst ) == 0);
+  const ui32_t stride = channel_count * sample_size;
+  const ui32_t dst_count = channel_count / channels_per_dst;
+
+  if ( channels_per_dst == 1 )
+    {
+      for ( ui32_t c = 0; c < dst_count; c++ )
+	{
+	  const byte_t* sp = src + ( c * sample_size );
+
+	  switch ( sample_size )
+	    {
+	    case 2: deinterleave_mono_fixed<2>(sp, frame_count, stride, dst_list[c]); break;
+	    case 4: deinterleave_mono_fixed<4>(sp, frame_count, stride, dst_list[c]); break;
+
+	    case 3:
+#ifdef ASDCP_WAV_SSSE3_DISPATCH
+	      if ( host_has_ssse3() )
+		{
+		  deinterleave_24_mono_ssse3(sp, frame_count, stride, dst_list[c]);
+		  break;
+		}
+#endif
+	      deinterleave_24_mono_swar(sp, frame_count, stride, dst_list[c]);
+	      break;
+
+	    default:
+	      {
+		byte_t* dp = dst_list[c];
+
+		for ( ui32_t i = 0; i < frame_count; i++ )
+		  {
+		    memcpy(dp, sp, sample_size);
+		    sp += stride;
+		    dp += sample_size;
+		  }
+	      }
+	    }
+	}
+
+      return;
+    }
+
+  const ui32_t group_size = channels_per_dst * sample_size;
+
+  for ( ui32_t c = 0; c < dst_count; c++ )
+    {
+      const byte_t* sp = src + ( c * group_size );
+      byte_t* dp = dst_list[c];
+
+      for ( ui32_t i = 0; i < frame_count; i++ )
+	{
+	  memcpy(dp, sp, group_size);
+	  sp += stride;
+	  dp += group_size;
+	}
+    }
+}
+
 //
 // end Wav.cpp
 //
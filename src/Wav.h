@@ -90,8 +90,13 @@ namespace ASDCP
       const fourcc FCC_data("data");
 
       const ui16_t ASDCP_WAVE_FORMAT_PCM = 1;
+      const ui16_t ASDCP_WAVE_FORMAT_IEEE_FLOAT = 3;
       const ui16_t ASDCP_WAVE_FORMAT_EXTENSIBLE = 65534;
 
+      // Returns the sample format code for a "fmt " chunk. For WAVE_FORMAT_EXTENSIBLE
+      // this is the format code carried in the SubFormat GUID.
+      ui16_t ReadFormatTag(const byte_t* fmt_chunk, ui32_t chunk_size);
+
       //
       class SimpleWaveHeader
 	{
@@ -158,6 +163,18 @@ namespace ASDCP
 	};
 
     } // namespace RF64
+
+  namespace Wav
+    {
+      // De-interleaves frame_count sample frames of channel_count channels from src into
+      // channel_count / channels_per_dst output buffers. Each output buffer receives
+      // channels_per_dst adjacent channels per sample frame, in source channel order.
+      // The output buffers must not overlap src or each other. 24-bit mono output
+      // uses a vectorized kernel when the host CPU supports it.
+      void DeinterleaveSamples(const byte_t* src, ui32_t frame_count, ui32_t channel_count,
+			       ui32_t sample_size, ui32_t channels_per_dst, byte_t* const* dst_list);
+
+    } // namespace Wav
 } // namespace ASDCP
 
 #endif // _WAV_H_
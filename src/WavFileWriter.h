@@ -32,13 +32,14 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <KM_fileio.h>
 #include <KM_log.h>
 #include <Wav.h>
-#include <list>
+#include <vector>
 
 #ifndef _WAVFILEWRITER_H_
 #define _WAVFILEWRITER_H_
 
 
-//
+// An output file with a staging buffer. Sample data is accumulated in the
+// buffer and written out in large blocks to keep the write count low.
 class WavFileElement : public Kumu::FileWriter
 {
   ASDCP::PCM::FrameBuffer m_Buf;
@@ -61,6 +62,36 @@ public:
     m_p += sample_size;
   }
 
+  // Returns (via buf) a pointer to at least len bytes of free buffer space, first
+  // writing out buffered data if there is not enough room. Call Commit() with the
+  // number of bytes actually placed in the buffer.
+  ASDCP::Result_t Reserve(ui32_t len, byte_t** buf)
+  {
+    assert(buf);
+    ASDCP::Result_t result = ASDCP::RESULT_OK;
+
+    if ( len > m_Buf.Capacity() - ( m_p - m_Buf.Data() ) )
+      {
+	if ( m_p != m_Buf.Data() )
+	  result = Flush();
+
+	if ( ASDCP_SUCCESS(result) && len > m_Buf.Capacity() )
+	  {
+	    result = m_Buf.Capacity(len);
+	    m_p = m_Buf.Data();
+	  }
+      }
+
+    *buf = m_p;
+    return result;
+  }
+
+  void Commit(ui32_t len)
+  {
+    assert(m_p + len <= m_Buf.Data() + m_Buf.Capacity());
+    m_p += len;
+  }
+
   ASDCP::Result_t Flush()
   {
     ui32_t write_count = 0;
@@ -79,14 +110,20 @@ public:
 class WavFileWriter
 {
   ASDCP::PCM::AudioDescriptor m_ADesc;
-  std::list<WavFileElement*>  m_OutFile;
+  std::vector<WavFileElement*> m_OutFile;
+  std::vector<byte_t*>        m_DstList;
   ui32_t                      m_ChannelCount;
   ASDCP_NO_COPY_CONSTRUCT(WavFileWriter);
 
  public:
+  // number of frames buffered per output file between writes when splitting
+  static const ui32_t DefaultWriteBatchFrames = 32;
+
   WavFileWriter() : m_ChannelCount(0) {}
   ~WavFileWriter()
     {
+      Close();
+
       while ( ! m_OutFile.empty() )
 	{
 	  delete m_OutFile.back();
@@ -102,8 +139,11 @@ class WavFileWriter
     ST_MAX
   };
 
+  // When split is other than ST_NONE, each output file buffers up to batch_frames
+  // frames of de-interleaved audio before writing.
   ASDCP::Result_t
-    OpenWrite(ASDCP::PCM::AudioDescriptor &ADesc, const char* file_root, SplitType_t split = ST_NONE)
+    OpenWrite(ASDCP::PCM::AudioDescriptor &ADesc, const char* file_root, SplitType_t split = ST_NONE,
+	      ui32_t batch_frames = DefaultWriteBatchFrames)
     {
       ASDCP_TEST_NULL_STR(file_root);
       char filename[Kumu::MaxFilePath];
@@ -152,6 +192,8 @@ class WavFileWriter
       }
       else
       {
+          element_size *= Kumu::xmax(batch_frames, (ui32_t)1);
+
           for ( ui32_t i = 0; i < file_count && ASDCP_SUCCESS(result); i++ )
           {
               snprintf(filename, Kumu::MaxFilePath, "%s_%02u.wav", file_root, (i + 1));
@@ -166,6 +208,8 @@ class WavFileWriter
                   result = Wav.WriteToFile(*(m_OutFile.back()));
               }
           }
+
+          m_DstList.resize(file_count);
       }
       return result;
     }
@@ -179,27 +223,41 @@ class WavFileWriter
       if ( m_OutFile.size() == 1 ) // no de-interleave needed, just write out the frame
 	return m_OutFile.back()->Write(FB.RoData(), FB.Size(), 0);
  
-      std::list<WavFileElement*>::iterator fi;
       ui32_t sample_size = m_ADesc.QuantizationBits / 8;
-      const byte_t* p = FB.RoData();
-      const byte_t* end_p = p + FB.Size();
+      ui32_t frame_count = FB.Size() / ( sample_size * m_ADesc.ChannelCount );
+      ui32_t element_len = frame_count * sample_size * m_ChannelCount;
+      ASDCP::Result_t result = ASDCP::RESULT_OK;
+
+      for ( ui32_t i = 0; i < m_OutFile.size() && ASDCP_SUCCESS(result); i++ )
+	result = m_OutFile[i]->Reserve(element_len, &m_DstList[i]);
 
-      while ( p < end_p )
+      if ( ASDCP_SUCCESS(result) )
 	{
-	  for ( fi = m_OutFile.begin(); fi != m_OutFile.end(); fi++ )
-	    {
-	      for ( ui32_t c = 0; c < m_ChannelCount; c++ )
-		{
-		  (*fi)->WriteSample(p, sample_size);
-		  p += sample_size;
-		}
-	    }
+	  ASDCP::Wav::DeinterleaveSamples(FB.RoData(), frame_count, m_ADesc.ChannelCount,
+					  sample_size, m_ChannelCount, &m_DstList[0]);
+
+	  for ( ui32_t i = 0; i < m_OutFile.size(); i++ )
+	    m_OutFile[i]->Commit(element_len);
 	}
 
+      return result;
+    }
+
+  // Writes out any buffered sample data and closes the output files.
+  ASDCP::Result_t
+    Close()
+    {
       ASDCP::Result_t result = ASDCP::RESULT_OK;
 
-      for ( fi = m_OutFile.begin(); fi != m_OutFile.end() && ASDCP_SUCCESS(result); fi++ )
-	result = (*fi)->Flush();
+      for ( ui32_t i = 0; i < m_OutFile.size(); i++ )
+	{
+	  ASDCP::Result_t flush_result = m_OutFile[i]->Flush();
+
+	  if ( ASDCP_FAILURE(flush_result) && flush_result != ASDCP::RESULT_EMPTY_FB && ASDCP_SUCCESS(result) )
+	    result = flush_result;
+
+	  m_OutFile[i]->Close();
+	}
 
       return result;
     }
@@ -46,6 +46,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <ACES.h>
 #include <MXF.h>
 #include <Metadata.h>
+#include <InfoJSON.h>
 #include <cfloat>
 
 using namespace Kumu;
@@ -97,10 +98,15 @@ Options:\n\
   -h | -help  - Show help\n\
   -H          - Show MXF header metadata\n\
   -i          - Show identity info\n\
+  -j          - Write one JSON record per file (descriptor, identity,\n\
+                index summary and bit-rate) instead of text\n\
+  -l <file>   - Read input filenames from <file>, one per line (- for stdin)\n\
   -n          - Show index\n\
   -r          - Show bit-rate (Mb/s)\n\
   -t <int>    - Set high-bitrate threshold (Mb/s)\n\
   -V          - Show version information\n\
+  -w <int>    - Number of files to examine concurrently when writing JSON\n\
+                (default: number of CPUs)\n\
 \n\
   NOTES: o There is no option grouping, all options must be distinct arguments.\n\
          o All option arguments must be separated from the option by whitespace.\n\n",
@@ -127,13 +133,16 @@ public:
   bool   showrate_flag;        // if true and is image file, show bit rate
   bool   max_bitrate_flag;     // true if -t option given
   double max_bitrate;          // if true and is image file, max bit rate for rate test
+  bool   json_flag;            // if true, write one JSON record per file
+  ui32_t worker_count;         // number of files examined concurrently in JSON mode
 
   //
   CommandOptions(int argc, const char** argv) :
     error_flag(true), version_flag(false), help_flag(false), verbose_flag(false),
     showindex_flag(false), showheader_flag(false),
     showid_flag(false), showdescriptor_flag(false), showcoding_flag(false),
-    showrate_flag(false), max_bitrate_flag(false), max_bitrate(0.0)
+    showrate_flag(false), max_bitrate_flag(false), max_bitrate(0.0),
+    json_flag(false), worker_count(0)
   {
     for ( int i = 1; i < argc; ++i )
       {
@@ -155,6 +164,14 @@ public:
 	      case 'H': showheader_flag = true; break;
 	      case 'h': help_flag = true; break;
 	      case 'i': showid_flag = true; break;
+	      case 'j': json_flag = true; break;
+
+	      case 'l':
+		TEST_EXTRA_ARG_STDIN(i, 'l');
+		if ( ! ReadFilenameList(argv[i], filenames) )
+		  return;
+		break;
+
 	      case 'n': showindex_flag = true; break;
 	      case 'r': showrate_flag = true; break;
 
@@ -167,6 +184,11 @@ public:
 	      case 'V': version_flag = true; break;
 	      case 'v': verbose_flag = true; break;
 
+	      case 'w':
+		TEST_EXTRA_ARG(i, 'w');
+		worker_count = Kumu::xabs(strtol(argv[i], 0, 10));
+		break;
+
 	      default:
 		fprintf(stderr, "Unrecognized option: %s\n", argv[i]);
 		return;
@@ -744,34 +766,36 @@ class FileInfoWrapper
   DescriptorT m_Desc;
   WriterInfo m_WriterInfo;
   double m_MaxBitrate, m_AvgBitrate;
+  ui32_t m_IndexEntries, m_LargestFrame;
   UL m_PictureEssenceCoding;
 
   KM_NO_COPY_CONSTRUCT(FileInfoWrapper);
 
   template <class T>
-  Result_t OpenRead(const T& m, const CommandOptions& Options)
+  Result_t OpenRead(const T& m, EssenceProbe& Probe)
   {
-  	return m.OpenRead(Options.filenames.front().c_str());
+  	return m.OpenRead(Probe);
   }
 
-  Result_t OpenRead(AS_02::IAB::MXFReader& m, const CommandOptions& Options)
+  Result_t OpenRead(AS_02::IAB::MXFReader& m, EssenceProbe& Probe)
   {
     // OpenRead method is not const
-    return m.OpenRead(Options.filenames.front().c_str());
+    return m.OpenRead(Probe);
   }
 
-  Result_t OpenRead(const AS_02::PCM::MXFReader& m, const CommandOptions& Options)
+  Result_t OpenRead(const AS_02::PCM::MXFReader& m, EssenceProbe& Probe)
   {
-  	return m.OpenRead(Options.filenames.front().c_str(), EditRate_24);
+  	return m.OpenRead(Probe, EditRate_24);
   	//Result_t OpenRead(const std::string& filename, const ASDCP::Rational& EditRate);
   }
 
 public:
-  FileInfoWrapper(const IFileReaderFactory& fileReaderFactory) : m_MaxBitrate(0.0), m_AvgBitrate(0.0), m_Reader(fileReaderFactory) {}
+  FileInfoWrapper(const IFileReaderFactory& fileReaderFactory) :
+    m_Reader(fileReaderFactory), m_MaxBitrate(0.0), m_AvgBitrate(0.0), m_IndexEntries(0), m_LargestFrame(0) {}
   virtual ~FileInfoWrapper() {}
 
   Result_t
-  file_info(CommandOptions& Options, const char* type_string, FILE* stream = 0)
+  file_info(CommandOptions& Options, EssenceProbe& Probe, const char* type_string, FILE* stream = 0)
   {
     assert(type_string);
     if ( stream == 0 )
@@ -780,7 +804,7 @@ public:
       }
 
     Result_t result = RESULT_OK;
-    result = OpenRead(m_Reader, Options);
+    result = OpenRead(m_Reader, Probe);
 
     if ( ASDCP_SUCCESS(result) )
       {
@@ -821,6 +845,54 @@ public:
     return result;
   }
 
+  // Fills record with the file's identity and essence descriptor. The index
+  // summary is added separately by index_json() or rate_json().
+  Result_t
+  json_info(EssenceProbe& Probe, const char* type_string, JSONObject& record)
+  {
+    assert(type_string);
+    Result_t result = OpenRead(m_Reader, Probe);
+
+    if ( ASDCP_SUCCESS(result) )
+      {
+	m_Desc.FillDescriptor(m_Reader);
+	m_Reader.FillWriterInfo(m_WriterInfo);
+
+	record.add_string("essence_type", type_string);
+	record.add_number("duration", m_Desc.ContainerDuration);
+	record.add_object("writer_info", WriterInfoJSON(m_WriterInfo, ( m_WriterInfo.LabelSetType == LS_MXF_SMPTE ? "SMPTE 2067-5" : "Unknown" )));
+	record.add_object("descriptor", DescriptorJSON(m_Reader.OP1aHeader()));
+      }
+
+    return result;
+  }
+
+  // Adds the number of index entries to record.
+  void
+  index_json(JSONObject& record)
+  {
+    JSONObject index;
+    index.add_number("entries", m_Reader.AS02IndexReader().GetDuration());
+    record.add_object("index", index);
+  }
+
+  // Adds the edit rate and an index summary, including the bit-rate
+  // statistics computed from the index, to record.
+  void
+  rate_json(JSONObject& record)
+  {
+    calc_Bitrate();
+
+    JSONObject index;
+    index.add_number("entries", m_IndexEntries);
+    index.add_number("largest_frame_bytes", m_LargestFrame);
+    index.add_real("max_bitrate_mbps", m_MaxBitrate);
+    index.add_real("avg_bitrate_mbps", m_AvgBitrate);
+
+    record.add_rational("edit_rate", m_Desc.EditRate);
+    record.add_object("index", index);
+  }
+
   //
   void get_PictureEssenceCoding(FILE* stream = 0)
   {
@@ -906,6 +978,7 @@ public:
     ui32_t largest_frame = 0;
     Result_t result = RESULT_OK;
     ui64_t duration = 0;
+    m_IndexEntries = 0;
 
     if ( m_Desc.EditRate.Numerator == 0 || m_Desc.EditRate.Denominator == 0 )
       {
@@ -927,6 +1000,8 @@ public:
 
 	if ( KM_SUCCESS(result) )
 	  {
+	    ++m_IndexEntries;
+
 	    if ( last_stream_offset != 0 )
 	      {
 		ui64_t this_frame_size = entry.StreamOffset - last_stream_offset - 20; // do not count the bytes that represent the KLV wrapping
@@ -940,7 +1015,9 @@ public:
 	  }
       }
 
-    if ( KM_SUCCESS(result) )
+    m_LargestFrame = largest_frame;
+
+    if ( KM_SUCCESS(result) && duration > 1 )
       {
 	// scale bytes to megabits
 	static const double mega_const = 1.0 / ( 1000000 / 8.0 );
@@ -986,7 +1063,8 @@ Result_t
 show_file_info(CommandOptions& Options, const Kumu::IFileReaderFactory& fileReaderFactory)
 {
   EssenceType_t EssenceType;
-  Result_t result = ASDCP::EssenceType(Options.filenames.front().c_str(), EssenceType, fileReaderFactory);
+  EssenceProbe Probe; // keeps the file open for the reader selected below
+  Result_t result = ASDCP::EssenceType(Options.filenames.front().c_str(), EssenceType, fileReaderFactory, Probe);
 
   if ( ASDCP_FAILURE(result) )
     return result;
@@ -994,7 +1072,7 @@ show_file_info(CommandOptions& Options, const Kumu::IFileReaderFactory& fileRead
   if ( EssenceType == ESS_AS02_JPEG_2000 )
     {
 	  FileInfoWrapper<AS_02::JP2K::MXFReader, MyPictureDescriptor> wrapper(fileReaderFactory);
-	  result = wrapper.file_info(Options, "JPEG 2000 pictures");
+	  result = wrapper.file_info(Options, Probe, "JPEG 2000 pictures");
 
 	  if ( KM_SUCCESS(result) )
 	    {
@@ -1018,7 +1096,7 @@ show_file_info(CommandOptions& Options, const Kumu::IFileReaderFactory& fileRead
   else if ( EssenceType == ESS_AS02_ACES )
     {
 	  FileInfoWrapper<AS_02::ACES::MXFReader, MyACESPictureDescriptor> wrapper(fileReaderFactory);
-	  result = wrapper.file_info(Options, "ACES pictures");
+	  result = wrapper.file_info(Options, Probe, "ACES pictures");
 
 	  if ( KM_SUCCESS(result) )
 	    {
@@ -1042,7 +1120,7 @@ show_file_info(CommandOptions& Options, const Kumu::IFileReaderFactory& fileRead
   else if ( EssenceType == ESS_AS02_PCM_24b_48k || EssenceType == ESS_AS02_PCM_24b_96k )
     {
       FileInfoWrapper<AS_02::PCM::MXFReader, MyAudioDescriptor> wrapper(fileReaderFactory);
-      result = wrapper.file_info(Options, "PCM audio");
+      result = wrapper.file_info(Options, Probe, "PCM audio");
 
       if ( ASDCP_SUCCESS(result) && Options.showcoding_flag )
 	wrapper.dump_WaveAudioDescriptor(stdout);
@@ -1050,12 +1128,12 @@ show_file_info(CommandOptions& Options, const Kumu::IFileReaderFactory& fileRead
   else if ( EssenceType == ESS_AS02_JPEG_XS )
     {
       FileInfoWrapper<AS_02::JXS::MXFReader, MyJXSDescriptor> wrapper(fileReaderFactory);
-      result = wrapper.file_info(Options, "JPEG XS");
+      result = wrapper.file_info(Options, Probe, "JPEG XS");
     }
   else if ( EssenceType == ESS_AS02_IAB )
     {
       FileInfoWrapper<AS_02::IAB::MXFReader, MyIabDescriptor> wrapper(fileReaderFactory);
-      result = wrapper.file_info(Options, "IAB audio");
+      result = wrapper.file_info(Options, Probe, "IAB audio");
     }
   else
     {
@@ -1091,6 +1169,80 @@ show_file_info(CommandOptions& Options, const Kumu::IFileReaderFactory& fileRead
   return result;
 }
 
+// Fill a JSON record describing one AS-02 file
+//
+Result_t
+json_file_info(const std::string& filename, const Kumu::IFileReaderFactory& fileReaderFactory, JSONObject& record)
+{
+  EssenceType_t EssenceType;
+  EssenceProbe Probe;
+  record.add_string("file", filename);
+  Result_t result = ASDCP::EssenceType(filename, EssenceType, fileReaderFactory, Probe);
+
+  if ( ASDCP_FAILURE(result) )
+    return result;
+
+  if ( EssenceType == ESS_AS02_JPEG_2000 )
+    {
+      FileInfoWrapper<AS_02::JP2K::MXFReader, MyPictureDescriptor> wrapper(fileReaderFactory);
+      result = wrapper.json_info(Probe, "JPEG 2000 pictures", record);
+
+      if ( KM_SUCCESS(result) )
+	wrapper.rate_json(record);
+    }
+  else if ( EssenceType == ESS_AS02_ACES )
+    {
+      FileInfoWrapper<AS_02::ACES::MXFReader, MyACESPictureDescriptor> wrapper(fileReaderFactory);
+      result = wrapper.json_info(Probe, "ACES pictures", record);
+
+      if ( KM_SUCCESS(result) )
+	wrapper.rate_json(record);
+    }
+  else if ( EssenceType == ESS_AS02_PCM_24b_48k || EssenceType == ESS_AS02_PCM_24b_96k )
+    {
+      FileInfoWrapper<AS_02::PCM::MXFReader, MyAudioDescriptor> wrapper(fileReaderFactory);
+      result = wrapper.json_info(Probe, "PCM audio", record);
+
+      if ( KM_SUCCESS(result) )
+	wrapper.index_json(record);
+    }
+  else if ( EssenceType == ESS_AS02_JPEG_XS )
+    {
+      FileInfoWrapper<AS_02::JXS::MXFReader, MyJXSDescriptor> wrapper(fileReaderFactory);
+      result = wrapper.json_info(Probe, "JPEG XS", record);
+
+      if ( KM_SUCCESS(result) )
+	wrapper.index_json(record);
+    }
+  else if ( EssenceType == ESS_AS02_IAB )
+    {
+      FileInfoWrapper<AS_02::IAB::MXFReader, MyIabDescriptor> wrapper(fileReaderFactory);
+      result = wrapper.json_info(Probe, "IAB audio", record);
+    }
+  else
+    {
+      result = RESULT_FORMAT; // not AS-02; AS-DCP files are described by asdcp-info
+    }
+
+  return result;
+}
+
+// Describes one file for WriteJSONRecords()
+class JSONFileInfo : public IJSONRecordSource
+{
+  const Kumu::IFileReaderFactory& m_FileReaderFactory;
+
+  KM_NO_COPY_CONSTRUCT(JSONFileInfo);
+
+public:
+  JSONFileInfo(const Kumu::IFileReaderFactory& fileReaderFactory) : m_FileReaderFactory(fileReaderFactory) {}
+
+  Result_t FillRecord(const std::string& filename, JSONObject& record) const
+  {
+    return json_file_info(filename, m_FileReaderFactory, record);
+  }
+};
+
 //
 int
 main(int argc, const char** argv)
@@ -1115,6 +1267,14 @@ main(int argc, const char** argv)
 
   init_rate_info();
   Kumu::FileReaderFactory defaultFactory;
+
+  if ( Options.json_flag )
+    {
+      JSONFileInfo json_info(defaultFactory);
+      result = WriteJSONRecords(Options.filenames, Options.worker_count, json_info);
+      Options.filenames.clear();
+    }
+
   while ( ! Options.filenames.empty() && ASDCP_SUCCESS(result) )
     {
       result = show_file_info(Options, defaultFactory);
@@ -788,6 +788,9 @@ read_PCM_file(CommandOptions& Options, const Kumu::IFileReaderFactory& fileReade
 	}
     }
 
+  if ( ASDCP_SUCCESS(result) )
+    result = OutWave.Close();
+
   return result;
 }
 
@@ -46,6 +46,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 using namespace ASDCP;
 
 const ui32_t FRAME_BUFFER_SIZE = 4 * Kumu::Megabyte;
+const ui32_t ACES_READ_AHEAD_FRAMES = 4; // ACES frames read ahead of the writer
 const ASDCP::Dictionary *g_dict = 0;
  
 const char*
@@ -154,6 +155,7 @@ Options:\n\
   -G <filename>     - Filename of XML resource to be carried per RP 2057 Generic\n\
                       Stream. May be issued multiple times.\n\
   -i                - Indicates input essence is interlaced fields (forces -Y)\n\
+  -I                - Map PCM input files into memory instead of reading them\n\
   -j <key-id-str>   - Write key ID instead of creating a random value\n\
   -J                - Write J2CLayout\n\
   -k <key-string>   - Use key for ciphertext operations\n\
@@ -173,12 +175,16 @@ Options:\n\
   -r <n>/<d>        - Edit Rate of the output file.  24/1 is the default\n\
   -R                - Indicates RGB image essence (default except with -c)\n\
   -s <seconds>      - Duration of a frame-wrapped partition (default 60)\n\
+  -S <conv>         - Convert 16-bit, 32-bit integer and 32-bit float PCM\n\
+                      input to 24-bit. <conv> is 'round' or 'dither' (TPDF)\n\
   -t <min>          - Set RGB component minimum code value (default: 0)\n\
   -T <max>          - Set RGB component maximum code value (default: 1023)\n\
   -u                - Print UL catalog to stdout\n\
   -U <URI>          - ISXD (RDD47) document URI (use 'auto' to read the\n\
                       namespace name from the first edit unit)\n\
   -v                - Verbose, prints informative messages to stderr\n\
+  -w <n>            - Write frame-wrapped body partitions using <n> background\n\
+                      threads (default 0, write inline)\n\
   -W                - Read input file only, do not write source file\n\
   -x <int>          - Horizontal subsampling degree (default: 2)\n\
   -X <int>          - Vertical subsampling degree (default: 2)\n\
@@ -315,6 +321,9 @@ public:
   //new attributes for AS-02 support 
   AS_02::IndexStrategy_t index_strategy; //Shim parameter index_strategy_frame/clip
   ui32_t partition_space; //Shim parameter partition_spacing
+  ui32_t partition_writers; // background threads writing frame-wrapped partitions
+  ASDCP::PCM::SampleConversion_t sample_conversion; // conversion applied to PCM input samples
+  bool map_pcm_flag; // if true, PCM input files are memory-mapped
 
   // ISXD
   std::string isxd_document_namespace;
@@ -520,7 +529,8 @@ public:
     no_write_flag(false), version_flag(false), help_flag(false),
     duration(0xffffffff), j2c_pedantic(true), write_j2clayout(false), use_cdci_descriptor(false),
     edit_rate(24,1), fb_size(FRAME_BUFFER_SIZE),
-    show_ul_values_flag(false), index_strategy(AS_02::IS_FOLLOW), partition_space(60),
+    show_ul_values_flag(false), index_strategy(AS_02::IS_FOLLOW), partition_space(60), partition_writers(0),
+    sample_conversion(ASDCP::PCM::SC_NONE), map_pcm_flag(false),
     mca_config(g_dict), rgba_MaxRef(1023), rgba_MinRef(0),
     horizontal_subsampling(2), vertical_subsampling(2), component_depth(10),
     frame_layout(0), aspect_ratio(ASDCP::Rational(4,3)), aspect_ratio_flag(false), field_dominance(0),
@@ -725,6 +735,8 @@ public:
 		use_cdci_descriptor = true;
 		break;
 
+	      case 'I': map_pcm_flag = true; break;
+
 	      case 'j':
 		key_id_flag = true;
 		TEST_EXTRA_ARG(i, 'j');
@@ -840,6 +852,23 @@ public:
 		partition_space = Kumu::xabs(strtol(argv[i], 0, 10));
 		break;
 
+	      case 'S':
+		TEST_EXTRA_ARG(i, 'S');
+		if ( strcmp(argv[i], "round") == 0 )
+		  {
+		    sample_conversion = ASDCP::PCM::SC_24BIT;
+		  }
+		else if ( strcmp(argv[i], "dither") == 0 )
+		  {
+		    sample_conversion = ASDCP::PCM::SC_24BIT_DITHER;
+		  }
+		else
+		  {
+		    fprintf(stderr, "Unrecognized sample conversion: %s, expecting 'round' or 'dither'\n", argv[i]);
+		    return;
+		  }
+		break;
+
 	      case 't':
 		TEST_EXTRA_ARG(i, 't');
 		rgba_MinRef = Kumu::xabs(strtol(argv[i], 0, 10));
@@ -859,6 +888,11 @@ public:
 
 	      case 'V': version_flag = true; break;
 	      case 'v': verbose_flag = true; break;
+	      case 'w':
+		TEST_EXTRA_ARG(i, 'w');
+		partition_writers = Kumu::xabs(strtol(argv[i], 0, 10));
+		break;
+
 	      case 'W': no_write_flag = true; break;
 
 	      case 'x':
@@ -1239,6 +1273,9 @@ write_JP2K_file(CommandOptions& Options)
 	{
 	  result = Writer.OpenWrite(Options.out_file, Info, essence_descriptor, essence_sub_descriptors,
 				    Options.edit_rate, Options.mxf_header_size, Options.index_strategy, Options.partition_space);
+
+	  if ( ASDCP_SUCCESS(result) && Options.partition_writers > 0 )
+	    result = Writer.SetPartitionWriters(Options.partition_writers);
 	}
     }
 
@@ -1458,16 +1495,37 @@ write_ACES_file(CommandOptions& Options)
     {
       result = Writer.OpenWrite(Options.out_file, Info, essence_descriptor, essence_sub_descriptors,
         Options.edit_rate, AS_02::ACES::ResourceList_t(), Options.mxf_header_size, Options.index_strategy, Options.partition_space);
+
+      if (ASDCP_SUCCESS(result) && Options.partition_writers > 0)
+        result = Writer.SetPartitionWriters(Options.partition_writers);
     }
   }
 
+  // Plaintext frames are copied from their files into the MXF file directly.
+  // Otherwise the frames are read ahead of the writer (where threads exist).
+  bool copy_frames = !Options.key_flag && !Options.verbose_flag;
+
   if (ASDCP_SUCCESS(result))
   {
     ui32_t duration = 0;
     result = Parser.Reset();
 
+    if (ASDCP_SUCCESS(result) && !copy_frames)
+      Parser.SetReadAhead(ACES_READ_AHEAD_FRAMES);
+
     while (ASDCP_SUCCESS(result) && duration++ < Options.duration)
     {
+      if (copy_frames)
+      {
+        std::string frame_filename;
+        result = Parser.ReadFrameFilename(frame_filename);
+
+        if (ASDCP_SUCCESS(result) && !Options.no_write_flag)
+          result = Writer.WriteFrameFromFile(frame_filename, Context, HMAC);
+
+        continue;
+      }
+
       result = Parser.ReadFrame(FrameBuffer);
 
       if (ASDCP_SUCCESS(result))
@@ -1498,6 +1556,14 @@ write_ACES_file(CommandOptions& Options)
     AS_02::ACES::ResourceList_t::const_iterator ri;
     for ( ri = resource_list_t.begin() ; ri != resource_list_t.end() && ASDCP_SUCCESS(result); ri++ )
     {
+      if ( copy_frames )
+      {
+        if ( ! Options.no_write_flag )
+          result = Writer.WriteAncillaryResourceFromFile((*ri).filePath, Context, HMAC);
+
+        continue;
+      }
+
       result = Parser.ReadAncillaryResource((*ri).filePath, FrameBuffer);
 
       if ( ASDCP_SUCCESS(result) )
@@ -1549,7 +1615,8 @@ write_PCM_file(CommandOptions& Options)
   ASDCP::MXF::WaveAudioDescriptor *essence_descriptor = 0;
 
   // set up essence parser
-  Result_t result = Parser.OpenRead(Options.filenames, Options.edit_rate);
+  Result_t result = Parser.OpenRead(Options.filenames, Options.edit_rate, Options.sample_conversion,
+				    Options.map_pcm_flag);
 
   // set up MXF writer
   if ( ASDCP_SUCCESS(result) )
@@ -1675,7 +1742,7 @@ write_PCM_file(CommandOptions& Options)
 
       while ( ASDCP_SUCCESS(result) && duration++ < Options.duration )
 	{
-	  result = Parser.ReadFrame(FrameBuffer);
+	  result = Parser.ReadFrameView(FrameBuffer);
 
 	  if ( ASDCP_SUCCESS(result) )
 	    {
@@ -1951,6 +2018,9 @@ write_isxd_file(CommandOptions& Options)
 	  }
 
 	result = Writer.OpenWrite(Options.out_file, Info, Options.isxd_document_namespace, Options.edit_rate);
+
+	if ( ASDCP_SUCCESS(result) && Options.partition_writers > 0 )
+	  result = Writer.SetPartitionWriters(Options.partition_writers);
       }
   }
 
@@ -38,6 +38,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <AS_02.h>
 #include <MXF.h>
 #include <Metadata.h>
+#include <InfoJSON.h>
 
 using namespace Kumu;
 using namespace ASDCP;
@@ -99,10 +100,15 @@ Options:\n\
   -h | -help  - Show help\n\
   -H          - Show MXF header metadata\n\
   -i          - Show identity info\n\
+  -j          - Write one JSON record per file (descriptor, identity,\n\
+                index summary and bit-rate) instead of text\n\
+  -l <file>   - Read input filenames from <file>, one per line (- for stdin)\n\
   -n          - Show index\n\
   -r          - Show bit-rate (Mb/s)\n\
   -t <int>    - Set high-bitrate threshold (Mb/s)\n\
   -V          - Show version information\n\
+  -w <int>    - Number of files to examine concurrently when writing JSON\n\
+                (default: number of CPUs)\n\
 \n\
   NOTES: o There is no option grouping, all options must be distinct arguments.\n\
          o All option arguments must be separated from the option by whitespace.\n\n",
@@ -130,13 +136,16 @@ public:
   bool   showrate_flag;        // if true and is image file, show bit rate
   bool   max_bitrate_flag;     // true if -t option given
   double max_bitrate;          // if true and is image file, max bit rate for rate test
+  bool   json_flag;            // if true, write one JSON record per file
+  ui32_t worker_count;         // number of files examined concurrently in JSON mode
 
   //
   CommandOptions(int argc, const char** argv) :
     error_flag(true), version_flag(false), help_flag(false), verbose_flag(false),
     showindex_flag(), showheader_flag(), stereo_image_flag(false),
     showid_flag(false), showdescriptor_flag(false), showcoding_flag(false),
-    showrate_flag(false), max_bitrate_flag(false), max_bitrate(0.0)
+    showrate_flag(false), max_bitrate_flag(false), max_bitrate(0.0),
+    json_flag(false), worker_count(0)
   {
     for ( int i = 1; i < argc; ++i )
       {
@@ -159,6 +168,14 @@ public:
 	      case 'H': showheader_flag = true; break;
 	      case 'h': help_flag = true; break;
 	      case 'i': showid_flag = true; break;
+	      case 'j': json_flag = true; break;
+
+	      case 'l':
+		TEST_EXTRA_ARG_STDIN(i, 'l');
+		if ( ! ReadFilenameList(argv[i], filenames) )
+		  return;
+		break;
+
 	      case 'n': showindex_flag = true; break;
 	      case 'r': showrate_flag = true; break;
 
@@ -171,6 +188,11 @@ public:
 	      case 'V': version_flag = true; break;
 	      case 'v': verbose_flag = true; break;
 
+	      case 'w':
+		TEST_EXTRA_ARG(i, 'w');
+		worker_count = Kumu::xabs(strtol(argv[i], 0, 10));
+		break;
+
 	      default:
 		fprintf(stderr, "Unrecognized option: %s\n", argv[i]);
 		return;
@@ -304,23 +326,25 @@ class FileInfoWrapper
   DescriptorT m_Desc;
   WriterInfo m_WriterInfo;
   double m_MaxBitrate, m_AvgBitrate;
+  ui32_t m_IndexEntries, m_LargestFrame;
   UL m_PictureEssenceCoding;
 
   KM_NO_COPY_CONSTRUCT(FileInfoWrapper);
 
 public:
-  FileInfoWrapper(const Kumu::IFileReaderFactory& fileReaderFactory) : m_MaxBitrate(0.0), m_AvgBitrate(0.0), m_Reader(fileReaderFactory) {}
+  FileInfoWrapper(const Kumu::IFileReaderFactory& fileReaderFactory) :
+    m_Reader(fileReaderFactory), m_MaxBitrate(0.0), m_AvgBitrate(0.0), m_IndexEntries(0), m_LargestFrame(0) {}
   virtual ~FileInfoWrapper() {}
 
   Result_t
-  file_info(CommandOptions& Options, const char* type_string, FILE* stream = 0)
+  file_info(CommandOptions& Options, EssenceProbe& Probe, const char* type_string, FILE* stream = 0)
   {
     assert(type_string);
     if ( stream == 0 )
       stream = stdout;
 
     Result_t result = RESULT_OK;
-    result = m_Reader.OpenRead(Options.filenames.front().c_str());
+    result = m_Reader.OpenRead(Probe);
 
     if ( ASDCP_SUCCESS(result) )
       {
@@ -351,6 +375,39 @@ public:
     return result;
   }
 
+  // Fills record with the file's identity, essence descriptor and a summary of
+  // its index, including the bit-rate statistics computed from the index.
+  Result_t
+  json_info(EssenceProbe& Probe, const char* type_string, JSONObject& record)
+  {
+    assert(type_string);
+    Result_t result = m_Reader.OpenRead(Probe);
+
+    if ( ASDCP_SUCCESS(result) )
+      {
+	m_Desc.FillDescriptor(m_Reader);
+	m_Reader.FillWriterInfo(m_WriterInfo);
+	calc_Bitrate();
+
+	JSONObject index;
+	index.add_number("entries", m_IndexEntries);
+	index.add_number("largest_frame_bytes", m_LargestFrame);
+	index.add_real("max_bitrate_mbps", m_MaxBitrate);
+	index.add_real("avg_bitrate_mbps", m_AvgBitrate);
+
+	record.add_string("essence_type", type_string);
+	record.add_rational("edit_rate", m_Desc.EditRate);
+	record.add_number("duration", m_Desc.ContainerDuration);
+	record.add_object("writer_info",
+			  WriterInfoJSON(m_WriterInfo, ( m_WriterInfo.LabelSetType == LS_MXF_SMPTE ? "SMPTE" :
+							 ( m_WriterInfo.LabelSetType == LS_MXF_INTEROP ? "MXF Interop" : "Unknown" ) )));
+	record.add_object("descriptor", DescriptorJSON(m_Reader.OP1aHeader()));
+	record.add_object("index", index);
+      }
+
+    return result;
+  }
+
   //
   void get_PictureEssenceCoding(FILE* stream = 0)
   {
@@ -467,6 +524,7 @@ public:
     ui64_t total_frame_bytes = 0, last_stream_offset = 0;
     ui32_t largest_frame = 0;
     Result_t result = RESULT_OK;
+    m_IndexEntries = 0;
 
     for ( ui32_t i = 0; KM_SUCCESS(result) && i < m_Desc.ContainerDuration; ++i )
       {
@@ -475,6 +533,8 @@ public:
 
 	if ( KM_SUCCESS(result) )
 	  {
+	    ++m_IndexEntries;
+
 	    if ( last_stream_offset != 0 )
 	      {
 		ui64_t this_frame_size = entry.StreamOffset - last_stream_offset - 20; // do not count the bytes that represent the KLV wrapping 
@@ -488,7 +548,9 @@ public:
 	  }
       }
 
-    if ( KM_SUCCESS(result) )
+    m_LargestFrame = largest_frame;
+
+    if ( KM_SUCCESS(result) && m_Desc.ContainerDuration > 2 )
       {
 	// scale bytes to megabits
 	static const double mega_const = 1.0 / ( 1000000 / 8.0 );
@@ -534,7 +596,8 @@ Result_t
 show_file_info(CommandOptions& Options, const Kumu::IFileReaderFactory& fileReaderFactory)
 {
   EssenceType_t EssenceType;
-  Result_t result = ASDCP::EssenceType(Options.filenames.front().c_str(), EssenceType, fileReaderFactory);
+  EssenceProbe Probe; // keeps the file open for the reader selected below
+  Result_t result = ASDCP::EssenceType(Options.filenames.front().c_str(), EssenceType, fileReaderFactory, Probe);
 
   if ( ASDCP_FAILURE(result) )
     return result;
@@ -542,7 +605,7 @@ show_file_info(CommandOptions& Options, const Kumu::IFileReaderFactory& fileRead
   if ( EssenceType == ESS_MPEG2_VES )
     {
       FileInfoWrapper<ASDCP::MPEG2::MXFReader, MyVideoDescriptor> wrapper(fileReaderFactory);
-      result = wrapper.file_info(Options, "MPEG2 video");
+      result = wrapper.file_info(Options, Probe, "MPEG2 video");
 
       if ( ASDCP_SUCCESS(result) && Options.showrate_flag )
 	wrapper.dump_Bitrate(stdout);
@@ -550,7 +613,7 @@ show_file_info(CommandOptions& Options, const Kumu::IFileReaderFactory& fileRead
   else if ( EssenceType == ESS_PCM_24b_48k || EssenceType == ESS_PCM_24b_96k )
     {
       FileInfoWrapper<ASDCP::PCM::MXFReader, MyAudioDescriptor> wrapper(fileReaderFactory);
-      result = wrapper.file_info(Options, "PCM audio");
+      result = wrapper.file_info(Options, Probe, "PCM audio");
 
       if ( ASDCP_SUCCESS(result) && Options.showcoding_flag )
 	wrapper.dump_WaveAudioDescriptor();
@@ -560,7 +623,7 @@ show_file_info(CommandOptions& Options, const Kumu::IFileReaderFactory& fileRead
       if ( Options.stereo_image_flag )
 	{
 	  FileInfoWrapper<ASDCP::JP2K::MXFSReader, MyStereoPictureDescriptor> wrapper(fileReaderFactory);
-	  result = wrapper.file_info(Options, "JPEG 2000 stereoscopic pictures");
+	  result = wrapper.file_info(Options, Probe, "JPEG 2000 stereoscopic pictures");
 
 	  if ( KM_SUCCESS(result) )
 	    {
@@ -579,7 +642,7 @@ show_file_info(CommandOptions& Options, const Kumu::IFileReaderFactory& fileRead
       else
 	{
 	  FileInfoWrapper<ASDCP::JP2K::MXFReader, MyPictureDescriptor>wrapper(fileReaderFactory);
-	  result = wrapper.file_info(Options, "JPEG 2000 pictures");
+	  result = wrapper.file_info(Options, Probe, "JPEG 2000 pictures");
 
 	  if ( KM_SUCCESS(result) )
 	    {
@@ -599,7 +662,7 @@ show_file_info(CommandOptions& Options, const Kumu::IFileReaderFactory& fileRead
   else if ( EssenceType == ESS_JPEG_2000_S )
     {
       FileInfoWrapper<ASDCP::JP2K::MXFSReader, MyStereoPictureDescriptor>wrapper(fileReaderFactory);
-      result = wrapper.file_info(Options, "JPEG 2000 stereoscopic pictures");
+      result = wrapper.file_info(Options, Probe, "JPEG 2000 stereoscopic pictures");
 
       if ( KM_SUCCESS(result) )
 	{
@@ -618,17 +681,17 @@ show_file_info(CommandOptions& Options, const Kumu::IFileReaderFactory& fileRead
   else if ( EssenceType == ESS_TIMED_TEXT )
     {
       FileInfoWrapper<ASDCP::TimedText::MXFReader, MyTextDescriptor>wrapper(fileReaderFactory);
-      result = wrapper.file_info(Options, "Timed Text");
+      result = wrapper.file_info(Options, Probe, "Timed Text");
     }
   else if ( EssenceType == ESS_DCDATA_UNKNOWN )
     {
       FileInfoWrapper<ASDCP::DCData::MXFReader, MyDCDataDescriptor> wrapper(fileReaderFactory);
-      result = wrapper.file_info(Options, "D-Cinema Generic Data");
+      result = wrapper.file_info(Options, Probe, "D-Cinema Generic Data");
     }
   else if ( EssenceType == ESS_DCDATA_DOLBY_ATMOS )
     {
       FileInfoWrapper<ASDCP::ATMOS::MXFReader, MyAtmosDescriptor> wrapper(fileReaderFactory);
-      result = wrapper.file_info(Options, "Dolby ATMOS");
+      result = wrapper.file_info(Options, Probe, "Dolby ATMOS");
     }
   else if ( EssenceType == ESS_AS02_PCM_24b_48k
 	    || EssenceType == ESS_AS02_PCM_24b_96k
@@ -673,6 +736,81 @@ show_file_info(CommandOptions& Options, const Kumu::IFileReaderFactory& fileRead
   return result;
 }
 
+// Fill a JSON record describing one ASDCP file
+//
+Result_t
+json_file_info(const std::string& filename, CommandOptions& Options,
+	       const Kumu::IFileReaderFactory& fileReaderFactory, JSONObject& record)
+{
+  EssenceType_t EssenceType;
+  EssenceProbe Probe;
+  record.add_string("file", filename);
+  Result_t result = ASDCP::EssenceType(filename, EssenceType, fileReaderFactory, Probe);
+
+  if ( ASDCP_FAILURE(result) )
+    return result;
+
+  if ( EssenceType == ESS_MPEG2_VES )
+    {
+      FileInfoWrapper<ASDCP::MPEG2::MXFReader, MyVideoDescriptor> wrapper(fileReaderFactory);
+      result = wrapper.json_info(Probe, "MPEG2 video", record);
+    }
+  else if ( EssenceType == ESS_PCM_24b_48k || EssenceType == ESS_PCM_24b_96k )
+    {
+      FileInfoWrapper<ASDCP::PCM::MXFReader, MyAudioDescriptor> wrapper(fileReaderFactory);
+      result = wrapper.json_info(Probe, "PCM audio", record);
+    }
+  else if ( EssenceType == ESS_JPEG_2000 && ! Options.stereo_image_flag )
+    {
+      FileInfoWrapper<ASDCP::JP2K::MXFReader, MyPictureDescriptor> wrapper(fileReaderFactory);
+      result = wrapper.json_info(Probe, "JPEG 2000 pictures", record);
+    }
+  else if ( EssenceType == ESS_JPEG_2000 || EssenceType == ESS_JPEG_2000_S )
+    {
+      FileInfoWrapper<ASDCP::JP2K::MXFSReader, MyStereoPictureDescriptor> wrapper(fileReaderFactory);
+      result = wrapper.json_info(Probe, "JPEG 2000 stereoscopic pictures", record);
+    }
+  else if ( EssenceType == ESS_TIMED_TEXT )
+    {
+      FileInfoWrapper<ASDCP::TimedText::MXFReader, MyTextDescriptor> wrapper(fileReaderFactory);
+      result = wrapper.json_info(Probe, "Timed Text", record);
+    }
+  else if ( EssenceType == ESS_DCDATA_UNKNOWN )
+    {
+      FileInfoWrapper<ASDCP::DCData::MXFReader, MyDCDataDescriptor> wrapper(fileReaderFactory);
+      result = wrapper.json_info(Probe, "D-Cinema Generic Data", record);
+    }
+  else if ( EssenceType == ESS_DCDATA_DOLBY_ATMOS )
+    {
+      FileInfoWrapper<ASDCP::ATMOS::MXFReader, MyAtmosDescriptor> wrapper(fileReaderFactory);
+      result = wrapper.json_info(Probe, "Dolby ATMOS", record);
+    }
+  else
+    {
+      result = RESULT_FORMAT; // not AS-DCP; AS-02 files are described by as-02-info
+    }
+
+  return result;
+}
+
+// Describes one file for WriteJSONRecords()
+class JSONFileInfo : public IJSONRecordSource
+{
+  CommandOptions& m_Options;
+  const Kumu::IFileReaderFactory& m_FileReaderFactory;
+
+  KM_NO_COPY_CONSTRUCT(JSONFileInfo);
+
+public:
+  JSONFileInfo(CommandOptions& Options, const Kumu::IFileReaderFactory& fileReaderFactory) :
+    m_Options(Options), m_FileReaderFactory(fileReaderFactory) {}
+
+  Result_t FillRecord(const std::string& filename, JSONObject& record) const
+  {
+    return json_file_info(filename, m_Options, m_FileReaderFactory, record);
+  }
+};
+
 //
 int
 main(int argc, const char** argv)
@@ -697,6 +835,14 @@ main(int argc, const char** argv)
     }
 
   Kumu::FileReaderFactory defaultFactory;
+
+  if ( Options.json_flag )
+    {
+      JSONFileInfo json_info(Options, defaultFactory);
+      result = WriteJSONRecords(Options.filenames, Options.worker_count, json_info);
+      Options.filenames.clear();
+    }
+
   while ( ! Options.filenames.empty() && ASDCP_SUCCESS(result) )
     {
       result = show_file_info(Options, defaultFactory);
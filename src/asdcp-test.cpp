@@ -1474,6 +1474,9 @@ read_PCM_file(CommandOptions& Options, const Kumu::IFileReaderFactory& fileReade
 	}
     }
 
+  if ( ASDCP_SUCCESS(result) )
+    result = OutWave.Close();
+
   return result;
 }
 
@@ -767,6 +767,9 @@ read_PCM_file(CommandOptions& Options, const Kumu::IFileReaderFactory& fileReade
     }
     }
 
+  if ( ASDCP_SUCCESS(result) && ! Options.no_write_flag )
+    result = OutWave.Close();
+
   return result;
 }
 
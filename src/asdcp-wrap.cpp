@@ -57,6 +57,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 using namespace ASDCP;
 
 const ui32_t FRAME_BUFFER_SIZE = 4 * Kumu::Megabyte;
+const ui32_t DATA_FRAME_BATCH_SIZE = 16; // Atmos and aux data frames given to the writer at once
 
 const byte_t P_HFR_UL_2K[16] = {
   0x06, 0x0e, 0x2b, 0x34, 0x04, 0x01, 0x01, 0x0d,
@@ -142,9 +143,9 @@ usage(FILE* stream = stdout)
 USAGE: %s [-h|-help] [-V]\n\
 \n\
        %s [-3] [-a <uuid>] [-b <buffer-size>] [-C <UL>] [-d <duration>]\n\
-          [-e|-E] [-f <start-frame>] [-j <key-id-string>] [-k <key-string>]\n\
-          [-l <label>] [-L] [-M] [-m <expr>] [-p <frame-rate>] [-Q] [-s] [-v]\n\
-          [-W] [-z|-Z] <input-file>+ <output-file>\n\n",
+          [-e|-E] [-f <start-frame>] [-I] [-j <key-id-string>] [-k <key-string>]\n\
+          [-l <label>] [-L] [-M] [-m <expr>] [-p <frame-rate>] [-Q] [-s]\n\
+          [-S <conv>] [-v] [-W] [-z|-Z] <input-file>+ <output-file>\n\n",
 	  PROGRAM_NAME, PROGRAM_NAME);
 
   fprintf(stream, "\
@@ -166,6 +167,7 @@ Options:\n\
   -g <rfc-5646-code>\n\
                     - Create MCA labels having the given RFC 5646 language code\n\
                       (requires option \"-m\")\n\
+  -I                - Map PCM input files into memory instead of reading them\n\
   -j <key-id-str>   - Write key ID instead of creating a random value\n\
   -k <key-string>   - Use key for ciphertext operations\n\
   -l <label>        - Use given channel format label when writing MXF sound\n\
@@ -187,6 +189,8 @@ Options:\n\
                       wrapping PCM. This implies a -L option(SMPTE ULs) and \n\
                       will overide -C and -l options with Configuration 4 \n\
                       Channel Assigment and no format label respectively. \n\
+  -S <conv>         - Convert 16-bit, 32-bit integer and 32-bit float PCM\n\
+                      input to 24-bit. <conv> is 'round' or 'dither' (TPDF)\n\
   -T <UL>           - Set TransferCharacteristic UL value in a JP2K file\n\
   -v                - Verbose, prints informative messages to stderr\n\
   -w                - When writing 377-4 MCA labels, use the WTF Channel\n\
@@ -256,6 +260,8 @@ public:
   byte_t key_id_value[UUIDlen];// value of given key ID (when key_id_flag is true)
   byte_t asset_id_value[UUIDlen];// value of asset ID (when asset_id_flag is true)
   PCM::ChannelFormat_t channel_fmt; // audio channel arrangement
+  PCM::SampleConversion_t sample_conversion; // conversion applied to PCM input samples
+  bool   map_pcm_flag;   // if true, PCM input files are memory-mapped
   std::string out_file; //
   bool show_ul_values_flag;    /// if true, dump the UL table before going to work.
   Kumu::PathList_t filenames;  // list of filenames to be processed
@@ -326,7 +332,7 @@ public:
     write_partial_pcm_flag(false), start_frame(0),
     duration(0xffffffff), use_smpte_labels(false), j2c_pedantic(true),
     fb_size(FRAME_BUFFER_SIZE),
-    channel_fmt(PCM::CF_NONE),
+    channel_fmt(PCM::CF_NONE), sample_conversion(PCM::SC_NONE), map_pcm_flag(false),
     ffoa(0), max_channel_count(10), max_object_count(118), // hard-coded sample atmos properties
     dolby_atmos_sync_flag(false),
     show_ul_values_flag(false),
@@ -416,6 +422,8 @@ public:
 
 	      case 'h': help_flag = true; break;
 
+	      case 'I': map_pcm_flag = true; break;
+
 	      case 'j': key_id_flag = true;
 		TEST_EXTRA_ARG(i, 'j');
 		{
@@ -475,6 +483,23 @@ public:
 
 	      case 's': dolby_atmos_sync_flag = true; break;
 
+	      case 'S':
+		TEST_EXTRA_ARG(i, 'S');
+		if ( strcmp(argv[i], "round") == 0 )
+		  {
+		    sample_conversion = PCM::SC_24BIT;
+		  }
+		else if ( strcmp(argv[i], "dither") == 0 )
+		  {
+		    sample_conversion = PCM::SC_24BIT_DITHER;
+		  }
+		else
+		  {
+		    fprintf(stderr, "Unrecognized sample conversion: %s, expecting 'round' or 'dither'\n", argv[i]);
+		    return;
+		  }
+		break;
+
 	      case 'T':
 		TEST_EXTRA_ARG(i, 'T');
 		if ( ! transfer_characteristic.DecodeHex(argv[i]) )
@@ -1028,7 +1053,8 @@ write_PCM_file(CommandOptions& Options)
   byte_t            IV_buf[CBC_BLOCK_SIZE];
 
   // set up essence parser
-  Result_t result = Parser.OpenRead(Options.filenames, PictureRate);
+  Result_t result = Parser.OpenRead(Options.filenames, PictureRate, Options.sample_conversion,
+				    Options.map_pcm_flag);
 
   // set up MXF writer
   if ( ASDCP_SUCCESS(result) )
@@ -1166,7 +1192,7 @@ write_PCM_file(CommandOptions& Options)
 
       while ( ASDCP_SUCCESS(result) && duration++ < Options.duration )
 	{
-	  result = Parser.ReadFrame(FrameBuffer);
+	  result = Parser.ReadFrameView(FrameBuffer);
 
 	  if ( ASDCP_SUCCESS(result) )
 	    {
@@ -1483,7 +1509,7 @@ write_dolby_atmos_file(CommandOptions& Options)
   AESEncContext*          Context = 0;
   HMACContext*            HMAC = 0;
   ATMOS::MXFWriter         Writer;
-  DCData::FrameBuffer       FrameBuffer(Options.fb_size);
+  DCData::FrameBuffer       FrameBatch[DATA_FRAME_BATCH_SIZE];
   ATMOS::AtmosDescriptor ADesc;
   DCData::SequenceParser    Parser;
   byte_t                  IV_buf[CBC_BLOCK_SIZE];
@@ -1560,10 +1586,15 @@ write_dolby_atmos_file(CommandOptions& Options)
   if ( ASDCP_SUCCESS(result) )
   {
     ui32_t duration = 0;
+    ui32_t batch_count = 0; // frames read into FrameBatch and not yet written
     result = Parser.Reset();
 
+    for ( ui32_t i = 0; i < DATA_FRAME_BATCH_SIZE && ASDCP_SUCCESS(result); ++i )
+      result = FrameBatch[i].Capacity(Options.fb_size);
+
     while ( ASDCP_SUCCESS(result) && duration++ < Options.duration )
 	{
+      DCData::FrameBuffer& FrameBuffer = FrameBatch[batch_count];
       result = Parser.ReadFrame(FrameBuffer);
 
       if ( ASDCP_SUCCESS(result) )
@@ -1573,23 +1604,31 @@ write_dolby_atmos_file(CommandOptions& Options)
 
         if ( Options.encrypt_header_flag )
           FrameBuffer.PlaintextOffset(0);
+
+        ++batch_count;
       }
 
-      if ( ASDCP_SUCCESS(result) && ! Options.no_write_flag )
+      if ( ASDCP_SUCCESS(result) && batch_count == DATA_FRAME_BATCH_SIZE )
       {
-        result = Writer.WriteFrame(FrameBuffer, Context, HMAC);
+        if ( ! Options.no_write_flag )
+          result = Writer.WriteFrames(FrameBatch, batch_count, Context, HMAC);
 
         // The Writer class will forward the last block of ciphertext
         // to the encryption context for use as the IV for the next
-        // frame. If you want to use non-sequitur IV values, un-comment
-        // the following  line of code.
+        // frame. If you want to use non-sequitur IV values, write the
+        // frames one at a time and un-comment the following line of code.
         // if ( ASDCP_SUCCESS(result) && Options.key_flag )
         //   Context->SetIVec(RNG.FillRandom(IV_buf, CBC_BLOCK_SIZE));
+
+        batch_count = 0;
       }
 	}
 
     if ( result == RESULT_ENDOFFILE )
       result = RESULT_OK;
+
+    if ( ASDCP_SUCCESS(result) && batch_count > 0 && ! Options.no_write_flag )
+      result = Writer.WriteFrames(FrameBatch, batch_count, Context, HMAC);
   }
 
   if ( ASDCP_SUCCESS(result) && ! Options.no_write_flag )
@@ -1607,7 +1646,7 @@ write_aux_data_file(CommandOptions& Options)
   AESEncContext*          Context = 0;
   HMACContext*            HMAC = 0;
   DCData::MXFWriter       Writer;
-  DCData::FrameBuffer     FrameBuffer(Options.fb_size);
+  DCData::FrameBuffer     FrameBatch[DATA_FRAME_BATCH_SIZE];
   DCData::DCDataDescriptor DDesc;
   DCData::SequenceParser  Parser;
   byte_t                  IV_buf[CBC_BLOCK_SIZE];
@@ -1679,10 +1718,15 @@ write_aux_data_file(CommandOptions& Options)
   if ( ASDCP_SUCCESS(result) )
   {
     ui32_t duration = 0;
+    ui32_t batch_count = 0; // frames read into FrameBatch and not yet written
     result = Parser.Reset();
 
+    for ( ui32_t i = 0; i < DATA_FRAME_BATCH_SIZE && ASDCP_SUCCESS(result); ++i )
+      result = FrameBatch[i].Capacity(Options.fb_size);
+
     while ( ASDCP_SUCCESS(result) && duration++ < Options.duration )
 	{
+      DCData::FrameBuffer& FrameBuffer = FrameBatch[batch_count];
       result = Parser.ReadFrame(FrameBuffer);
 
       if ( ASDCP_SUCCESS(result) )
@@ -1692,23 +1736,31 @@ write_aux_data_file(CommandOptions& Options)
 
         if ( Options.encrypt_header_flag )
           FrameBuffer.PlaintextOffset(0);
+
+        ++batch_count;
       }
 
-      if ( ASDCP_SUCCESS(result) && ! Options.no_write_flag )
+      if ( ASDCP_SUCCESS(result) && batch_count == DATA_FRAME_BATCH_SIZE )
       {
-        result = Writer.WriteFrame(FrameBuffer, Context, HMAC);
+        if ( ! Options.no_write_flag )
+          result = Writer.WriteFrames(FrameBatch, batch_count, Context, HMAC);
 
         // The Writer class will forward the last block of ciphertext
         // to the encryption context for use as the IV for the next
-        // frame. If you want to use non-sequitur IV values, un-comment
-        // the following  line of code.
+        // frame. If you want to use non-sequitur IV values, write the
+        // frames one at a time and un-comment the following line of code.
         // if ( ASDCP_SUCCESS(result) && Options.key_flag )
         //   Context->SetIVec(RNG.FillRandom(IV_buf, CBC_BLOCK_SIZE));
+
+        batch_count = 0;
       }
 	}
 
     if ( result == RESULT_ENDOFFILE )
       result = RESULT_OK;
+
+    if ( ASDCP_SUCCESS(result) && batch_count > 0 && ! Options.no_write_flag )
+      result = Writer.WriteFrames(FrameBatch, batch_count, Context, HMAC);
   }
 
   if ( ASDCP_SUCCESS(result) && ! Options.no_write_flag )
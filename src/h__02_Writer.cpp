@@ -37,6 +37,7 @@ using namespace ASDCP;
 using namespace ASDCP::MXF;
 
 static const ui32_t CBRIndexEntriesPerSegment = 5000;
+static const ui32_t PartitionRegionSize = 16 * Kumu::Megabyte; // largest unit handed to a partition writer
 
 
 //------------------------------------------------------------------------------------------
@@ -84,7 +85,7 @@ AS_02::MXF::AS02IndexWriterVBR::WriteToFile(Kumu::FileWriter& Writer)
       *pl_i = 0;
     }
 
-  m_PacketList->m_List.clear();
+  m_PacketList->Clear();
 
   if ( KM_SUCCESS(result) )
     {
@@ -191,6 +192,19 @@ AS_02::h__AS02WriterFrame::h__AS02WriterFrame(const ASDCP::Dictionary *d) :
 
 AS_02::h__AS02WriterFrame::~h__AS02WriterFrame() {}
 
+//
+Result_t
+AS_02::h__AS02WriterFrame::SetPartitionWriters(ui32_t writer_count)
+{
+  if ( ! m_File.IsOpen() )
+    return RESULT_INIT;
+
+  if ( writer_count == 0 )
+    return m_File.StopWriteBehind();
+
+  return m_File.StartWriteBehind(writer_count, PartitionRegionSize);
+}
+
 //
 Result_t
 AS_02::h__AS02WriterFrame::WriteEKLVPacket(const ASDCP::FrameBuffer& FrameBuf,const byte_t* EssenceUL,
@@ -202,16 +216,40 @@ AS_02::h__AS02WriterFrame::WriteEKLVPacket(const ASDCP::FrameBuffer& FrameBuf,co
   Result_t result = Write_EKLV_Packet(m_File, *m_Dict, m_HeaderPart, m_Info, m_CtFrameBuf, m_FramesWritten,
 				      m_StreamOffset, FrameBuf, EssenceUL, MinEssenceElementBerLength, Ctx, HMAC);
 
+  return IndexFrame(this_stream_offset, result);
+}
+
+//
+Result_t
+AS_02::h__AS02WriterFrame::WriteKLVPacketFromFile(const Kumu::IFileReader& Reader, ui64_t length, const byte_t* EssenceUL,
+						  const ui32_t& MinEssenceElementBerLength)
+{
+  ui64_t this_stream_offset = m_StreamOffset; // m_StreamOffset will be changed by the call to Write_KLV_PacketFromFile
+
+  Result_t result = Write_KLV_PacketFromFile(m_File, m_StreamOffset, Reader, length, EssenceUL, MinEssenceElementBerLength);
+
+  return IndexFrame(this_stream_offset, result);
+}
+
+//
+Result_t
+AS_02::h__AS02WriterFrame::IndexFrame(ui64_t stream_offset, Result_t result)
+{
   if ( KM_SUCCESS(result) )
     {  
       IndexTableSegment::IndexEntry Entry;
-      Entry.StreamOffset = this_stream_offset;
+      Entry.StreamOffset = stream_offset;
       m_IndexWriter.PushIndexEntry(Entry);
     }
 
   if ( m_FramesWritten > 1 && ( ( m_FramesWritten + 1 ) % m_PartitionSpace ) == 0 )
     {
       assert(m_IndexWriter.GetDuration() > 0);
+
+      // the completed partition's essence is written while the next one is filled
+      if ( KM_SUCCESS(result) )
+	result = m_File.EndRegion();
+
       FlushIndexPartition();
 
       UL body_ul(m_Dict->ul(MDD_ClosedCompleteBodyPartition));
@@ -232,6 +270,71 @@ AS_02::h__AS02WriterFrame::WriteEKLVPacket(const ASDCP::FrameBuffer& FrameBuf,co
 }
 
 
+//------------------------------------------------------------------------------------------
+//
+
+//
+Result_t
+AS_02::ClipStagingBuffer::Size(Kumu::FileWriter& Writer, ui32_t size)
+{
+  Result_t result = Flush(Writer);
+
+  if ( KM_SUCCESS(result) && size > 0 )
+    result = m_Buffer.Capacity(size);
+
+  if ( KM_SUCCESS(result) )
+    m_Size = size;
+
+  return result;
+}
+
+//
+Result_t
+AS_02::ClipStagingBuffer::Write(Kumu::FileWriter& Writer, const byte_t* buf, ui32_t buf_len)
+{
+  if ( m_Size == 0 )
+    return Writer.Write(buf, buf_len);
+
+  // the first write after a flush is shortened so that later writes are aligned
+  if ( m_Limit == 0 )
+    m_Limit = m_Size - (ui32_t)( Writer.TellPosition() % m_Size );
+
+  Result_t result = RESULT_OK;
+
+  while ( buf_len > 0 && KM_SUCCESS(result) )
+    {
+      ui32_t copy_len = Kumu::xmin(buf_len, m_Limit - m_Buffer.Length());
+      memcpy(m_Buffer.Data() + m_Buffer.Length(), buf, copy_len);
+      m_Buffer.Length(m_Buffer.Length() + copy_len);
+      buf += copy_len;
+      buf_len -= copy_len;
+
+      if ( m_Buffer.Length() == m_Limit )
+	{
+	  result = Writer.Write(m_Buffer.RoData(), m_Buffer.Length());
+	  m_Buffer.Length(0);
+	  m_Limit = m_Size;
+	}
+    }
+
+  return result;
+}
+
+//
+Result_t
+AS_02::ClipStagingBuffer::Flush(Kumu::FileWriter& Writer)
+{
+  Result_t result = RESULT_OK;
+
+  if ( m_Buffer.Length() > 0 )
+    result = Writer.Write(m_Buffer.RoData(), m_Buffer.Length());
+
+  m_Buffer.Length(0);
+  m_Limit = 0;
+  return result;
+}
+
+
 //------------------------------------------------------------------------------------------
 //
 
@@ -272,7 +375,7 @@ AS_02::MXF::AS02IndexWriterCBR::WriteToFile(Kumu::FileWriter& Writer)
   index_body_buffer.Size(index_body_buffer.Size() + WriteWrapper.Size());
   delete m_CurrentSegment;
   m_CurrentSegment = 0;
-  m_PacketList->m_List.clear();
+  m_PacketList->Clear();
 
   if ( KM_SUCCESS(result) )
     {
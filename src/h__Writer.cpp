@@ -327,6 +327,53 @@ ASDCP::h__ASDCPWriter::WriteEKLVPacket(const ASDCP::FrameBuffer& FrameBuf,const
 			   Ctx, HMAC);
 }
 
+//
+Result_t
+ASDCP::h__ASDCPWriter::WriteIndexedEKLVPackets(const ASDCP::FrameBuffer* const* FrameBufs, ui32_t FrameCount,
+					       const byte_t* EssenceUL, const ui32_t& MinEssenceElementBerLength,
+					       AESEncContext* Ctx, HMACContext* HMAC)
+{
+  ASDCP_TEST_NULL(FrameBufs);
+  Result_t result = RESULT_OK;
+  IndexTableSegment::IndexEntry Entry;
+
+  if ( m_Info.EncryptedEssence )
+    {
+      // each packet is encrypted in turn through m_CtFrameBuf
+      for ( ui32_t i = 0; i < FrameCount && ASDCP_SUCCESS(result); ++i )
+	{
+	  Entry.StreamOffset = m_StreamOffset;
+	  result = WriteEKLVPacket(*FrameBufs[i], EssenceUL, MinEssenceElementBerLength, Ctx, HMAC);
+
+	  if ( ASDCP_SUCCESS(result) )
+	    {
+	      m_FooterPart.PushIndexEntry(Entry);
+	      m_FramesWritten++;
+	    }
+	}
+
+      return result;
+    }
+
+  ui64_t packet_offsets[KLVPacketBatchSize];
+
+  for ( ui32_t i = 0; i < FrameCount && ASDCP_SUCCESS(result); i += KLVPacketBatchSize )
+    {
+      ui32_t batch_count = Kumu::xmin(FrameCount - i, KLVPacketBatchSize);
+      result = Write_KLV_Packets(m_File, m_StreamOffset, FrameBufs + i, batch_count,
+				 EssenceUL, MinEssenceElementBerLength, packet_offsets);
+
+      for ( ui32_t j = 0; j < batch_count && ASDCP_SUCCESS(result); ++j )
+	{
+	  Entry.StreamOffset = packet_offsets[j];
+	  m_FooterPart.PushIndexEntry(Entry);
+	  m_FramesWritten++;
+	}
+    }
+
+  return result;
+}
+
 // standard method of writing the header and footer of a completed MXF file
 //
 Result_t
@@ -532,6 +579,114 @@ ASDCP::Write_EKLV_Packet(Kumu::FileWriter& File, const ASDCP::Dictionary& Dict,
   return result;
 }
 
+// Like the plaintext case of Write_EKLV_Packet(), but the value is copied from the
+// reader in bounded pieces rather than held in a frame buffer.
+Result_t
+ASDCP::Write_KLV_PacketFromFile(Kumu::FileWriter& File, ui64_t& StreamOffset, const Kumu::IFileReader& Reader,
+				ui64_t length, const byte_t* EssenceUL, const ui32_t& MinEssenceElementBerLength)
+{
+  if ( length == 0 )
+    {
+      DefaultLogSink().Error("Cannot write empty essence file\n");
+      return RESULT_EMPTY_FB;
+    }
+
+  byte_t overhead[128];
+  Kumu::MemIOWriter Overhead(overhead, 128);
+  ui32_t essence_element_BER_length = MinEssenceElementBerLength;
+
+  if ( length > 0x00ffffff ) // Need BER integer longer than MXF_BER_LENGTH bytes
+    {
+      essence_element_BER_length = Kumu::get_BER_length_for_value(length);
+
+      if ( essence_element_BER_length == 0 )
+	return RESULT_KLV_CODING;
+    }
+
+  Overhead.WriteRaw((byte_t*)EssenceUL, SMPTE_UL_LENGTH);
+  Overhead.WriteBER(length, essence_element_BER_length);
+  Result_t result = File.Write(Overhead.Data(), Overhead.Length());
+
+  if ( ASDCP_SUCCESS(result) )
+    result = File.WriteFromFile(Reader, length);
+
+  if ( ASDCP_SUCCESS(result) )
+    StreamOffset += Overhead.Length() + length;
+
+  return result;
+}
+
+// Like the plaintext case of Write_EKLV_Packet(), but the packets of several frames
+// are queued on the iovec and written together. Nothing is written unless every
+// frame can be encoded.
+Result_t
+ASDCP::Write_KLV_Packets(Kumu::FileWriter& File, ui64_t& StreamOffset, const ASDCP::FrameBuffer* const* FrameBufs,
+			 ui32_t FrameCount, const byte_t* EssenceUL, const ui32_t& MinEssenceElementBerLength,
+			 ui64_t* PacketOffsets)
+{
+  ASDCP_TEST_NULL(FrameBufs);
+  ASDCP_TEST_NULL(PacketOffsets);
+
+  if ( FrameCount > KLVPacketBatchSize )
+    return RESULT_PARAM;
+
+  byte_t overhead[KLVPacketBatchSize * (SMPTE_UL_LENGTH + MXF_BER_LENGTH + 8)]; // largest BER is 9 bytes
+  Kumu::MemIOWriter Overhead(overhead, sizeof(overhead));
+  ui32_t packet_overhead[KLVPacketBatchSize];
+
+  for ( ui32_t i = 0; i < FrameCount; ++i )
+    {
+      const ASDCP::FrameBuffer& FrameBuf = *FrameBufs[i];
+      ui32_t essence_element_BER_length = MinEssenceElementBerLength;
+
+      if ( FrameBuf.Size() == 0 )
+	{
+	  DefaultLogSink().Error("Cannot write empty frame buffer\n");
+	  return RESULT_EMPTY_FB;
+	}
+
+      if ( FrameBuf.Size() > 0x00ffffff ) // Need BER integer longer than MXF_BER_LENGTH bytes
+	{
+	  essence_element_BER_length = Kumu::get_BER_length_for_value(FrameBuf.Size());
+
+	  if ( essence_element_BER_length == 0 )
+	    return RESULT_KLV_CODING;
+	}
+
+      ui32_t start = Overhead.Length();
+
+      if ( ! ( Overhead.WriteRaw((byte_t*)EssenceUL, SMPTE_UL_LENGTH)
+	       && Overhead.WriteBER(FrameBuf.Size(), essence_element_BER_length) ) )
+	return RESULT_KLV_CODING;
+
+      packet_overhead[i] = Overhead.Length() - start;
+    }
+
+  Result_t result = RESULT_OK;
+  const byte_t* p = Overhead.RoData();
+  ui64_t offset = StreamOffset;
+
+  for ( ui32_t i = 0; i < FrameCount && ASDCP_SUCCESS(result); ++i )
+    {
+      result = File.Writev(p, packet_overhead[i]);
+
+      if ( ASDCP_SUCCESS(result) )
+	result = File.Writev((byte_t*)FrameBufs[i]->RoData(), FrameBufs[i]->Size());
+
+      PacketOffsets[i] = offset;
+      offset += packet_overhead[i] + FrameBufs[i]->Size();
+      p += packet_overhead[i];
+    }
+
+  if ( ASDCP_SUCCESS(result) )
+    result = File.Writev();
+
+  if ( ASDCP_SUCCESS(result) )
+    StreamOffset = offset;
+
+  return result;
+}
+
 //
 // end h__Writer.cpp
 //
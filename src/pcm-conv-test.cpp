@@ -0,0 +1,150 @@
+/*
+Copyright (c) 2004-2009, John Hurst
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+3. The name of the author may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/*! \file    pcm-conv-test.cpp
+  \version $Id$
+  \brief   test harness for the float to 24-bit PCM sample conversion
+*/
+
+#include <AS_DCP_internal.h>
+#include <KM_prng.h>
+#include <math.h>
+#include <assert.h>
+
+using namespace ASDCP;
+
+// an odd count, so the vector kernel leaves a scalar tail
+const ui32_t sample_count = 4099;
+const float lsb = 1.0f / 8388608.0f;
+
+//
+static void
+put_float(float f, byte_t* p)
+{
+  ui32_t u;
+  memcpy(&u, &f, sizeof(u));
+  Kumu::i2p<ui32_t>(KM_i32_LE(u), p);
+}
+
+//
+static i32_t
+get_24(const byte_t* p)
+{
+  i32_t v = p[0] | ( p[1] << 8 ) | ( p[2] << 16 );
+  return ( v & 0x00800000 ) ? v - 0x01000000 : v;
+}
+
+// Converts src with both kernels, starting from the same dither state, and
+// reports the first sample that differs.
+static bool
+compare_kernels(const byte_t* src, bool dither)
+{
+  byte_t vector_buf[sample_count * 3];
+  byte_t scalar_buf[sample_count * 3];
+  ui32_t vector_state = 0x2545f491, scalar_state = 0x2545f491;
+
+  PCM_Float_to_24(src, sample_count, vector_buf, dither ? &vector_state : 0);
+  PCM_Float_to_24_Scalar(src, sample_count, scalar_buf, dither ? &scalar_state : 0);
+
+  for ( ui32_t i = 0; i < sample_count; i++ )
+    {
+      if ( memcmp(vector_buf + i * 3, scalar_buf + i * 3, 3) != 0 )
+	{
+	  fprintf(stderr, "Sample %u differs%s: vector %d, scalar %d\n", i, dither ? " (dither)" : "",
+		  get_24(vector_buf + i * 3), get_24(scalar_buf + i * 3));
+	  return false;
+	}
+    }
+
+  return vector_state == scalar_state;
+}
+
+//
+int
+main(int argc, const char** argv)
+{
+  // values that exercise rounding ties, clipping and non-finite input
+  const float edge_values[] = {
+    0.0f, -0.0f, 0.5f * lsb, -0.5f * lsb, 1.5f * lsb, -1.5f * lsb, 2.5f * lsb, -2.5f * lsb,
+    0.49999997f * lsb, 1.0f - 2.0f * lsb, 1.0f - 1.5f * lsb, 1.0f - 0.5f * lsb, 1.0f, -1.0f, -1.0f - lsb, 2.0f, -2.0f,
+    HUGE_VALF, -HUGE_VALF, sqrtf(-1.0f), 1.0e-40f, -1.0e-40f
+  };
+  const ui32_t edge_count = sizeof(edge_values) / sizeof(edge_values[0]);
+
+  const i32_t edge_expected[] = {
+    0, 0, 0, 0, 2, -2, 2, -2,
+    0, 0x007ffffe, 0x007ffffe, 0x007fffff, 0x007fffff, -0x00800000, -0x00800000, 0x007fffff, -0x00800000,
+    0x007fffff, -0x00800000, 0, 0, 0
+  };
+  assert(sizeof(edge_expected) / sizeof(edge_expected[0]) == edge_count);
+
+  byte_t src_buf[sample_count * 4];
+  byte_t dst_buf[sample_count * 3];
+  Kumu::FortunaRNG RNG;
+  RNG.FillRandom(src_buf, sizeof(src_buf));
+
+  for ( ui32_t i = 0; i < sample_count; i++ )
+    {
+      ui32_t r = Kumu::cp2i<ui32_t>(src_buf + i * 4);
+
+      if ( r & 1 )
+	// exact half-LSB values
+	put_float(( (float)(i32_t)( r >> 8 ) - 8388608.0f + 0.5f ) * lsb, src_buf + i * 4);
+      else
+	put_float(( (float)( r >> 1 ) / 2147483648.0f ) * 2.2f - 1.1f, src_buf + i * 4);
+    }
+
+  // the edge values go at the start of the buffer and again at the end
+  for ( ui32_t i = 0; i < edge_count; i++ )
+    {
+      put_float(edge_values[i], src_buf + i * 4);
+      put_float(edge_values[i], src_buf + ( sample_count - edge_count + i ) * 4);
+    }
+
+  PCM_Float_to_24_Scalar(src_buf, sample_count, dst_buf, 0);
+
+  for ( ui32_t i = 0; i < edge_count; i++ )
+    {
+      ui32_t tail_i = sample_count - edge_count + i;
+
+      if ( get_24(dst_buf + i * 3) != edge_expected[i] || get_24(dst_buf + tail_i * 3) != edge_expected[i] )
+	{
+	  fprintf(stderr, "Edge value %u: expecting %d, got %d and %d\n", i, edge_expected[i],
+		  get_24(dst_buf + i * 3), get_24(dst_buf + tail_i * 3));
+	  return 1;
+	}
+    }
+
+  if ( ! compare_kernels(src_buf, false) || ! compare_kernels(src_buf, true) )
+    return 1;
+
+  fputs("OK\n", stderr);
+  return 0;
+}
+
+//
+// end pcm-conv-test.cpp
+//
@@ -39,6 +39,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 using namespace ASDCP;
 
 const ui32_t FRAME_BUFFER_SIZE = 4 * Kumu::Megabyte;
+const ui32_t READ_AHEAD_FRAMES = 4; // frames read ahead of the writer
 const ASDCP::Dictionary *g_dict = 0;
 
 
@@ -149,6 +150,8 @@ Options:\n\
   -T <max>          - Set RGB component maximum code value (default: 1023)\n\
   -u                - Print UL catalog to stderr\n\
   -v                - Verbose, prints informative messages to stderr\n\
+  -w <n>            - Write frame-wrapped body partitions using <n> background\n\
+                      threads (default 0, write inline)\n\
   -W                - Read input file only, do not write source file\n\
   -x <int>          - Horizontal subsampling degree (default: 2)\n\
   -X <int>          - Vertical subsampling degree (default: 2)\n\
@@ -205,6 +208,7 @@ public:
   //new attributes for AS-02 support 
   AS_02::IndexStrategy_t index_strategy; //Shim parameter index_strategy_frame/clip
   ui32_t partition_space; //Shim parameter partition_spacing
+  ui32_t partition_writers; // background threads writing frame-wrapped partitions
 
   std::string PHDR_master_metadata;
   std::string global_metadata_filename;
@@ -215,7 +219,7 @@ public:
     encrypt_header_flag(true), write_hmac(true), verbose_flag(false), fb_dump_size(0),
     no_write_flag(false), version_flag(false), help_flag(false),
     duration(0xffffffff), j2c_pedantic(true), use_cdci_descriptor(false), edit_rate(24,1), fb_size(FRAME_BUFFER_SIZE),
-    show_ul_values_flag(false), index_strategy(AS_02::IS_FOLLOW), partition_space(60),
+    show_ul_values_flag(false), index_strategy(AS_02::IS_FOLLOW), partition_space(60), partition_writers(0),
     rgba_MaxRef(1023), rgba_MinRef(0),
     horizontal_subsampling(2), vertical_subsampling(2), component_depth(10),
     frame_layout(0), aspect_ratio(ASDCP::Rational(4,3)), field_dominance(0),
@@ -388,6 +392,11 @@ public:
 	      case 'u': show_ul_values_flag = true; break;
 	      case 'V': version_flag = true; break;
 	      case 'v': verbose_flag = true; break;
+	      case 'w':
+		TEST_EXTRA_ARG(i, 'w');
+		partition_writers = Kumu::xabs(strtol(argv[i], 0, 10));
+		break;
+
 	      case 'W': no_write_flag = true; break;
 
 	      case 'x':
@@ -575,6 +584,9 @@ write_JP2K_file(CommandOptions& Options)
 	{
 	  result = Writer.OpenWrite(Options.out_file, Info, essence_descriptor, essence_sub_descriptors,
 				    Options.edit_rate, Options.mxf_header_size, Options.index_strategy, Options.partition_space);
+
+	  if ( ASDCP_SUCCESS(result) && Options.partition_writers > 0 )
+	    result = Writer.SetPartitionWriters(Options.partition_writers);
 	}
     }
 
@@ -583,6 +595,9 @@ write_JP2K_file(CommandOptions& Options)
       ui32_t duration = 0;
       result = Parser.Reset();
 
+      if ( ASDCP_SUCCESS(result) )
+	Parser.SetReadAhead(READ_AHEAD_FRAMES);
+
       while ( ASDCP_SUCCESS(result) && duration++ < Options.duration )
 	{
 	  result = Parser.ReadFrame(FrameBuffer);